@@ -0,0 +1,146 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace binance {
+namespace bench {
+
+// keeps the compiler from optimizing away the value computed by a benchmark
+template <typename T> inline void do_not_optimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static void const *volatile sink{};
+  sink = &value;
+#endif
+}
+
+struct bench_result_t {
+  std::string name{};
+  std::size_t iterations{};
+  double ns_per_op{};
+  double items_per_second{};
+};
+
+class bench_runner_t {
+  std::vector<bench_result_t> results_{};
+  std::chrono::milliseconds min_time_{500};
+  std::string filter_{};
+
+public:
+  explicit bench_runner_t(std::chrono::milliseconds const min_time =
+                              std::chrono::milliseconds(500))
+      : min_time_{min_time} {}
+
+  // only the benchmarks whose name contains `filter` are run from now on
+  void set_filter(std::string filter) { filter_ = std::move(filter); }
+
+  /* runs `func` repeatedly, doubling the iteration count until a batch takes
+   * at least `min_time_`. `items_per_op` is the number of logical items (e.g.
+   * tickers in a frame) a single call to `func` processes. */
+  template <typename Func>
+  void run(std::string name, std::size_t const items_per_op, Func &&func) {
+    using clock_t = std::chrono::steady_clock;
+
+    if (name.find(filter_) == std::string::npos) {
+      return;
+    }
+    func(); // warm up caches and allocator pools
+    std::size_t iterations = 1;
+    while (true) {
+      auto const start = clock_t::now();
+      for (std::size_t i = 0; i != iterations; ++i) {
+        func();
+      }
+      auto const elapsed = clock_t::now() - start;
+      if (elapsed >= min_time_ || iterations >= (std::size_t(1) << 30)) {
+        double const elapsed_ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                .count());
+        bench_result_t result{};
+        result.name = std::move(name);
+        result.iterations = iterations;
+        result.ns_per_op = elapsed_ns / static_cast<double>(iterations);
+        result.items_per_second = (static_cast<double>(items_per_op) *
+                                   static_cast<double>(iterations)) /
+                                  (elapsed_ns / 1e9);
+        return results_.push_back(std::move(result));
+      }
+      iterations *= 2;
+    }
+  }
+
+  std::vector<bench_result_t> const &results() const { return results_; }
+
+  void print_table() const {
+    std::printf("%-48s %14s %16s %18s\n", "benchmark", "iterations",
+                "ns/op", "items/s");
+    for (auto const &result : results_) {
+      std::printf("%-48s %14zu %16.1f %18.1f\n", result.name.c_str(),
+                  result.iterations, result.ns_per_op,
+                  result.items_per_second);
+    }
+  }
+
+  /* writes the results, and what they were measured on, as JSON so that runs
+   * of different releases can be compared by a script. */
+  bool write_json(std::string const &filename) const {
+    std::ofstream file{filename};
+    if (!file) {
+      return false;
+    }
+    char date[32]{};
+    auto const now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    nlohmann::json context{{"date", date},
+                           {"hardware_concurrency",
+                            std::thread::hardware_concurrency()},
+#if defined(__clang__)
+                           {"compiler", "clang " __clang_version__},
+#elif defined(__GNUC__)
+                           {"compiler", "gcc " __VERSION__},
+#elif defined(_MSC_VER)
+                           {"compiler", "msvc " + std::to_string(_MSC_VER)},
+#endif
+#ifdef NDEBUG
+                           {"build_type", "release"}};
+#else
+                           {"build_type", "debug"}};
+#endif
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (auto const &result : results_) {
+      benchmarks.push_back({{"name", result.name},
+                            {"iterations", result.iterations},
+                            {"ns_per_op", result.ns_per_op},
+                            {"items_per_second", result.items_per_second}});
+    }
+    nlohmann::json const root{{"context", std::move(context)},
+                              {"benchmarks", std::move(benchmarks)}};
+    file << root.dump(2) << '\n';
+    return static_cast<bool>(file);
+  }
+};
+
+void register_ticker_decoder_benchmarks(bench_runner_t &,
+                                        std::vector<std::string> const &frames);
+void register_decimal_benchmarks(bench_runner_t &);
+void register_queue_benchmarks(bench_runner_t &);
+void register_crypto_benchmarks(bench_runner_t &);
+void register_user_data_benchmarks(bench_runner_t &);
+void register_task_benchmarks(bench_runner_t &);
+void register_history_benchmarks(bench_runner_t &);
+void register_rolling_stats_benchmarks(bench_runner_t &);
+void register_cross_rates_benchmarks(bench_runner_t &);
+void register_arbitrage_benchmarks(bench_runner_t &);
+
+} // namespace bench
+} // namespace binance
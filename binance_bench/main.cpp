@@ -0,0 +1,97 @@
+#include <fstream>
+#include <random>
+#include <spdlog/spdlog.h>
+
+#include "bench_runner.hpp"
+
+namespace {
+
+// one `!miniTicker@arr` frame per line, e.g. captured with websocat
+std::vector<std::string> read_recorded_frames(std::string const &filename) {
+  std::vector<std::string> frames{};
+  std::ifstream file{filename};
+  std::string line{};
+  while (std::getline(file, line)) {
+    if (!line.empty()) {
+      frames.push_back(std::move(line));
+    }
+  }
+  return frames;
+}
+
+// roughly what a full-market frame looks like: ~2,000 tickers
+std::string synthetic_mini_ticker_frame(std::size_t const ticker_count) {
+  std::mt19937 gen{42};
+  std::uniform_real_distribution<> price_dist(0.00001, 60'000.0);
+
+  std::string frame = "[";
+  char price_buffer[32]{};
+  for (std::size_t i = 0; i != ticker_count; ++i) {
+    auto const price = price_dist(gen);
+    std::snprintf(price_buffer, sizeof(price_buffer), "%.8f", price);
+    if (i != 0) {
+      frame += ',';
+    }
+    frame += R"({"e":"24hrMiniTicker","E":1672515782136,"s":"SYM)";
+    frame += std::to_string(i);
+    frame += R"(USDT","c":")";
+    frame += price_buffer;
+    frame += R"(","o":")";
+    frame += price_buffer;
+    frame += R"(","h":"61000.00000000","l":"0.00000100",)"
+             R"("v":"1234567.89000000","q":"9876543.21000000"})";
+  }
+  frame += ']';
+  return frame;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  spdlog::info("binance_bench: hot path benchmarks for the binance services");
+
+  // binance_bench [--json results.json] [--filter name] [frames.txt]
+  std::string json_filename{};
+  std::string filter{};
+  std::string frames_filename{};
+  for (int i = 1; i < argc; ++i) {
+    std::string const arg = argv[i];
+    if ((arg == "--json" || arg == "--filter") && i + 1 < argc) {
+      (arg == "--json" ? json_filename : filter) = argv[++i];
+    } else {
+      frames_filename = arg;
+    }
+  }
+
+  std::vector<std::string> frames{};
+  if (!frames_filename.empty()) {
+    frames = read_recorded_frames(frames_filename);
+    if (frames.empty()) {
+      spdlog::error("no frames could be read from '{}'", frames_filename);
+      return EXIT_FAILURE;
+    }
+  } else {
+    spdlog::info("no frame file given, using a synthetic miniTicker frame");
+    frames.push_back(synthetic_mini_ticker_frame(2'000));
+  }
+
+  binance::bench::bench_runner_t runner{};
+  runner.set_filter(filter);
+  binance::bench::register_ticker_decoder_benchmarks(runner, frames);
+  binance::bench::register_decimal_benchmarks(runner);
+  binance::bench::register_queue_benchmarks(runner);
+  binance::bench::register_crypto_benchmarks(runner);
+  binance::bench::register_user_data_benchmarks(runner);
+  binance::bench::register_task_benchmarks(runner);
+  binance::bench::register_history_benchmarks(runner);
+  binance::bench::register_rolling_stats_benchmarks(runner);
+  binance::bench::register_cross_rates_benchmarks(runner);
+  binance::bench::register_arbitrage_benchmarks(runner);
+  runner.print_table();
+
+  if (!json_filename.empty() && !runner.write_json(json_filename)) {
+    spdlog::error("unable to write the results to '{}'", json_filename);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
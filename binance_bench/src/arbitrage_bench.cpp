@@ -0,0 +1,66 @@
+#include "arbitrage_detector.hpp"
+#include "bench_runner.hpp"
+
+#include <random>
+
+namespace binance {
+namespace bench {
+
+void register_arbitrage_benchmarks(bench_runner_t &runner) {
+  // ~600 assets, each listed against some of the usual quote assets with
+  // Binance's proportions
+  static symbol_registry_t symbols{};
+  static std::vector<pushed_subscription_data_t> frame{};
+  auto add_tick = [](std::string const &symbol, double const price) {
+    pushed_subscription_data_t tick{};
+    tick.symbol_id = symbols.get_or_insert(symbol);
+    tick.current_price = decimal_t::from_double(price);
+    frame.push_back(tick);
+  };
+  std::vector<std::pair<std::string, double>> const quotes{
+      {"USDT", 1.0},  {"BTC", 65'000.0}, {"ETH", 3'000.0}, {"BNB", 550.0},
+      {"FDUSD", 1.0}, {"TRY", 0.03},     {"EUR", 1.08}};
+  double const listed_ratios[] = {1.0, 0.85, 0.3, 0.25, 0.2, 0.2, 0.1};
+  for (std::size_t i = 1; i != quotes.size(); ++i) {
+    add_tick(quotes[i].first + "USDT", quotes[i].second);
+  }
+  add_tick("ETHBTC", 3'000.0 / 65'000.0);
+  add_tick("BNBBTC", 550.0 / 65'000.0);
+  add_tick("BNBETH", 550.0 / 3'000.0);
+  std::mt19937 gen{42};
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  for (std::size_t i = 0; i != 600; ++i) {
+    auto const asset = "ASSET" + std::to_string(i);
+    auto const price = 1.0 + dist(gen) * 100.0;
+    for (std::size_t q = 0; q != quotes.size(); ++q) {
+      if (dist(gen) < listed_ratios[q]) {
+        add_tick(asset + quotes[q].first, price / quotes[q].second);
+      }
+    }
+  }
+
+  static arbitrage_detector_t detector{symbols};
+  arbitrage_config_t config{};
+  config.anchors = {"USDT"};
+  detector.configure(std::move(config));
+  detector.load_symbols();
+  for (auto const &tick : frame) {
+    detector.on_tick(tick);
+  }
+
+  runner.run("arbitrage/full-market frame (" + std::to_string(frame.size()) +
+                 " symbols, " + std::to_string(detector.cycle_count()) +
+                 " cycles)",
+             frame.size(), [] {
+               static std::int64_t step{1};
+               step = -step;
+               for (auto &tick : frame) {
+                 tick.current_price += decimal_t::from_units(step);
+                 detector.on_tick(tick);
+               }
+               do_not_optimize(detector.published_count());
+             });
+}
+
+} // namespace bench
+} // namespace binance
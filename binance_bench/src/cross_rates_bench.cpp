@@ -0,0 +1,52 @@
+#include "bench_runner.hpp"
+#include "cross_rates.hpp"
+
+namespace binance {
+namespace bench {
+
+void register_cross_rates_benchmarks(bench_runner_t &runner) {
+  // ~700 assets listed against USDT and BTC, a third of them against EUR
+  // too, as on Binance
+  static symbol_registry_t symbols{};
+  static cross_rates_t cross_rates{symbols};
+  cross_rates_config_t config{};
+  config.home_currencies = {"EUR", "USDT"};
+  cross_rates.configure(std::move(config));
+
+  static std::vector<pushed_subscription_data_t> frame{};
+  auto add_tick = [](std::string const &symbol, double const price) {
+    pushed_subscription_data_t tick{};
+    tick.symbol_id = symbols.get_or_insert(symbol);
+    tick.current_price = decimal_t::from_double(price);
+    frame.push_back(tick);
+  };
+  add_tick("BTCUSDT", 65'000.0);
+  add_tick("EURUSDT", 1.08);
+  for (std::size_t i = 0; i != 700; ++i) {
+    auto const asset = "ASSET" + std::to_string(i);
+    auto const price = static_cast<double>(i + 1);
+    add_tick(asset + "USDT", price);
+    add_tick(asset + "BTC", price / 65'000.0);
+    if (i % 3 == 0) {
+      add_tick(asset + "EUR", price / 1.08);
+    }
+  }
+  for (auto const &tick : frame) {
+    cross_rates.on_tick(tick);
+  }
+
+  runner.run("cross rates/full-market frame (" +
+                 std::to_string(frame.size()) + " symbols, 2 currencies)",
+             frame.size(), [] {
+               static std::int64_t step{1};
+               step = -step;
+               for (auto &tick : frame) {
+                 tick.current_price += decimal_t::from_units(step);
+                 cross_rates.on_tick(tick);
+               }
+               do_not_optimize(cross_rates.implied_price("ASSET5", "EUR"));
+             });
+}
+
+} // namespace bench
+} // namespace binance
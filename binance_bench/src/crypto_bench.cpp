@@ -0,0 +1,43 @@
+#include "bench_runner.hpp"
+#include "common/crypto.hpp"
+
+namespace binance {
+namespace bench {
+
+void register_crypto_benchmarks(bench_runner_t &runner) {
+  // what every signed REST request of binance_orders computes
+  static std::string const secret_key(64, 'k');
+  static std::string const query =
+      "symbol=BTCUSDT&side=BUY&type=LIMIT&timeInForce=GTC&quantity=0.00100000"
+      "&price=35000.00000000&recvWindow=5000&timestamp=1672515782136";
+  static auto const signature = utilities::hmac256_encode(query, secret_key);
+
+  runner.run("crypto/hmac256_encode", 1, [] {
+    do_not_optimize(utilities::hmac256_encode(query, secret_key));
+  });
+
+  runner.run("crypto/base64_encode", 1, [] {
+    do_not_optimize(utilities::base64_encode(signature));
+  });
+
+  // the targets binance_orders' web server gets
+  static std::string const target =
+      "/get_orders?account=main%20account&symbol=BTCUSDT&from=2023-01-01%2000"
+      "%3A00%3A00&to=2023-01-31%2023%3A59%3A59&limit=100";
+  static std::string const decoded_target = utilities::decode_url(target);
+  static std::string const decoded_query =
+      decoded_target.substr(decoded_target.find('?') + 1);
+
+  runner.run("url/decode_url", 1, [] {
+    do_not_optimize(utilities::decode_url(target));
+  });
+
+  runner.run("url/split_string_view", 1, [] {
+    for (auto const &q : utilities::split_string_view(decoded_query, "&")) {
+      do_not_optimize(utilities::split_string_view(q, "="));
+    }
+  });
+}
+
+} // namespace bench
+} // namespace binance
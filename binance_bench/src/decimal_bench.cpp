@@ -0,0 +1,37 @@
+#include "bench_runner.hpp"
+#include "common/decimal.hpp"
+
+namespace binance {
+namespace bench {
+
+void register_decimal_benchmarks(bench_runner_t &runner) {
+  static std::vector<std::string> const prices{
+      "0.00001234", "65012.34000000", "1.00000000", "0.28450000",
+      "4012.10000000", "0.00000001", "23.45600000", "180.00000000"};
+
+  runner.run("decimal/stod", prices.size(), [] {
+    for (auto const &price : prices) {
+      do_not_optimize(std::stod(price));
+    }
+  });
+
+  runner.run("decimal/from_chars", prices.size(), [] {
+    for (auto const &price : prices) {
+      decimal_t value{};
+      from_chars(price.data(), price.data() + price.size(), value);
+      do_not_optimize(value);
+    }
+  });
+
+  runner.run("decimal/to_chars", prices.size(), [] {
+    char buffer[decimal_t::max_chars];
+    for (auto const &price : prices) {
+      auto const value = decimal_t::from_units(
+          static_cast<std::int64_t>(price.size()) * 123'456'789);
+      do_not_optimize(to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+    }
+  });
+}
+
+} // namespace bench
+} // namespace binance
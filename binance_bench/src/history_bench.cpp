@@ -0,0 +1,45 @@
+#include "bench_runner.hpp"
+#include "history_block.hpp"
+
+#include <random>
+
+namespace binance {
+namespace bench {
+
+void register_history_benchmarks(bench_runner_t &runner) {
+  // a miniTicker price every second or so, moving by a few cents
+  static std::vector<price_point_t> points{};
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<std::int64_t> jitter_dist(-10, 10);
+  std::uint64_t time = 1'700'000'000'000;
+  std::int64_t price = 6'500'000'000'000;
+  static history_block_encoder_t encoder{};
+  while (encoder.append(time, decimal_t::from_units(price))) {
+    points.push_back({time, decimal_t::from_units(price)});
+    time += static_cast<std::uint64_t>(1'000 + jitter_dist(gen));
+    price += jitter_dist(gen) * 1'000'000;
+  }
+
+  runner.run("history/encode block (" + std::to_string(points.size()) +
+                 " points, " +
+                 std::to_string(history_block_size / points.size()) +
+                 " bytes/point)",
+             points.size(), [] {
+               encoder.reset();
+               for (auto const &point : points) {
+                 encoder.append(point.time, point.price);
+               }
+               do_not_optimize(encoder.block().header.bit_length);
+             });
+
+  runner.run("history/decode block", points.size(), [] {
+    history_block_decoder_t decoder{encoder.block()};
+    price_point_t point{};
+    while (decoder.next(point)) {
+      do_not_optimize(point);
+    }
+  });
+}
+
+} // namespace bench
+} // namespace binance
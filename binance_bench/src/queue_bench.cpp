@@ -0,0 +1,120 @@
+#include "bench_runner.hpp"
+#include "common/containers.hpp"
+#include "subscription_data.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace binance {
+namespace bench {
+
+namespace {
+
+using item_t = pushed_subscription_data_t;
+
+// a full-market miniTicker frame carries ~2,000 tickers
+constexpr std::size_t frame_size = 2'000;
+constexpr std::size_t max_batch_size = 4'096;
+// pushed to wake up and stop the consumer thread. A valid ID, so that the
+// conflating container has a slot for it
+constexpr symbol_id_t stop_symbol_id = symbol_registry_t::max_symbols - 1;
+
+std::vector<item_t> make_frame() {
+  std::vector<item_t> frame(frame_size);
+  for (std::size_t i = 0; i != frame.size(); ++i) {
+    frame[i].symbol_id = static_cast<symbol_id_t>(i);
+    frame[i].current_price = decimal_t::from_units(i * 1'000);
+    frame[i].event_time = i;
+  }
+  return frame;
+}
+
+/* Measures how long it takes to hand a whole frame over to a consumer thread,
+ * i.e. from the first push until the consumer has seen the last item. */
+template <typename Container, typename Consume>
+void run_handover(bench_runner_t &runner, std::string name,
+                  Container &container, Consume &&consume) {
+  std::atomic<std::size_t> consumed{};
+  std::thread consumer{[&] {
+    while (consume(container, consumed)) {
+    }
+  }};
+
+  auto const frame = make_frame();
+  std::size_t produced = 0;
+  runner.run(std::move(name), frame_size, [&] {
+    container.append_list(std::vector<item_t>(frame));
+    produced += frame_size;
+    while (consumed.load(std::memory_order_acquire) != produced) {
+      std::this_thread::yield();
+    }
+  });
+
+  item_t stop{};
+  stop.symbol_id = stop_symbol_id;
+  container.append(std::move(stop));
+  consumer.join();
+}
+
+// returns false once the stop item was seen
+template <typename Ring>
+bool drain_ring(Ring &ring, std::atomic<std::size_t> &consumed) {
+  thread_local std::vector<item_t> items{};
+  items.clear();
+  ring.drain_up_to(items, max_batch_size);
+  std::size_t count = 0;
+  for (auto const &item : items) {
+    if (item.symbol_id == stop_symbol_id) {
+      return false;
+    }
+    do_not_optimize(item.current_price);
+    ++count;
+  }
+  consumed.fetch_add(count, std::memory_order_release);
+  return true;
+}
+
+} // namespace
+
+void register_queue_benchmarks(bench_runner_t &runner) {
+  {
+    waitable_container_t<item_t> container{};
+    run_handover(runner, "queue/waitable_container (frame)", container,
+                 [](auto &c, std::atomic<std::size_t> &consumed) {
+                   auto const item = c.get();
+                   if (item.symbol_id == stop_symbol_id) {
+                     return false;
+                   }
+                   do_not_optimize(item.current_price);
+                   consumed.fetch_add(1, std::memory_order_release);
+                   return true;
+                 });
+  }
+  {
+    spsc_ring_t<item_t> ring{65'536};
+    run_handover(runner, "queue/spsc_ring (frame)", ring,
+                 [](auto &r, std::atomic<std::size_t> &consumed) {
+                   return drain_ring(r, consumed);
+                 });
+  }
+  {
+    mpsc_ring_t<item_t> ring{65'536};
+    run_handover(runner, "queue/mpsc_ring (frame)", ring,
+                 [](auto &r, std::atomic<std::size_t> &consumed) {
+                   return drain_ring(r, consumed);
+                 });
+  }
+  {
+    // every symbol of the frame changed, so nothing gets conflated: this is
+    // the cost of the bitset scan and the slot locks
+    conflating_container_t<item_t, tick_conflation_t> container{
+        tick_conflation_t::slot_count};
+    run_handover(runner, "queue/conflating_container (frame)", container,
+                 [](auto &c, std::atomic<std::size_t> &consumed) {
+                   return drain_ring(c, consumed);
+                 });
+  }
+}
+
+} // namespace bench
+} // namespace binance
@@ -0,0 +1,44 @@
+#include "bench_runner.hpp"
+#include "rolling_stats.hpp"
+
+#include <random>
+
+namespace binance {
+namespace bench {
+
+void register_rolling_stats_benchmarks(bench_runner_t &runner) {
+  constexpr std::size_t symbol_count = 2'000;
+  static rolling_stats_t stats{};
+  rolling_stats_config_t config{};
+  config.windows_ms = {300'000, 3'600'000, 86'400'000};
+  stats.configure(std::move(config));
+
+  // one full-market miniTicker frame, the prices moving by a few cents
+  static std::vector<pushed_subscription_data_t> frame(symbol_count);
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<std::int64_t> price_dist(1'000'000,
+                                                         6'500'000'000'000);
+  for (std::size_t i = 0; i != symbol_count; ++i) {
+    frame[i].symbol_id = static_cast<symbol_id_t>(i);
+    frame[i].current_price = decimal_t::from_units(price_dist(gen));
+    frame[i].event_time = 1'700'000'000'000;
+  }
+
+  // every call is a second later, so the 5m window closes a bucket every
+  // 5 frames and evicts one once warm
+  runner.run("rolling stats/miniTicker frame (5m, 1h, 24h windows)",
+             symbol_count, [] {
+               static std::int64_t step{};
+               step = (step + 1) % 7;
+               for (auto &tick : frame) {
+                 tick.event_time += 1'000;
+                 tick.current_price += decimal_t::from_units((step - 3) *
+                                                             1'000'000);
+                 stats.on_tick(tick);
+               }
+               do_not_optimize(stats.stats(0, 0));
+             });
+}
+
+} // namespace bench
+} // namespace binance
@@ -0,0 +1,148 @@
+#include "bench_runner.hpp"
+#include "common/timer_wheel.hpp"
+#include "pnl_engine.hpp"
+#include "price_thresholds.hpp"
+
+#include <limits>
+#include <random>
+
+namespace binance {
+namespace bench {
+
+namespace {
+
+constexpr std::size_t symbol_count = 2'000;
+constexpr std::size_t task_count = 300'000;
+
+scheduled_task_t make_price_task(std::size_t const index,
+                                 std::int64_t const threshold) {
+  scheduled_task_t task{};
+  task.request_id = std::to_string(index);
+  task.symbol_id = static_cast<symbol_id_t>(index % symbol_count);
+  task.task_type = task_type_e::price_changes;
+  task.direction = index % 2 == 0 ? "buy" : "sell";
+  task.order_price = decimal_t::from_units(threshold);
+  return task;
+}
+
+scheduled_task_t make_pnl_task(std::size_t const index,
+                               std::int64_t const order_price) {
+  scheduled_task_t task{};
+  task.request_id = std::to_string(index);
+  task.symbol_id = static_cast<symbol_id_t>(index % symbol_count);
+  task.task_type = task_type_e::profit_and_loss;
+  task.direction = index % 2 == 0 ? "buy" : "sell";
+  task.order_price = decimal_t::from_units(order_price);
+  task.quantity = decimal_t::from_units(
+      static_cast<std::int64_t>(index % 1'000 + 1) * 1'000'000);
+  return task;
+}
+
+// one symbol's worth of tasks, recomputed at a new price every time
+void run_pnl_kernel(bench_runner_t &runner, std::string name,
+                    pnl_kernel_t const kernel) {
+  constexpr std::size_t count = 1'000;
+  std::vector<double> quantities(count);
+  std::vector<double> costs(count);
+  std::vector<double> pnls(count, std::numeric_limits<double>::quiet_NaN());
+  std::vector<std::uint32_t> changed(count);
+  for (std::size_t i = 0; i != count; ++i) {
+    quantities[i] = (i % 2 == 0 ? 1.0 : -1.0) * static_cast<double>(i + 1);
+    costs[i] = quantities[i] * 100'000'000.0;
+  }
+  double price = 100'000'000.0;
+  runner.run(std::move(name), count, [&] {
+    price += 1.0;
+    do_not_optimize(kernel(quantities.data(), costs.data(), pnls.data(),
+                           count, price, changed.data()));
+  });
+}
+
+} // namespace
+
+void register_task_benchmarks(bench_runner_t &runner) {
+  // buy tasks below and sell tasks above the price, so that the whole feed
+  // is evaluated against every ladder without anything being triggered
+  static task_registry_t registry{};
+  static price_thresholds_t thresholds{registry};
+  constexpr std::int64_t price = 100'000'000;
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<std::int64_t> distance_dist(1, price / 2);
+  for (std::size_t i = 0; i != task_count; ++i) {
+    auto const distance = distance_dist(gen);
+    thresholds.add(
+        make_price_task(i, i % 2 == 0 ? price - distance : price + distance));
+  }
+
+  runner.run("tasks/price_thresholds (300k tasks, frame)", symbol_count, [] {
+    pushed_subscription_data_t tick{};
+    tick.current_price = decimal_t::from_units(price);
+    for (std::size_t i = 0; i != symbol_count; ++i) {
+      tick.symbol_id = static_cast<symbol_id_t>(i);
+      thresholds.on_tick(tick);
+    }
+  });
+
+  // a tick that triggers a task, and the task added back
+  std::size_t next_id = task_count;
+  runner.run("tasks/price_thresholds (trigger and re-add)", 1, [&] {
+    auto const id = next_id++;
+    thresholds.add(make_price_task(id * 2, price - 1));
+    pushed_subscription_data_t tick{};
+    tick.symbol_id = static_cast<symbol_id_t>(id * 2 % symbol_count);
+    tick.current_price = decimal_t::from_units(price - 1);
+    thresholds.on_tick(tick);
+  });
+
+  run_pnl_kernel(runner, "tasks/pnl_kernel scalar (1k tasks)",
+                 detail::update_pnls_scalar);
+  run_pnl_kernel(runner,
+                 std::string("tasks/pnl_kernel ") + pnl_kernel_name() +
+                     " (1k tasks)",
+                 pnl_kernel());
+
+  // every symbol's price moves, so every task gets a new PnL published
+  static pnl_engine_t pnl_engine{registry};
+  pnl_engine.subscribe([](scheduled_task_t::task_result_t const &result) {
+    do_not_optimize(result.pnl);
+  });
+  for (std::size_t i = 0; i != task_count; ++i) {
+    pnl_engine.add(make_pnl_task(i, price));
+  }
+  std::int64_t price_move = 0;
+  runner.run("tasks/pnl_engine (300k tasks, frame)", task_count, [&] {
+    ++price_move;
+    pushed_subscription_data_t tick{};
+    tick.current_price = decimal_t::from_units(price + price_move);
+    for (std::size_t i = 0; i != symbol_count; ++i) {
+      tick.symbol_id = static_cast<symbol_id_t>(i);
+      pnl_engine.on_tick(tick);
+    }
+  });
+
+  // monitoring windows of up to a day, in ticks of 100ms. Every expired
+  // window is opened again, so that the wheel keeps its size
+  static timer_wheel_t<std::uint32_t> windows{};
+  constexpr std::uint64_t max_window = 24 * 60 * 60 * 10;
+  std::uniform_int_distribution<std::uint64_t> window_dist(1, max_window);
+  std::vector<timer_id_t> window_ids(task_count);
+  for (std::size_t i = 0; i != task_count; ++i) {
+    window_ids[i] =
+        windows.schedule(window_dist(gen), static_cast<std::uint32_t>(i));
+  }
+  std::size_t next_window = 0;
+  runner.run("tasks/timer_wheel (cancel and reopen)", 1, [&] {
+    auto const i = next_window++ % task_count;
+    windows.cancel(window_ids[i]);
+    window_ids[i] = windows.schedule(window_dist(gen),
+                                     static_cast<std::uint32_t>(i));
+  });
+  runner.run("tasks/timer_wheel (300k windows, 1s)", 10, [&] {
+    windows.advance(windows.now() + 10, [&](std::uint32_t &&i) {
+      window_ids[i] = windows.schedule(window_dist(gen), i);
+    });
+  });
+}
+
+} // namespace bench
+} // namespace binance
@@ -0,0 +1,83 @@
+#include "bench_runner.hpp"
+#include "common/json_utils.hpp"
+#include "ticker_decoder.hpp"
+
+namespace binance {
+namespace bench {
+
+namespace {
+
+// this is the DOM path `market_data_stream_t` used before the on-demand
+// decoder, kept here as the baseline.
+std::vector<pushed_subscription_data_t>
+decode_with_json_dom(std::string_view const frame,
+                     symbol_registry_t &registry) {
+  auto const data_list = json::parse(frame).get<json::array_t>();
+  std::vector<pushed_subscription_data_t> pushed_list{};
+  pushed_list.reserve(data_list.size());
+
+  for (auto const &data_json : data_list) {
+    pushed_subscription_data_t data{};
+    auto const data_object = data_json.get<json::object_t>();
+    data.symbol_id =
+        registry.get_or_insert(data_object.at("s").get<json::string_t>());
+    data.current_price = decimal_t::from_double(
+        std::stod(data_object.at("c").get<json::string_t>()));
+    data.open_24h = decimal_t::from_double(
+        std::stod(data_object.at("o").get<json::string_t>()));
+    pushed_list.push_back(std::move(data));
+  }
+  return pushed_list;
+}
+
+std::vector<pushed_subscription_data_t>
+decode_on_demand(std::string_view const frame, symbol_registry_t &registry) {
+  std::vector<pushed_subscription_data_t> pushed_list{};
+  decode_mini_ticker_array(frame, registry, pushed_list);
+  return pushed_list;
+}
+
+bool same_tickers(std::vector<pushed_subscription_data_t> const &a,
+                  std::vector<pushed_subscription_data_t> const &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i != a.size(); ++i) {
+    if (a[i].symbol_id != b[i].symbol_id ||
+        a[i].current_price != b[i].current_price ||
+        a[i].open_24h != b[i].open_24h) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+void register_ticker_decoder_benchmarks(
+    bench_runner_t &runner, std::vector<std::string> const &frames) {
+  static symbol_registry_t registry{};
+  std::size_t tickers_per_pass{};
+  for (auto const &frame : frames) {
+    auto const from_dom = decode_with_json_dom(frame, registry);
+    if (!same_tickers(from_dom, decode_on_demand(frame, registry))) {
+      spdlog::error("on-demand decoder disagrees with json::parse on a frame");
+    }
+    tickers_per_pass += from_dom.size();
+  }
+
+  runner.run("miniTicker/json_dom", tickers_per_pass, [&frames] {
+    for (auto const &frame : frames) {
+      do_not_optimize(decode_with_json_dom(frame, registry));
+    }
+  });
+
+  runner.run("miniTicker/on_demand", tickers_per_pass, [&frames] {
+    for (auto const &frame : frames) {
+      do_not_optimize(decode_on_demand(frame, registry));
+    }
+  });
+}
+
+} // namespace bench
+} // namespace binance
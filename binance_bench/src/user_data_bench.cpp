@@ -0,0 +1,59 @@
+#include "bench_runner.hpp"
+#include "orders_info.hpp"
+#include "telegram_process.hpp"
+
+namespace binance {
+namespace bench {
+
+namespace {
+
+// a filled LIMIT order, as pushed on a user data stream
+constexpr char const *execution_report =
+    R"({"e":"executionReport","E":1672515782136,"s":"BTCUSDT",)"
+    R"("c":"web_6a5cd9f6e2e04b6e9e6d3b3b5c0e3c4f","S":"BUY","o":"LIMIT",)"
+    R"("f":"GTC","q":"0.00100000","p":"16500.00000000","P":"0.00000000",)"
+    R"("F":"0.00000000","g":-1,"C":"","x":"TRADE","X":"FILLED","r":"NONE",)"
+    R"("i":17549812351,"l":"0.00100000","z":"0.00100000",)"
+    R"("L":"16500.00000000","n":"0.00000100","N":"BTC","T":1672515782135,)"
+    R"("t":2466489843,"I":36473483102,"w":false,"m":true,"M":true,)"
+    R"("O":1672515780000,"Z":"16.50000000","Y":"16.50000000",)"
+    R"("Q":"0.00000000"})";
+
+} // namespace
+
+void register_user_data_benchmarks(bench_runner_t &runner) {
+  runner.run("executionReport/parse+decode", 1, [] {
+    auto const order_object =
+        json::parse(execution_report).get<json::object_t>();
+    do_not_optimize(decode_execution_report(order_object));
+  });
+
+  static auto const order_object =
+      json::parse(execution_report).get<json::object_t>();
+  runner.run("executionReport/decode", 1, [] {
+    do_not_optimize(decode_execution_report(order_object));
+  });
+
+  runner.run("get_value/string", 1, [] {
+    do_not_optimize(
+        utilities::get_value<json::string_t>(order_object, "X"));
+  });
+  runner.run("get_value/integer", 1, [] {
+    do_not_optimize(
+        utilities::get_value<json::number_integer_t>(order_object, "i"));
+  });
+  runner.run("get_value/decimal", 1, [] {
+    do_not_optimize(utilities::get_value<decimal_t>(order_object, "p"));
+  });
+
+  runner.run("timet_to_string", 1, [] {
+    do_not_optimize(utilities::timet_to_string(std::size_t{1672515782}));
+  });
+
+  static auto const order_info = decode_execution_report(order_object);
+  runner.run("telegram/prepare_payload", 1,
+             [] { do_not_optimize(prepare_telegram_payload(order_info)); });
+}
+
+} // namespace bench
+} // namespace binance
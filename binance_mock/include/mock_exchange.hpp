@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/beast/core/error.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mock_feeds.hpp"
+
+namespace binance {
+namespace mock {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+
+struct mock_config_t {
+  std::string ip_address{"127.0.0.1"};
+  std::uint16_t port{9443};
+  // the number of listed symbols, i.e. of tickers per miniTicker array
+  std::size_t symbol_count{2'000};
+  // frames per second and connection, 0 to send them as fast as the client
+  // reads them
+  double market_data_rate{1.0};
+  double user_data_rate{1.0};
+};
+
+// what every connection sent, logged periodically
+struct mock_stats_t {
+  std::atomic<std::uint64_t> market_data_frames{};
+  std::atomic<std::uint64_t> user_data_frames{};
+  std::atomic<std::uint64_t> bytes{};
+  std::atomic<std::uint64_t> rest_requests{};
+  std::atomic<std::uint64_t> connections{};
+};
+
+// what the sessions share, built once at startup
+struct mock_state_t {
+  mock_config_t const config;
+  std::string const ticker_price_list;
+  std::vector<frame_template_t> const mini_ticker_arrays;
+  std::vector<frame_template_t> const execution_reports;
+  mock_stats_t stats{};
+  std::atomic<std::uint64_t> listen_key_count{};
+
+  explicit mock_state_t(mock_config_t config);
+};
+
+/* Accepts TLS connections and serves, on the same port:
+ * - GET /api/v3/ticker/price, the listed symbols;
+ * - POST, PUT and DELETE /api/v3/userDataStream, a new listen key;
+ * - /ws/!miniTicker@arr, full-market miniTicker arrays;
+ * - /stream?streams=..., combined miniTicker, bookTicker and aggTrade events;
+ * - /ws/<listen key>, executionReports of filled orders.
+ */
+class mock_exchange_t : public std::enable_shared_from_this<mock_exchange_t> {
+  net::io_context &io_context_;
+  net::ssl::context &ssl_ctx_;
+  mock_state_t &state_;
+  net::ip::tcp::acceptor acceptor_;
+  bool is_open_{false};
+
+  void accept_connections();
+  void on_connection_accepted(beast::error_code const &ec,
+                              net::ip::tcp::socket socket);
+
+public:
+  mock_exchange_t(net::io_context &, net::ssl::context &, mock_state_t &);
+  void run();
+  operator bool() const { return is_open_; }
+};
+
+} // namespace mock
+} // namespace binance
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace binance {
+namespace mock {
+
+/* A frame rendered once at startup. Only its event times and sequence
+ * numbers change from one send to the next, so they are patched in place
+ * instead of formatting the whole frame again: a full-market miniTicker
+ * array is ~200 KB of JSON and the mock must not be the bottleneck of a load
+ * test.
+ *
+ * Both kinds of fields are 13 digits wide: millisecond times have 13 digits
+ * until the year 2286, and sequences start at 10^12.
+ */
+class frame_template_t {
+  std::string text_{};
+  std::vector<std::size_t> time_offsets_{};
+  std::vector<std::size_t> sequence_offsets_{};
+
+public:
+  static constexpr std::size_t field_width = 13;
+  static constexpr std::uint64_t first_sequence = 1'000'000'000'000;
+
+  void append(std::string_view const text) { text_ += text; }
+  void append_time();
+  void append_sequence();
+  std::size_t size() const { return text_.size(); }
+
+  // copies the template into `out` with every time set to `time_ms` and
+  // every sequence to `first_sequence + sequence`
+  void render(std::string &out, std::uint64_t const time_ms,
+              std::uint64_t const sequence) const;
+};
+
+// the symbols the mock lists: SYM0USDT, SYM1USDT, ...
+std::string mock_symbol(std::size_t const index);
+
+// the body of GET /api/v3/ticker/price
+std::string make_ticker_price_list(std::size_t const symbol_count);
+
+// `variants` full-market `!miniTicker@arr` frames, the prices moving a bit
+// from one to the next
+std::vector<frame_template_t>
+make_mini_ticker_arrays(std::size_t const symbol_count,
+                        std::size_t const variants);
+
+// `variants` combined-stream frames for each of the `<symbol>@<stream>`
+// names of a `/stream?streams=` path (miniTicker, bookTicker and aggTrade)
+std::vector<frame_template_t>
+make_combined_stream_frames(std::string_view const streams,
+                            std::size_t const variants);
+
+// `variants` executionReport events of filled orders
+std::vector<frame_template_t>
+make_execution_reports(std::size_t const symbol_count,
+                       std::size_t const variants);
+
+} // namespace mock
+} // namespace binance
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <chrono>
+#include <optional>
+
+#include "mock_exchange.hpp"
+
+namespace binance {
+namespace mock {
+
+namespace http = beast::http;
+namespace websock = beast::websocket;
+
+/* One client connection: a TLS handshake, then either REST requests on a
+ * kept-alive connection or a websocket upgrade after which the session
+ * pushes frames at the configured rate.
+ *
+ * Frames are written one at a time, so a client that can't keep up slows
+ * the session down through TCP back-pressure rather than growing a queue in
+ * the mock: the rate the mock logs is the rate the client sustains.
+ */
+class mock_session_t : public std::enable_shared_from_this<mock_session_t> {
+  using ssl_stream_t = beast::ssl_stream<beast::tcp_stream>;
+  using clock = std::chrono::steady_clock;
+
+  mock_state_t &state_;
+  std::optional<ssl_stream_t> ssl_stream_;
+  std::optional<websock::stream<ssl_stream_t>> ws_stream_;
+  beast::flat_buffer buffer_{};
+  std::optional<http::request<http::string_body>> request_;
+  std::optional<http::response<http::string_body>> response_;
+  net::steady_timer timer_;
+
+  // the websocket feed
+  std::vector<frame_template_t> combined_frames_{};
+  std::vector<frame_template_t> const *frames_{nullptr};
+  std::atomic<std::uint64_t> *frame_counter_{nullptr};
+  double rate_{};
+  std::string frame_{};
+  std::uint64_t sent_{};
+  std::uint64_t last_time_ms_{};
+  clock::time_point started_at_{};
+
+  void on_handshake(beast::error_code const ec);
+  void read_request();
+  void on_request_read(beast::error_code const ec);
+  void handle_rest_request();
+  void send_response(http::status const status, std::string body);
+
+  void accept_websocket();
+  void read_websocket();
+  void send_next_frame();
+  void wait_for_next_frame();
+
+public:
+  mock_session_t(net::ip::tcp::socket &&socket, net::ssl::context &,
+                 mock_state_t &);
+  void run();
+};
+
+} // namespace mock
+} // namespace binance
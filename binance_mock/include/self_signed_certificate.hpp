@@ -0,0 +1,15 @@
+#pragma once
+
+#include <boost/asio/ssl/context.hpp>
+
+namespace binance {
+namespace mock {
+
+/* Generates a P-256 key and a certificate for "localhost" signed with it,
+ * and makes `ssl_ctx` use them. The services don't verify the exchange's
+ * certificate, so a throwaway one is enough for local load tests.
+ */
+bool use_self_signed_certificate(boost::asio::ssl::context &ssl_ctx);
+
+} // namespace mock
+} // namespace binance
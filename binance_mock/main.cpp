@@ -0,0 +1,132 @@
+#include <CLI/CLI.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+#include "mock_exchange.hpp"
+#include "self_signed_certificate.hpp"
+
+namespace {
+
+namespace net = boost::asio;
+
+constexpr auto stats_period = std::chrono::seconds(5);
+
+struct stats_snapshot_t {
+  std::uint64_t market_data_frames{};
+  std::uint64_t user_data_frames{};
+  std::uint64_t bytes{};
+};
+
+stats_snapshot_t take_snapshot(binance::mock::mock_stats_t const &stats) {
+  stats_snapshot_t snapshot{};
+  snapshot.market_data_frames = stats.market_data_frames.load();
+  snapshot.user_data_frames = stats.user_data_frames.load();
+  snapshot.bytes = stats.bytes.load();
+  return snapshot;
+}
+
+// the rates logged are what the connected clients actually kept up with
+void log_stats_periodically(net::steady_timer &timer,
+                            binance::mock::mock_stats_t const &stats,
+                            stats_snapshot_t const last) {
+  timer.expires_after(stats_period);
+  timer.async_wait([&timer, &stats,
+                    last](boost::system::error_code const ec) {
+    if (ec) {
+      return;
+    }
+    auto const current = take_snapshot(stats);
+    double const seconds = static_cast<double>(stats_period.count());
+    spdlog::info("{:.0f} market data frames/s, {:.0f} user data frames/s, "
+                 "{:.2f} MB/s, {} connections",
+                 (current.market_data_frames - last.market_data_frames) /
+                     seconds,
+                 (current.user_data_frames - last.user_data_frames) / seconds,
+                 (current.bytes - last.bytes) / seconds / 1'000'000.0,
+                 stats.connections.load());
+    log_stats_periodically(timer, stats, current);
+  });
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  CLI::App cli_parser{"binance_mock: a local stand-in for the Binance REST "
+                      "and websocket endpoints, for load tests"};
+  binance::mock::mock_config_t config{};
+  std::string certificate_filename{};
+  std::string private_key_filename{};
+  std::size_t thread_count{std::thread::hardware_concurrency()};
+
+  cli_parser.add_option("-a,--address", config.ip_address,
+                        "IP address to listen on", true);
+  cli_parser.add_option("-p,--port", config.port,
+                        "port serving both the REST API and the websockets",
+                        true);
+  cli_parser.add_option("--symbols", config.symbol_count,
+                        "number of listed symbols", true);
+  cli_parser.add_option("--market-rate", config.market_data_rate,
+                        "market data frames per second and connection, 0 "
+                        "for as fast as the client reads",
+                        true);
+  cli_parser.add_option("--order-rate", config.user_data_rate,
+                        "executionReports per second and connection, 0 for "
+                        "as fast as the client reads",
+                        true);
+  cli_parser.add_option("--cert", certificate_filename,
+                        "PEM certificate chain, a self-signed one is "
+                        "generated if none is given");
+  cli_parser.add_option("--key", private_key_filename,
+                        "PEM private key of --cert");
+  cli_parser.add_option("-t,--threads", thread_count, "number of threads",
+                        true);
+  CLI11_PARSE(cli_parser, argc, argv);
+
+  net::ssl::context ssl_context{net::ssl::context::tls_server};
+  if (certificate_filename.empty()) {
+    if (!binance::mock::use_self_signed_certificate(ssl_context)) {
+      spdlog::error("unable to generate a self-signed certificate");
+      return EXIT_FAILURE;
+    }
+  } else {
+    boost::system::error_code ec{};
+    ssl_context.use_certificate_chain_file(certificate_filename, ec);
+    if (!ec) {
+      ssl_context.use_private_key_file(private_key_filename,
+                                       net::ssl::context::pem, ec);
+    }
+    if (ec) {
+      spdlog::error("unable to load the certificate: {}", ec.message());
+      return EXIT_FAILURE;
+    }
+  }
+
+  thread_count = std::max<std::size_t>(thread_count, 1);
+  net::io_context io_context{static_cast<int>(thread_count)};
+  binance::mock::mock_state_t state{config};
+  auto exchange = std::make_shared<binance::mock::mock_exchange_t>(
+      io_context, ssl_context, state);
+  if (!(*exchange)) {
+    return EXIT_FAILURE;
+  }
+  exchange->run();
+  spdlog::info("binance_mock: listening on {}:{} with {} symbols",
+               config.ip_address, config.port, config.symbol_count);
+
+  net::steady_timer stats_timer{io_context};
+  log_stats_periodically(stats_timer, state.stats, {});
+
+  std::vector<std::thread> threads{};
+  threads.reserve(thread_count - 1);
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back([&] { io_context.run(); });
+  }
+  io_context.run();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+#include "mock_exchange.hpp"
+#include "mock_session.hpp"
+
+#include <boost/asio/strand.hpp>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+namespace mock {
+
+mock_state_t::mock_state_t(mock_config_t config)
+    : config{std::move(config)},
+      ticker_price_list{make_ticker_price_list(this->config.symbol_count)},
+      mini_ticker_arrays{make_mini_ticker_arrays(this->config.symbol_count, 8)},
+      execution_reports{make_execution_reports(this->config.symbol_count, 16)} {
+}
+
+mock_exchange_t::mock_exchange_t(net::io_context &io_context,
+                                 net::ssl::context &ssl_ctx,
+                                 mock_state_t &state)
+    : io_context_{io_context}, ssl_ctx_{ssl_ctx}, state_{state},
+      acceptor_{net::make_strand(io_context_)} {
+  net::ip::tcp::endpoint const endpoint{
+      net::ip::make_address(state_.config.ip_address), state_.config.port};
+  beast::error_code ec{};
+  acceptor_.open(endpoint.protocol(), ec);
+  if (ec) {
+    spdlog::error("Could not open socket: {}", ec.message());
+    return;
+  }
+  acceptor_.set_option(net::socket_base::reuse_address(true), ec);
+  if (ec) {
+    spdlog::error("set_option failed: {}", ec.message());
+    return;
+  }
+  acceptor_.bind(endpoint, ec);
+  if (ec) {
+    spdlog::error("binding failed: {}", ec.message());
+    return;
+  }
+  acceptor_.listen(net::socket_base::max_listen_connections, ec);
+  if (ec) {
+    spdlog::error("not able to listen: {}", ec.message());
+    return;
+  }
+  is_open_ = true;
+}
+
+void mock_exchange_t::run() {
+  if (is_open_) {
+    accept_connections();
+  }
+}
+
+void mock_exchange_t::accept_connections() {
+  acceptor_.async_accept(
+      net::make_strand(io_context_),
+      beast::bind_front_handler(&mock_exchange_t::on_connection_accepted,
+                                shared_from_this()));
+}
+
+void mock_exchange_t::on_connection_accepted(beast::error_code const &ec,
+                                             net::ip::tcp::socket socket) {
+  if (ec) {
+    spdlog::error("error on connection: {}", ec.message());
+  } else {
+    std::make_shared<mock_session_t>(std::move(socket), ssl_ctx_, state_)
+        ->run();
+  }
+  accept_connections();
+}
+
+} // namespace mock
+} // namespace binance
@@ -0,0 +1,238 @@
+#include "mock_feeds.hpp"
+
+#include <algorithm>
+#include <random>
+#include <spdlog/fmt/fmt.h>
+
+namespace binance {
+namespace mock {
+
+namespace {
+
+void write_digits(char *out, std::uint64_t value) {
+  for (std::size_t i = frame_template_t::field_width; i != 0; --i) {
+    out[i - 1] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+// a random walk of prices, one per symbol, moving by up to 0.1% a step
+class price_walk_t {
+  std::mt19937 gen_{42};
+  std::uniform_real_distribution<> step_{-0.001, 0.001};
+  std::vector<double> prices_{};
+
+public:
+  explicit price_walk_t(std::size_t const symbol_count) {
+    std::uniform_real_distribution<> initial_price{0.0001, 60'000.0};
+    prices_.reserve(symbol_count);
+    for (std::size_t i = 0; i != symbol_count; ++i) {
+      prices_.push_back(initial_price(gen_));
+    }
+  }
+
+  void step() {
+    for (auto &price : prices_) {
+      price *= 1.0 + step_(gen_);
+    }
+  }
+
+  std::string price(std::size_t const index) const {
+    return fmt::format("{:.8f}", prices_[index % prices_.size()]);
+  }
+  std::string price(std::size_t const index, double const factor) const {
+    return fmt::format("{:.8f}", prices_[index % prices_.size()] * factor);
+  }
+};
+
+// "btcusdt@bookTicker" -> ("BTCUSDT", "bookTicker")
+std::pair<std::string, std::string> split_stream_name(std::string_view name) {
+  auto const at = name.find('@');
+  std::string symbol(name.substr(0, at));
+  std::transform(symbol.begin(), symbol.end(), symbol.begin(),
+                 [](unsigned char const c) { return std::toupper(c); });
+  if (at == std::string_view::npos) {
+    return {symbol, "miniTicker"};
+  }
+  return {symbol, std::string(name.substr(at + 1))};
+}
+
+void append_mini_ticker(frame_template_t &frame, std::string const &symbol,
+                        price_walk_t const &walk, std::size_t const index) {
+  frame.append(R"({"e":"24hrMiniTicker","E":)");
+  frame.append_time();
+  frame.append(R"(,"s":")");
+  frame.append(symbol);
+  frame.append(R"(","c":")");
+  frame.append(walk.price(index));
+  frame.append(R"(","o":")");
+  frame.append(walk.price(index, 0.98));
+  frame.append(R"(","h":")");
+  frame.append(walk.price(index, 1.02));
+  frame.append(R"(","l":")");
+  frame.append(walk.price(index, 0.97));
+  frame.append(R"(","v":"1234567.89000000","q":"9876543.21000000"})");
+}
+
+void append_book_ticker(frame_template_t &frame, std::string const &symbol,
+                        price_walk_t const &walk, std::size_t const index) {
+  frame.append(R"({"u":)");
+  frame.append_sequence();
+  frame.append(R"(,"s":")");
+  frame.append(symbol);
+  frame.append(R"(","b":")");
+  frame.append(walk.price(index, 0.9995));
+  frame.append(R"(","B":"12.50000000","a":")");
+  frame.append(walk.price(index, 1.0005));
+  frame.append(R"(","A":"7.25000000"})");
+}
+
+void append_agg_trade(frame_template_t &frame, std::string const &symbol,
+                      price_walk_t const &walk, std::size_t const index) {
+  frame.append(R"({"e":"aggTrade","E":)");
+  frame.append_time();
+  frame.append(R"(,"s":")");
+  frame.append(symbol);
+  frame.append(R"(","a":)");
+  frame.append_sequence();
+  frame.append(R"(,"p":")");
+  frame.append(walk.price(index));
+  frame.append(R"(","q":"0.50000000","f":100,"l":105,"T":)");
+  frame.append_time();
+  frame.append(R"(,"m":true,"M":true})");
+}
+
+} // namespace
+
+void frame_template_t::append_time() {
+  time_offsets_.push_back(text_.size());
+  text_.append(field_width, '0');
+}
+
+void frame_template_t::append_sequence() {
+  sequence_offsets_.push_back(text_.size());
+  text_.append(field_width, '0');
+}
+
+void frame_template_t::render(std::string &out, std::uint64_t const time_ms,
+                              std::uint64_t const sequence) const {
+  out.assign(text_);
+  for (auto const offset : time_offsets_) {
+    write_digits(out.data() + offset, time_ms);
+  }
+  for (auto const offset : sequence_offsets_) {
+    write_digits(out.data() + offset, first_sequence + sequence);
+  }
+}
+
+std::string mock_symbol(std::size_t const index) {
+  return fmt::format("SYM{}USDT", index);
+}
+
+std::string make_ticker_price_list(std::size_t const symbol_count) {
+  price_walk_t const walk{symbol_count};
+  std::string body = "[";
+  for (std::size_t i = 0; i != symbol_count; ++i) {
+    if (i != 0) {
+      body += ',';
+    }
+    body += fmt::format(R"({{"symbol":"{}","price":"{}"}})", mock_symbol(i),
+                        walk.price(i));
+  }
+  body += ']';
+  return body;
+}
+
+std::vector<frame_template_t>
+make_mini_ticker_arrays(std::size_t const symbol_count,
+                        std::size_t const variants) {
+  price_walk_t walk{symbol_count};
+  std::vector<frame_template_t> frames(variants);
+  for (auto &frame : frames) {
+    frame.append("[");
+    for (std::size_t i = 0; i != symbol_count; ++i) {
+      if (i != 0) {
+        frame.append(",");
+      }
+      append_mini_ticker(frame, mock_symbol(i), walk, i);
+    }
+    frame.append("]");
+    walk.step();
+  }
+  return frames;
+}
+
+std::vector<frame_template_t>
+make_combined_stream_frames(std::string_view streams,
+                            std::size_t const variants) {
+  std::vector<std::string_view> names{};
+  while (!streams.empty()) {
+    auto const slash = streams.find('/');
+    if (auto const name = streams.substr(0, slash); !name.empty()) {
+      names.push_back(name);
+    }
+    if (slash == std::string_view::npos) {
+      break;
+    }
+    streams.remove_prefix(slash + 1);
+  }
+
+  price_walk_t walk{std::max<std::size_t>(names.size(), 1)};
+  std::vector<frame_template_t> frames{};
+  frames.reserve(names.size() * variants);
+  for (std::size_t variant = 0; variant != variants; ++variant) {
+    for (std::size_t i = 0; i != names.size(); ++i) {
+      auto const [symbol, stream] = split_stream_name(names[i]);
+      auto &frame = frames.emplace_back();
+      frame.append(R"({"stream":")");
+      frame.append(names[i]);
+      frame.append(R"(","data":)");
+      if (stream == "bookTicker") {
+        append_book_ticker(frame, symbol, walk, i);
+      } else if (stream == "aggTrade") {
+        append_agg_trade(frame, symbol, walk, i);
+      } else {
+        append_mini_ticker(frame, symbol, walk, i);
+      }
+      frame.append("}");
+    }
+    walk.step();
+  }
+  return frames;
+}
+
+std::vector<frame_template_t>
+make_execution_reports(std::size_t const symbol_count,
+                       std::size_t const variants) {
+  price_walk_t const walk{std::max<std::size_t>(symbol_count, 1)};
+  std::vector<frame_template_t> frames(variants);
+  for (std::size_t i = 0; i != variants; ++i) {
+    auto const price = walk.price(i);
+    auto &frame = frames[i];
+    frame.append(R"({"e":"executionReport","E":)");
+    frame.append_time();
+    frame.append(R"(,"s":")");
+    frame.append(mock_symbol(i % std::max<std::size_t>(symbol_count, 1)));
+    frame.append(R"(","c":"mock","S":")");
+    frame.append(i % 2 == 0 ? "BUY" : "SELL");
+    frame.append(R"(","o":"LIMIT","f":"GTC","q":"1.00000000","p":")");
+    frame.append(price);
+    frame.append(R"(","P":"0.00000000","F":"0.00000000","g":-1,"C":"",)"
+                 R"("x":"TRADE","X":"FILLED","r":"NONE","i":)");
+    frame.append_sequence();
+    frame.append(R"(,"l":"1.00000000","z":"1.00000000","L":")");
+    frame.append(price);
+    frame.append(R"(","n":"0.00100000","N":"BNB","T":)");
+    frame.append_time();
+    frame.append(R"(,"t":)");
+    frame.append_sequence();
+    frame.append(R"(,"I":1,"w":false,"m":false,"M":true,"O":)");
+    frame.append_time();
+    frame.append(R"(,"Z":"1.00000000","Y":"1.00000000",)"
+                 R"("Q":"0.00000000"})");
+  }
+  return frames;
+}
+
+} // namespace mock
+} // namespace binance
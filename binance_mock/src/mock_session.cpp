@@ -0,0 +1,211 @@
+#include "mock_session.hpp"
+
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/write.hpp>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+namespace mock {
+
+namespace {
+
+std::uint64_t milliseconds_since_epoch() {
+  using namespace std::chrono;
+  return static_cast<std::uint64_t>(
+      duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+          .count());
+}
+
+} // namespace
+
+mock_session_t::mock_session_t(net::ip::tcp::socket &&socket,
+                               net::ssl::context &ssl_ctx,
+                               mock_state_t &state)
+    : state_{state}, timer_{socket.get_executor()} {
+  ssl_stream_.emplace(std::move(socket), ssl_ctx);
+}
+
+void mock_session_t::run() {
+  state_.stats.connections.fetch_add(1, std::memory_order_relaxed);
+  beast::get_lowest_layer(*ssl_stream_).expires_after(std::chrono::seconds(30));
+  ssl_stream_->async_handshake(
+      net::ssl::stream_base::server,
+      [self = shared_from_this()](beast::error_code const ec) {
+        self->on_handshake(ec);
+      });
+}
+
+void mock_session_t::on_handshake(beast::error_code const ec) {
+  if (ec) {
+    return spdlog::error("TLS handshake failed: {}", ec.message());
+  }
+  read_request();
+}
+
+void mock_session_t::read_request() {
+  request_.emplace();
+  beast::get_lowest_layer(*ssl_stream_).expires_after(std::chrono::seconds(60));
+  http::async_read(*ssl_stream_, buffer_, *request_,
+                   [self = shared_from_this()](beast::error_code const ec,
+                                               std::size_t const) {
+                     self->on_request_read(ec);
+                   });
+}
+
+void mock_session_t::on_request_read(beast::error_code const ec) {
+  if (ec == http::error::end_of_stream) {
+    return ssl_stream_->async_shutdown(
+        [self = shared_from_this()](beast::error_code const) {});
+  } else if (ec) {
+    return;
+  }
+  if (websock::is_upgrade(*request_)) {
+    return accept_websocket();
+  }
+  handle_rest_request();
+}
+
+void mock_session_t::handle_rest_request() {
+  state_.stats.rest_requests.fetch_add(1, std::memory_order_relaxed);
+  auto const target = request_->target();
+  auto const path = target.substr(0, target.find('?'));
+  auto const method = request_->method();
+
+  if (path == "/api/v3/ticker/price" && method == http::verb::get) {
+    return send_response(http::status::ok, state_.ticker_price_list);
+  } else if (path == "/api/v3/userDataStream") {
+    if (method == http::verb::post) {
+      auto const id = state_.listen_key_count.fetch_add(1);
+      return send_response(http::status::ok,
+                           fmt::format(R"({{"listenKey":"mocklistenkey{}"}})",
+                                       id));
+    } else if (method == http::verb::put || method == http::verb::delete_) {
+      return send_response(http::status::ok, "{}");
+    }
+  }
+  send_response(http::status::not_found,
+                R"({"code":-1,"msg":"not served by the mock exchange"})");
+}
+
+void mock_session_t::send_response(http::status const status,
+                                   std::string body) {
+  auto &response = response_.emplace(status, request_->version());
+  response.set(http::field::server, "binance_mock");
+  response.set(http::field::content_type, "application/json;charset=UTF-8");
+  response.keep_alive(request_->keep_alive());
+  response.body() = std::move(body);
+  response.prepare_payload();
+
+  http::async_write(*ssl_stream_, response,
+                    [self = shared_from_this()](beast::error_code const ec,
+                                                std::size_t const) {
+                      if (ec) {
+                        return;
+                      }
+                      if (!self->response_->keep_alive()) {
+                        return self->ssl_stream_->async_shutdown(
+                            [self](beast::error_code const) {});
+                      }
+                      self->response_.reset();
+                      self->read_request();
+                    });
+}
+
+void mock_session_t::accept_websocket() {
+  std::string_view const target(request_->target().data(),
+                                request_->target().size());
+  std::string_view const combined_prefix = "/stream?streams=";
+  auto &config = state_.config;
+
+  if (target == "/ws/!miniTicker@arr") {
+    frames_ = &state_.mini_ticker_arrays;
+    frame_counter_ = &state_.stats.market_data_frames;
+    rate_ = config.market_data_rate;
+  } else if (target.rfind(combined_prefix, 0) == 0) {
+    combined_frames_ =
+        make_combined_stream_frames(target.substr(combined_prefix.size()), 8);
+    frames_ = &combined_frames_;
+    frame_counter_ = &state_.stats.market_data_frames;
+    rate_ = config.market_data_rate;
+  } else if (target.rfind("/ws/", 0) == 0) {
+    // anything else under /ws/ is taken for a listen key
+    frames_ = &state_.execution_reports;
+    frame_counter_ = &state_.stats.user_data_frames;
+    rate_ = config.user_data_rate;
+  }
+  if (frames_ == nullptr || frames_->empty()) {
+    return send_response(http::status::not_found,
+                         R"({"code":-1,"msg":"unknown stream"})");
+  }
+
+  beast::get_lowest_layer(*ssl_stream_).expires_never();
+  ws_stream_.emplace(std::move(*ssl_stream_));
+  ssl_stream_.reset();
+  ws_stream_->set_option(
+      websock::stream_base::timeout::suggested(beast::role_type::server));
+  ws_stream_->async_accept(
+      *request_, [self = shared_from_this()](beast::error_code const ec) {
+        if (ec) {
+          return spdlog::error("websocket upgrade failed: {}", ec.message());
+        }
+        self->started_at_ = clock::now();
+        self->read_websocket();
+        self->send_next_frame();
+      });
+}
+
+// control frames (pings, close) are only handled while a read is pending
+void mock_session_t::read_websocket() {
+  ws_stream_->async_read(buffer_,
+                         [self = shared_from_this()](beast::error_code const ec,
+                                                     std::size_t const) {
+                           if (ec) {
+                             return self->timer_.cancel();
+                           }
+                           self->buffer_.clear();
+                           self->read_websocket();
+                         });
+}
+
+void mock_session_t::send_next_frame() {
+  // event times must keep increasing, even at thousands of frames a second
+  last_time_ms_ = std::max(milliseconds_since_epoch(), last_time_ms_ + 1);
+  (*frames_)[sent_ % frames_->size()].render(frame_, last_time_ms_, sent_);
+
+  ws_stream_->text(true);
+  ws_stream_->async_write(
+      net::buffer(frame_), [self = shared_from_this()](
+                               beast::error_code const ec,
+                               std::size_t const bytes_written) {
+        if (ec) {
+          return;
+        }
+        ++self->sent_;
+        self->frame_counter_->fetch_add(1, std::memory_order_relaxed);
+        self->state_.stats.bytes.fetch_add(bytes_written,
+                                           std::memory_order_relaxed);
+        self->wait_for_next_frame();
+      });
+}
+
+void mock_session_t::wait_for_next_frame() {
+  if (rate_ <= 0.0) {
+    return send_next_frame();
+  }
+  auto const due =
+      started_at_ + std::chrono::duration_cast<clock::duration>(
+                        std::chrono::duration<double>(sent_ / rate_));
+  if (due <= clock::now()) {
+    return send_next_frame();
+  }
+  timer_.expires_at(due);
+  timer_.async_wait([self = shared_from_this()](beast::error_code const ec) {
+    if (ec) {
+      return;
+    }
+    self->send_next_frame();
+  });
+}
+
+} // namespace mock
+} // namespace binance
@@ -0,0 +1,49 @@
+#include "self_signed_certificate.hpp"
+
+#include <memory>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+namespace binance {
+namespace mock {
+
+bool use_self_signed_certificate(boost::asio::ssl::context &ssl_ctx) {
+  std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> key_ctx{
+      EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr), EVP_PKEY_CTX_free};
+  EVP_PKEY *raw_key = nullptr;
+  if (!key_ctx || EVP_PKEY_keygen_init(key_ctx.get()) <= 0 ||
+      EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx.get(),
+                                             NID_X9_62_prime256v1) <= 0 ||
+      EVP_PKEY_keygen(key_ctx.get(), &raw_key) <= 0) {
+    return false;
+  }
+  std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key{raw_key,
+                                                          EVP_PKEY_free};
+
+  std::unique_ptr<X509, decltype(&X509_free)> certificate{X509_new(),
+                                                          X509_free};
+  if (!certificate) {
+    return false;
+  }
+  X509_set_version(certificate.get(), 2);
+  ASN1_INTEGER_set(X509_get_serialNumber(certificate.get()), 1);
+  X509_gmtime_adj(X509_getm_notBefore(certificate.get()), 0);
+  X509_gmtime_adj(X509_getm_notAfter(certificate.get()), 365L * 24 * 3'600);
+  X509_set_pubkey(certificate.get(), key.get());
+
+  auto *name = X509_get_subject_name(certificate.get());
+  X509_NAME_add_entry_by_txt(
+      name, "CN", MBSTRING_ASC,
+      reinterpret_cast<unsigned char const *>("localhost"), -1, -1, 0);
+  X509_set_issuer_name(certificate.get(), name);
+  if (X509_sign(certificate.get(), key.get(), EVP_sha256()) == 0) {
+    return false;
+  }
+
+  auto *native_ctx = ssl_ctx.native_handle();
+  return SSL_CTX_use_certificate(native_ctx, certificate.get()) == 1 &&
+         SSL_CTX_use_PrivateKey(native_ctx, key.get()) == 1;
+}
+
+} // namespace mock
+} // namespace binance
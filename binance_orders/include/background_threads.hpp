@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/frame_log.hpp"
 #include "user_data_stream.hpp"
 
 namespace binance {
@@ -15,6 +16,20 @@ void websock_launcher(std::vector<std::shared_ptr<user_data_stream_t>> &,
 
 void persistent_orders_saver(net::io_context &, ssl::context &);
 
+struct replay_summary_t {
+  std::size_t frames{};
+  std::size_t orders{};
+  std::size_t balances{};
+  std::size_t account_updates{};
+};
+
+// feeds the recorded user data frames through the usual processing, see
+// frame_replayer_t::replay for `speed`. The results are only counted: nothing
+// is sent to Telegram or written to the database.
+replay_summary_t replay_recorded_frames(frame_replayer_t const &replayer,
+                                        double const speed, net::io_context &,
+                                        ssl::context &ssl_context);
+
 void monitor_database_host_table_changes();
 
 std::string get_alphanum_tablename(std::string);
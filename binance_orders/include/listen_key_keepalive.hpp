@@ -9,6 +9,8 @@
 #include <boost/beast/ssl.hpp>
 #include <optional>
 
+#include "common/exchange_endpoints.hpp"
+
 namespace binance {
 
 namespace net = boost::asio;
@@ -25,10 +27,9 @@ class listen_key_keepalive_t {
 
   using resolver = ip::tcp::resolver;
 
-  static char const *const host_;
-
   net::io_context &io_context_;
   net::ssl::context &ssl_ctx_;
+  exchange_endpoints_t const endpoints_ = exchange_endpoints();
   std::optional<beast::flat_buffer> buffer_;
   std::optional<http::request<http::empty_body>> http_request_;
   std::optional<http::response<http::string_body>> http_response_;
@@ -1,7 +1,10 @@
 #pragma once
 
-#include <string>
+#include "common/decimal.hpp"
+#include "common/json_utils.hpp"
+
 #include <map>
+#include <string>
 
 namespace binance {
 
@@ -10,17 +13,17 @@ struct ws_order_info_t {
   std::string order_side{};
   std::string order_type{};
   std::string time_in_force{};
-  std::string quantity_purchased{};
-  std::string order_price{};
-  std::string stop_price{};
+  decimal_t quantity_purchased{};
+  decimal_t order_price{};
+  decimal_t stop_price{};
   std::string execution_type{};
   std::string order_status{};
   std::string reject_reason{};
   std::string order_id{};
-  std::string last_filled_quantity{};
-  std::string cummulative_filled_quantity{};
-  std::string last_executed_price{};
-  std::string commission_amount{};
+  decimal_t last_filled_quantity{};
+  decimal_t cummulative_filled_quantity{};
+  decimal_t last_executed_price{};
+  decimal_t commission_amount{};
   std::string commission_asset{};
   std::string trade_id{};
 
@@ -34,7 +37,7 @@ struct ws_order_info_t {
 
 struct ws_balance_info_t {
   std::string instrument_id{};
-  std::string balance{};
+  decimal_t balance{};
   std::string event_time{};
   std::string clear_time{};
   std::string for_aliased_account{};
@@ -43,8 +46,8 @@ struct ws_balance_info_t {
 
 struct ws_account_update_t {
   std::string instrument_id{};
-  std::string free_amount{};
-  std::string locked_amount{};
+  decimal_t free_amount{};
+  decimal_t locked_amount{};
 
   std::string event_time{};
   std::string last_account_update{};
@@ -59,4 +62,9 @@ struct tg_chat_id_t {
 };
 
 using tg_ccached_map_t = std::map<chat_name_t, tg_chat_id_t>;
+
+// formats a timestamp in milliseconds into `result`, left as is on failure
+void process_timet(std::string &result, std::size_t const time_t_value_ms);
+// the fields of an executionReport, without the account it belongs to
+ws_order_info_t decode_execution_report(json::object_t const &);
 } // namespace binance
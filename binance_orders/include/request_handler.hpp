@@ -1,6 +1,8 @@
 #pragma once
 
 #include "common/containers.hpp"
+#include "common/frame_log.hpp"
+#include "common/metrics_registry.hpp"
 #include "host_info.hpp"
 #include "orders_info.hpp"
 #include <variant>
@@ -11,11 +13,24 @@ using user_stream_result_t =
 
 class request_handler_t {
   static waitable_container_t<host_info_t> host_container_;
-  static waitable_container_t<user_stream_result_t> user_stream_container_;
+  static mpsc_ring_t<user_stream_result_t> user_stream_container_;
+  static std::unique_ptr<frame_recorder_t> frame_recorder_;
+  static metrics_registry_t metrics_;
 
 public:
   static auto &get_host_container() { return host_container_; }
   static auto &get_stream_container() { return user_stream_container_; }
+  static auto &get_metrics() { return metrics_; }
+  // exposes the depth of the containers above on /metrics
+  static void register_queue_metrics();
+  // nullptr unless the frames are being recorded
+  static frame_recorder_t *get_frame_recorder() {
+    return frame_recorder_.get();
+  }
+  // must be called before the streams are created
+  static void set_frame_recorder(std::unique_ptr<frame_recorder_t> recorder) {
+    frame_recorder_ = std::move(recorder);
+  }
 };
 
 } // namespace binance
@@ -15,6 +15,9 @@ struct command_line_interface_t {
   std::string ip_address{"127.0.0.1"};
   std::string launch_type{"development"};
   std::string database_config_filename{"../config/info.json"};
+  std::string record_directory{};
+  std::string replay_directory{};
+  double replay_speed{1.0};
 };
 
 } // namespace utilities
@@ -12,6 +12,8 @@
 #include <nlohmann/json.hpp>
 #include <optional>
 
+#include "common/http_router.hpp"
+
 namespace binance {
 
 namespace net = boost::asio;
@@ -19,35 +21,11 @@ namespace beast = boost::beast;
 namespace http = beast::http;
 
 using string_response_t = http::response<http::string_body>;
-using string_request_t = http::request<http::string_body>;
 using dynamic_request = http::request_parser<http::string_body>;
-using url_query_t = std::map<boost::string_view, boost::string_view>;
 using string_body_ptr =
     std::unique_ptr<http::request_parser<http::string_body>>;
 using nlohmann::json;
 
-using callback_t =
-    std::function<void(string_request_t const &, url_query_t const &)>;
-
-struct rule_t {
-  std::size_t num_verbs_{};
-  std::array<http::verb, 3> verbs_{};
-  callback_t route_callback_;
-
-  rule_t(std::initializer_list<http::verb> &&verbs, callback_t callback);
-};
-
-class endpoint_t {
-  std::map<std::string, rule_t> endpoints;
-  using rule_iterator = std::map<std::string, rule_t>::iterator;
-
-public:
-  void add_endpoint(std::string const &, std::initializer_list<http::verb>,
-                    callback_t &&);
-  std::optional<rule_iterator> get_rules(std::string const &target);
-  std::optional<rule_iterator> get_rules(boost::string_view const &target);
-};
-
 enum class error_type_e {
   NoError,
   ResourceNotFound,
@@ -70,6 +48,7 @@ class session_t {
   boost::string_view content_type_{};
   std::shared_ptr<void> resp_;
   endpoint_t endpoint_apis_;
+  bool counted_as_live_{true};
 
 private:
   void add_endpoint_interfaces();
@@ -77,6 +56,7 @@ private:
   void on_header_read(beast::error_code, std::size_t const);
   void on_data_read(beast::error_code ec, std::size_t const);
   void shutdown_socket();
+  void stop_counting_as_live();
   void send_response(string_response_t &&response);
   void error_handler(string_response_t &&response, bool close_socket = false);
   void on_data_written(beast::error_code ec, std::size_t const bytes_written);
@@ -85,6 +65,8 @@ private:
                       url_query_t const &optional_query);
   void index_page_handler(string_request_t const &request,
                           url_query_t const &optional_query);
+  void metrics_handler(string_request_t const &request,
+                       url_query_t const &optional_query);
 
 private:
   static string_response_t json_success(json const &body,
@@ -101,10 +83,10 @@ private:
                                         string_request_t const &);
   static string_response_t get_error(std::string const &, error_type_e,
                                      http::status, string_request_t const &);
-  static url_query_t split_optional_queries(boost::string_view const &args);
 
 public:
   session_t(net::io_context &io, net::ip::tcp::socket &&socket);
+  ~session_t();
   bool is_closed();
   void run();
 };
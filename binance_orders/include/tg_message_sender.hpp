@@ -6,6 +6,7 @@
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/string_body.hpp>
 #include <boost/beast/ssl/ssl_stream.hpp>
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <optional>
@@ -40,6 +41,7 @@ class tg_message_sender_t
   PostOpCallback error_callback_;
   PostOpCallback completion_callback_;
   bool operation_completed_ = false;
+  std::chrono::steady_clock::time_point request_sent_at_{};
   static char const *const tg_host_;
 
 private:
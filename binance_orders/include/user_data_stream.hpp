@@ -11,7 +11,9 @@
 #include <boost/beast/websocket/stream.hpp>
 #include <optional>
 
+#include "common/exchange_endpoints.hpp"
 #include "common/json_utils.hpp"
+#include "common/metrics_registry.hpp"
 #include "host_info.hpp"
 
 namespace binance {
@@ -32,12 +34,9 @@ class user_data_stream_t
   using inumber_t = json::number_integer_t;
   using fnumber_t = json::number_float_t;
 
-  static char const *const ws_host_;
-  static char const *const ws_port_number_;
-  static char const *const rest_api_host_;
-
   net::io_context &io_context_;
   net::ssl::context &ssl_ctx_;
+  exchange_endpoints_t const endpoints_ = exchange_endpoints();
   std::optional<net::ip::tcp::resolver> resolver_;
   std::optional<websock::stream<beast::ssl_stream<beast::tcp_stream>>>
       ssl_web_stream_;
@@ -51,7 +50,11 @@ class user_data_stream_t
   std::unique_ptr<listen_key_keepalive_t> listen_key_keepalive_;
   std::optional<std::string> listen_key_;
 
+  std::uint32_t recorded_stream_id_{};
   bool stopped_ = false;
+  // labelled with the account alias, see request_handler_t::get_metrics
+  metric_counter_t *events_counter_{nullptr};
+  metric_counter_t *reconnects_counter_{nullptr};
 
 private:
   void rest_api_initiate_connection();
@@ -69,7 +72,7 @@ private:
   void ws_perform_ssl_handshake(resolver::results_type::endpoint_type const &);
   void ws_upgrade_to_websocket();
   void ws_wait_for_messages();
-  void ws_interpret_generic_messages();
+  void ws_interpret_generic_messages(std::string_view const frame);
 
   void ws_process_orders_execution_report(json::object_t const &);
   void ws_process_balance_update(json::object_t const &);
@@ -89,6 +92,8 @@ public:
   host_info_t &host_info() { return *host_info_; }
   void run();
   void stop();
+  // processes a frame captured by the frame recorder as if it was received
+  void replay_frame(std::string_view const frame);
 };
 
 namespace utilities {
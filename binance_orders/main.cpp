@@ -1,10 +1,13 @@
 #include <CLI/CLI.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ssl/context.hpp>
+#include <chrono>
 #include <thread>
 
 #include "background_threads.hpp"
+#include "common/exchange_endpoints.hpp"
 #include "database_connector.hpp"
+#include "request_handler.hpp"
 #include "server.hpp"
 
 namespace net = boost::asio;
@@ -22,6 +25,25 @@ int main(int argc, char *argv[]) {
                         "Database config filename", true);
   cli_parser.add_option("-y", args.launch_type,
                         "Launch type(production, development)", true);
+  cli_parser.add_option("--record", args.record_directory,
+                        "directory the raw user data frames are captured to");
+  cli_parser.add_option("--replay", args.replay_directory,
+                        "replay the frames captured in this directory "
+                        "instead of connecting to Binance");
+  cli_parser.add_option("--replay-speed", args.replay_speed,
+                        "1 replays at the recorded pace, N N times faster, 0 "
+                        "as fast as possible",
+                        true);
+  auto &endpoints = binance::exchange_endpoints();
+  cli_parser.add_option("--rest-host", endpoints.rest_api_host,
+                        "host of the REST API, e.g. a local binance_mock",
+                        true);
+  cli_parser.add_option("--rest-port", endpoints.rest_api_port,
+                        "port of the REST API", true);
+  cli_parser.add_option("--ws-host", endpoints.ws_host,
+                        "host of the websocket streams", true);
+  cli_parser.add_option("--ws-port", endpoints.ws_port,
+                        "port of the websocket streams", true);
   CLI11_PARSE(cli_parser, argc, argv);
 
   auto const software_config = binance::parse_config_file(
@@ -38,7 +60,9 @@ int main(int argc, char *argv[]) {
   database_connector->set_database_name(software_config->db_dns);
   BOT_TOKEN = software_config->bot_token;
 
-  if (!database_connector->connect()) {
+  bool const replaying = !args.replay_directory.empty();
+  // a replay runs offline, its results are never stored
+  if (!replaying && !database_connector->connect()) {
     return EXIT_FAILURE;
   }
 
@@ -49,6 +73,7 @@ int main(int argc, char *argv[]) {
   if (!(*server_instance)) {
     return EXIT_FAILURE;
   }
+  binance::request_handler_t::register_queue_metrics();
   server_instance->run();
 
   boost::asio::ssl::context ssl_context(
@@ -56,8 +81,33 @@ int main(int argc, char *argv[]) {
   ssl_context.set_default_verify_paths();
   ssl_context.set_verify_mode(boost::asio::ssl::verify_none);
 
+  if (!args.record_directory.empty()) {
+    auto recorder = std::make_unique<binance::frame_recorder_t>(
+        args.record_directory, "user_data");
+    if (!recorder->open()) {
+      return EXIT_FAILURE;
+    }
+    binance::request_handler_t::set_frame_recorder(std::move(recorder));
+  }
+
   std::vector<std::shared_ptr<binance::user_data_stream_t>> websocks{};
-  {
+  if (replaying) {
+    std::thread replayer_thread{[&] {
+      binance::frame_replayer_t replayer{args.replay_directory, "user_data"};
+      auto const started_at = std::chrono::steady_clock::now();
+      auto const summary = binance::replay_recorded_frames(
+          replayer, args.replay_speed, io_context, ssl_context);
+      auto const elapsed = std::chrono::steady_clock::now() - started_at;
+      spdlog::info("replayed {} frames in {} ms: {} orders, {} balance "
+                   "updates, {} account updates",
+                   summary.frames,
+                   std::chrono::duration_cast<std::chrono::milliseconds>(
+                       elapsed)
+                       .count(),
+                   summary.orders, summary.balances, summary.account_updates);
+    }};
+    replayer_thread.detach();
+  } else {
     std::thread websock_thread_handler{
         [&] { binance::websock_launcher(websocks, io_context, ssl_context); }};
     websock_thread_handler.detach();
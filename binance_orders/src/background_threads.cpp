@@ -69,6 +69,51 @@ void websock_launcher(
   }
 }
 
+replay_summary_t replay_recorded_frames(frame_replayer_t const &replayer,
+                                        double const speed,
+                                        net::io_context &io_context,
+                                        ssl::context &ssl_context) {
+  // the streams were recorded under their account alias; nothing else of the
+  // host is needed as the results never leave the process
+  std::vector<std::shared_ptr<user_data_stream_t>> streams{};
+  auto &stream_container = request_handler_t::get_stream_container();
+  std::vector<user_stream_result_t> items{};
+  replay_summary_t summary{};
+
+  auto on_stream = [&](std::uint32_t const stream_id,
+                       std::string_view const account_alias) {
+    if (stream_id >= streams.size()) {
+      streams.resize(stream_id + 1);
+    }
+    host_info_t host{};
+    host.account_alias = std::string(account_alias);
+    streams[stream_id] = std::make_shared<user_data_stream_t>(
+        io_context, ssl_context, std::move(host));
+  };
+  auto on_frame = [&](std::uint32_t const stream_id, std::uint64_t const,
+                      std::string_view const frame) {
+    if (stream_id >= streams.size() || !streams[stream_id]) {
+      return;
+    }
+    // a frame yields a handful of results at most, so draining after each
+    // one keeps the ring from ever filling up
+    streams[stream_id]->replay_frame(frame);
+    items.clear();
+    stream_container.try_drain_up_to(items, stream_container.capacity());
+    for (auto const &item : items) {
+      if (std::holds_alternative<ws_order_info_t>(item)) {
+        ++summary.orders;
+      } else if (std::holds_alternative<ws_balance_info_t>(item)) {
+        ++summary.balances;
+      } else {
+        ++summary.account_updates;
+      }
+    }
+  };
+  summary.frames = replayer.replay(speed, on_stream, on_frame);
+  return summary;
+}
+
 void persistent_orders_saver(net::io_context &io_context,
                              ssl::context &ssl_context) {
   auto &stream_container = request_handler_t::get_stream_container();
@@ -79,38 +124,58 @@ void persistent_orders_saver(net::io_context &io_context,
   std::vector<std::shared_ptr<tg_message_sender_t>> message_senders{};
   tg_get_new_updates(chats_id_map, ssl_context);
 
+  auto &metrics = request_handler_t::get_metrics();
+  char const *const insert_latency_name = "binance_orders_db_insert_seconds";
+  char const *const insert_latency_help = "time taken by database inserts";
+  auto &order_insert_latency = metrics.histogram(
+      insert_latency_name, insert_latency_help, {{"table", "orders"}});
+  auto &balance_insert_latency = metrics.histogram(
+      insert_latency_name, insert_latency_help, {{"table", "balance"}});
+
+  std::size_t const max_batch_size = 64;
+  std::vector<user_stream_result_t> items{};
+  items.reserve(max_batch_size);
+
   while (true) {
-    auto item_var = stream_container.get();
-
-    std::visit(
-        [&](auto &&item) {
-          // first send the telegram message
-          auto payload = prepare_telegram_payload(item);
-          send_telegram_message(message_senders, std::move(payload),
-                                item.telegram_group, chats_id_map, io_context,
-                                ssl_context);
-          // then save it locally in the DB
-          auto &table_alias = account_table_map[item.for_aliased_account];
-          if (table_alias.empty()) {
-            table_alias = get_alphanum_tablename(item.for_aliased_account);
-            auto const orders_tablename = table_alias + "_orders";
-            auto const balance_tablename = table_alias + "_balance";
-            // auto const acct_update_tablename = table_alias + "_account";
-            database_connector->create_order_table(orders_tablename);
-            database_connector->create_balance_table(balance_tablename);
-          }
-
-          using item_type = std::decay_t<decltype(item)>;
-          if constexpr (std::is_same_v<item_type, ws_order_info_t>) {
-            auto const table_name = table_alias + "_orders";
-            database_connector->add_new_order(table_name, item);
-          } else if constexpr (std::is_same_v<item_type, ws_balance_info_t>) {
-            auto const table_name = table_alias + "_balance";
-            database_connector->add_new_balance(table_name, item);
-          } else {
-          }
-        },
-        item_var);
+    items.clear();
+    stream_container.drain_up_to(items, max_batch_size);
+
+    for (auto &item_var : items) {
+      std::visit(
+          [&](auto &&item) {
+            // first send the telegram message
+            auto payload = prepare_telegram_payload(item);
+            send_telegram_message(message_senders, std::move(payload),
+                                  item.telegram_group, chats_id_map,
+                                  io_context, ssl_context);
+            // then save it locally in the DB
+            auto &table_alias = account_table_map[item.for_aliased_account];
+            if (table_alias.empty()) {
+              table_alias = get_alphanum_tablename(item.for_aliased_account);
+              auto const orders_tablename = table_alias + "_orders";
+              auto const balance_tablename = table_alias + "_balance";
+              // auto const acct_update_tablename = table_alias + "_account";
+              database_connector->create_order_table(orders_tablename);
+              database_connector->create_balance_table(balance_tablename);
+            }
+
+            using item_type = std::decay_t<decltype(item)>;
+            if constexpr (std::is_same_v<item_type, ws_order_info_t>) {
+              auto const table_name = table_alias + "_orders";
+              auto const started_at = std::chrono::steady_clock::now();
+              database_connector->add_new_order(table_name, item);
+              record_elapsed(order_insert_latency, started_at);
+            } else if constexpr (std::is_same_v<item_type,
+                                                ws_balance_info_t>) {
+              auto const table_name = table_alias + "_balance";
+              auto const started_at = std::chrono::steady_clock::now();
+              database_connector->add_new_balance(table_name, item);
+              record_elapsed(balance_insert_latency, started_at);
+            } else {
+            }
+          },
+          item_var);
+    }
   }
 }
 
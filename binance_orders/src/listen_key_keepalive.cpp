@@ -8,7 +8,6 @@ namespace binance {
 
 using namespace fmt::v7::literals;
 
-char const *const listen_key_keepalive_t::host_ = "api.binance.com";
 
 listen_key_keepalive_t::listen_key_keepalive_t(net::io_context &io_context,
                                                net::ssl::context &ssl_context,
@@ -24,7 +23,7 @@ void listen_key_keepalive_t::resolve_name() {
 
   resolver_.emplace(io_context_);
   resolver_->async_resolve(
-      host_, "https",
+      endpoints_.rest_api_host, endpoints_.rest_api_port,
       [this](auto const error_code, resolver::results_type const &results) {
         if (error_code) {
           return spdlog::error(error_code.message());
@@ -51,7 +50,8 @@ void listen_key_keepalive_t::connect_to_names(
 
 void listen_key_keepalive_t::perform_ssl_connection(
     resolver::results_type::endpoint_type const &connected_name) {
-  auto const host = "{}:{}"_format(host_, connected_name.port());
+  auto const host =
+      "{}:{}"_format(endpoints_.rest_api_host, connected_name.port());
 
   // Set a timeout on the operation
   beast::get_lowest_layer(*ssl_stream_).expires_after(std::chrono::seconds(30));
@@ -84,7 +84,7 @@ void listen_key_keepalive_t::prepare_request() {
   request.method(verb::put);
   request.version(11);
   request.target("/api/v3/userDataStream?listenKey=" + listen_key_);
-  request.set(field::host, host_);
+  request.set(field::host, endpoints_.rest_api_host);
   request.set(field::user_agent, "PostmanRuntime/7.28.1");
   request.set(field::accept, "*/*");
   request.set(field::accept_language, "en-US,en;q=0.5 --compressed");
@@ -0,0 +1,65 @@
+#include "orders_info.hpp"
+
+namespace binance {
+
+namespace {
+using string_t = json::string_t;
+using inumber_t = json::number_integer_t;
+using fnumber_t = json::number_float_t;
+} // namespace
+
+void process_timet(std::string &result, std::size_t const time_t_value_ms) {
+  std::size_t const time_t_value = time_t_value_ms / 1'000;
+  if (auto opt_event_time = utilities::timet_to_string(time_t_value);
+      opt_event_time.has_value()) {
+    result = std::move(*opt_event_time);
+  }
+}
+
+// https://binance-docs.github.io/apidocs/spot/en/#payload-order-update
+ws_order_info_t decode_execution_report(json::object_t const &order_object) {
+  using utilities::get_value;
+
+  ws_order_info_t order_info{};
+  order_info.instrument_id = get_value<string_t>(order_object, "s");
+  order_info.order_side = get_value<string_t>(order_object, "S");
+  order_info.order_type = get_value<string_t>(order_object, "o");
+  order_info.time_in_force = get_value<string_t>(order_object, "f");
+  order_info.quantity_purchased = get_value<decimal_t>(order_object, "q");
+  order_info.order_price = get_value<decimal_t>(order_object, "p");
+  order_info.stop_price = get_value<decimal_t>(order_object, "P");
+  order_info.execution_type = get_value<string_t>(order_object, "x");
+  order_info.order_status = get_value<string_t>(order_object, "X");
+  order_info.reject_reason = get_value<string_t>(order_object, "r");
+  order_info.last_filled_quantity = get_value<decimal_t>(order_object, "l");
+  order_info.commission_amount = get_value<decimal_t>(order_object, "n");
+  order_info.last_executed_price = get_value<decimal_t>(order_object, "L");
+  order_info.cummulative_filled_quantity =
+      get_value<decimal_t>(order_object, "z");
+
+  order_info.order_id = std::to_string(get_value<inumber_t>(order_object, "i"));
+  order_info.trade_id = std::to_string(get_value<inumber_t>(order_object, "t"));
+
+  if (auto const commission_asset_iter = order_object.find("N");
+      commission_asset_iter != order_object.cend()) {
+
+    auto json_commission_asset = commission_asset_iter->second;
+    // documentation doesn't specify the type of this data but
+    // my best guess is that this type is most likely a string
+    if (json_commission_asset.is_string()) {
+      order_info.commission_asset = json_commission_asset.get<string_t>();
+    } else if (json_commission_asset.is_number()) {
+      order_info.commission_asset =
+          std::to_string(json_commission_asset.get<fnumber_t>());
+    }
+  }
+
+  process_timet(order_info.event_time, get_value<inumber_t>(order_object, "E"));
+  process_timet(order_info.transaction_time,
+                get_value<inumber_t>(order_object, "T"));
+  process_timet(order_info.created_time,
+                get_value<inumber_t>(order_object, "O"));
+  return order_info;
+}
+
+} // namespace binance
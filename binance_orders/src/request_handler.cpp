@@ -4,7 +4,24 @@ namespace binance {
 
 waitable_container_t<host_info_t> request_handler_t::host_container_{};
 
-waitable_container_t<user_stream_result_t>
-    request_handler_t::user_stream_container_{};
+mpsc_ring_t<user_stream_result_t> request_handler_t::user_stream_container_{
+    4'096};
+
+std::unique_ptr<frame_recorder_t> request_handler_t::frame_recorder_{};
+
+metrics_registry_t request_handler_t::metrics_{};
+
+void request_handler_t::register_queue_metrics() {
+  char const *const name = "binance_orders_queue_depth";
+  char const *const help = "items waiting in a queue between two threads";
+  metrics_.gauge(
+      name, help,
+      [] { return static_cast<double>(host_container_.size()); },
+      {{"queue", "hosts"}});
+  metrics_.gauge(
+      name, help,
+      [] { return static_cast<double>(user_stream_container_.size()); },
+      {{"queue", "user_stream"}});
+}
 
 } // namespace binance
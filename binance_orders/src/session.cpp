@@ -12,6 +12,14 @@ using namespace fmt::v7::literals;
 
 enum constant_e { RequestBodySize = 1'024 * 1'024 * 50 };
 
+namespace {
+metric_gauge_t &live_sessions() {
+  static auto &gauge = request_handler_t::get_metrics().gauge(
+      "binance_orders_http_sessions", "open connections to the web server");
+  return gauge;
+}
+} // namespace
+
 std::string get_alphanum_tablename(std::string str) {
   static auto non_alphanum_remover = [](char const ch) {
     return !std::isalnum(ch);
@@ -22,42 +30,19 @@ std::string get_alphanum_tablename(std::string str) {
   return str;
 }
 
-rule_t::rule_t(std::initializer_list<http::verb> &&verbs, callback_t callback)
-    : num_verbs_{verbs.size()}, route_callback_{std::move(callback)} {
-  if (verbs.size() > 3) {
-    throw std::runtime_error{"maximum number of verbs is 5"};
-  }
-  for (int i = 0; i != verbs.size(); ++i) {
-    verbs_[i] = *(verbs.begin() + i);
-  }
+session_t::session_t(net::io_context &io, net::ip::tcp::socket &&socket)
+    : io_context_{io}, tcp_stream_{std::move(socket)} {
+  live_sessions().add(1);
+  add_endpoint_interfaces();
 }
 
-void endpoint_t::add_endpoint(std::string const &route,
-                              std::initializer_list<http::verb> verbs,
-                              callback_t &&callback) {
-  if (route.empty() || route[0] != '/') {
-    throw std::runtime_error{"A valid route starts with a /"};
-  }
-  endpoints.emplace(route, rule_t{std::move(verbs), std::move(callback)});
-}
+session_t::~session_t() { stop_counting_as_live(); }
 
-std::optional<endpoint_t::rule_iterator>
-endpoint_t::get_rules(std::string const &target) {
-  auto iter = endpoints.find(target);
-  if (iter == endpoints.end()) {
-    return std::nullopt;
+void session_t::stop_counting_as_live() {
+  if (counted_as_live_) {
+    counted_as_live_ = false;
+    live_sessions().add(-1);
   }
-  return iter;
-}
-
-std::optional<endpoint_t::rule_iterator>
-endpoint_t::get_rules(boost::string_view const &target) {
-  return get_rules(target.to_string());
-}
-
-session_t::session_t(net::io_context &io, net::ip::tcp::socket &&socket)
-    : io_context_{io}, tcp_stream_{std::move(socket)} {
-  add_endpoint_interfaces();
 }
 
 void session_t::add_endpoint_interfaces() {
@@ -73,6 +58,11 @@ void session_t::add_endpoint_interfaces() {
                               [=](auto const &request, auto const &query) {
                                 upload_handler(request, query);
                               });
+
+  endpoint_apis_.add_endpoint("/metrics", {verb::get},
+                              [=](auto const &request, auto const &query) {
+                                metrics_handler(request, query);
+                              });
 }
 
 void session_t::run() { http_read_data(); }
@@ -124,7 +114,7 @@ void session_t::handle_requests(string_request_t const &request) {
       return error_handler(method_not_allowed(request));
     }
     boost::string_view const query_string = split.size() > 1 ? split[1] : "";
-    auto url_query_{split_optional_queries(query_string)};
+    auto url_query_{utilities::split_url_query(query_string)};
     return iter.value()->second.route_callback_(request, url_query_);
   } else {
     return error_handler(not_found(request));
@@ -159,6 +149,7 @@ void session_t::shutdown_socket() {
   ec = {};
   beast::get_lowest_layer(tcp_stream_).socket().close(ec);
   beast::get_lowest_layer(tcp_stream_).close();
+  stop_counting_as_live();
 }
 
 void session_t::error_handler(string_response_t &&response, bool close_socket) {
@@ -190,6 +181,17 @@ void session_t::index_page_handler(string_request_t const &request,
       get_error("login", error_type_e::NoError, http::status::ok, request));
 }
 
+// scraped by Prometheus
+void session_t::metrics_handler(string_request_t const &request,
+                                url_query_t const &) {
+  string_response_t response{http::status::ok, request.version()};
+  response.set(http::field::content_type, "text/plain; version=0.0.4");
+  response.keep_alive(request.keep_alive());
+  response.body() = request_handler_t::get_metrics().serialize();
+  response.prepare_payload();
+  return send_response(std::move(response));
+}
+
 void session_t::upload_handler(string_request_t const &request,
                                url_query_t const &) {
   auto &body = request.body();
@@ -308,80 +310,4 @@ void session_t::send_response(string_response_t &&response) {
                     });
 }
 
-url_query_t
-session_t::split_optional_queries(boost::string_view const &optional_query) {
-  url_query_t result{};
-  if (!optional_query.empty()) {
-    auto queries = utilities::split_string_view(optional_query, "&");
-    for (auto const &q : queries) {
-      auto split = utilities::split_string_view(q, "=");
-      if (split.size() < 2) {
-        continue;
-      }
-      result.emplace(split[0], split[1]);
-    }
-  }
-  return result;
-}
-
-namespace utilities {
-std::string decode_url(boost::string_view const &encoded_string) {
-  std::string src{};
-  for (size_t i = 0; i < encoded_string.size();) {
-    char const ch = encoded_string[i];
-    if (ch != '%') {
-      src.push_back(ch);
-      ++i;
-    } else {
-      char c1 = encoded_string[i + 1];
-      unsigned int localui1 = 0L;
-      if ('0' <= c1 && c1 <= '9') {
-        localui1 = c1 - '0';
-      } else if ('A' <= c1 && c1 <= 'F') {
-        localui1 = c1 - 'A' + 10;
-      } else if ('a' <= c1 && c1 <= 'f') {
-        localui1 = c1 - 'a' + 10;
-      }
-
-      char c2 = encoded_string[i + 2];
-      unsigned int localui2 = 0L;
-      if ('0' <= c2 && c2 <= '9') {
-        localui2 = c2 - '0';
-      } else if ('A' <= c2 && c2 <= 'F') {
-        localui2 = c2 - 'A' + 10;
-      } else if ('a' <= c2 && c2 <= 'f') {
-        localui2 = c2 - 'a' + 10;
-      }
-
-      unsigned int ui = localui1 * 16 + localui2;
-      src.push_back(ui);
-
-      i += 3;
-    }
-  }
-
-  return src;
-}
-
-std::vector<boost::string_view> split_string_view(boost::string_view const &str,
-                                                  char const *delim) {
-  std::size_t const delim_length = std::strlen(delim);
-  std::size_t from_pos{};
-  std::size_t index{str.find(delim, from_pos)};
-  if (index == std::string::npos) {
-    return {str};
-  }
-  std::vector<boost::string_view> result{};
-  while (index != std::string::npos) {
-    result.emplace_back(str.data() + from_pos, index - from_pos);
-    from_pos = index + delim_length;
-    index = str.find(delim, from_pos);
-  }
-  if (from_pos < str.length()) {
-    result.emplace_back(str.data() + from_pos, str.size() - from_pos);
-  }
-  return result;
-}
-
-} // namespace utilities
 } // namespace binance
@@ -0,0 +1,56 @@
+#include "telegram_process.hpp"
+#include <boost/algorithm/string/replace.hpp>
+
+namespace binance {
+
+std::string prepare_telegram_payload(ws_order_info_t const &order) {
+  // %0A is defined as the newline character.
+  // %20 is defined as the space character.
+
+  std::string payload = "Exchange: Binance%0A";
+  payload += ("OrderID: " + order.order_id + "%0A");
+  payload += ("Token: " + order.instrument_id + "%0A");
+  payload += ("Price: " + to_string(order.order_price) + "%0A");
+  payload += ("Qty: " + to_string(order.quantity_purchased) + "%0A");
+  payload +=
+      ("LastFilled: " + to_string(order.last_filled_quantity) + "%0A");
+  payload += ("Side: " + order.order_side + "%0A");
+  payload += ("Type: " + order.order_type + "%0A");
+  if (!order.commission_asset.empty()) {
+    payload += ("Fee: " + to_string(order.commission_amount) + " ( " +
+                order.commission_asset + " )%0A");
+  }
+  payload += ("ExeType: " + order.execution_type + "%0A");
+  payload += ("State: " + order.order_status + "%0A");
+  payload += ("CreatedTime: " + order.created_time + "%0A");
+  payload += ("TransactionTime: " + order.transaction_time + "%0A");
+
+  boost::replace_all(payload, " ", "%20");
+  return payload;
+}
+
+std::string prepare_telegram_payload(ws_balance_info_t const &balance) {
+  std::string payload = "Exchange: Binance%0A";
+  payload += ("Type: BalanceUpdate%0A");
+  payload += ("Token: " + balance.instrument_id + "%0A");
+  payload += ("Time: " + balance.clear_time + "%0A");
+  payload += ("Balance: " + to_string(balance.balance) + "%0A");
+  boost::replace_all(payload, " ", "%20");
+
+  return payload;
+}
+
+std::string prepare_telegram_payload(ws_account_update_t const &account) {
+  std::string payload = "Exchange: Binance%0A";
+  payload += ("Type: AccountUpdate%0A");
+  payload += ("Token: " + account.instrument_id + "%0A");
+  payload += ("Free: " + to_string(account.free_amount) + "%0A");
+  payload += ("Locked: " + to_string(account.locked_amount) + "%0A");
+  payload += ("EventTime: " + account.event_time + "%0A");
+  payload += ("LastUpdateTime: " + account.last_account_update + "%0A");
+
+  boost::replace_all(payload, " ", "%20");
+  return payload;
+}
+
+} // namespace binance
@@ -2,7 +2,7 @@
 #include "chat_update.hpp"
 #include "common/json_utils.hpp"
 #include "database_connector.hpp"
-#include <boost/algorithm/string/replace.hpp>
+#include "request_handler.hpp"
 #include <spdlog/spdlog.h>
 
 namespace binance {
@@ -63,60 +63,26 @@ void tg_get_new_updates(tg_ccached_map_t &chat_ids, ssl::context &ssl_context) {
   io_context.run();
 }
 
-std::string prepare_telegram_payload(ws_order_info_t const &order) {
-  // %0A is defined as the newline character.
-  // %20 is defined as the space character.
-
-  std::string payload = "Exchange: Binance%0A";
-  payload += ("OrderID: " + order.order_id + "%0A");
-  payload += ("Token: " + order.instrument_id + "%0A");
-  payload += ("Price: " + order.order_price + "%0A");
-  payload += ("Qty: " + order.quantity_purchased + "%0A");
-  payload += ("LastFilled: " + order.last_filled_quantity + "%0A");
-  payload += ("Side: " + order.order_side + "%0A");
-  payload += ("Type: " + order.order_type + "%0A");
-  if (!order.commission_asset.empty()) {
-    payload += ("Fee: " + order.commission_amount + " ( " +
-                order.commission_asset + " )%0A");
-  }
-  payload += ("ExeType: " + order.execution_type + "%0A");
-  payload += ("State: " + order.order_status + "%0A");
-  payload += ("CreatedTime: " + order.created_time + "%0A");
-  payload += ("TransactionTime: " + order.transaction_time + "%0A");
-
-  boost::replace_all(payload, " ", "%20");
-  return payload;
-}
-
-std::string prepare_telegram_payload(ws_balance_info_t const &balance) {
-  std::string payload = "Exchange: Binance%0A";
-  payload += ("Type: BalanceUpdate%0A");
-  payload += ("Token: " + balance.instrument_id + "%0A");
-  payload += ("Time: " + balance.clear_time + "%0A");
-  payload += ("Balance: " + balance.balance + "%0A");
-  boost::replace_all(payload, " ", "%20");
-
-  return payload;
-}
-
-std::string prepare_telegram_payload(ws_account_update_t const &account) {
-  std::string payload = "Exchange: Binance%0A";
-  payload += ("Type: AccountUpdate%0A");
-  payload += ("Token: " + account.instrument_id + "%0A");
-  payload += ("Free: " + account.free_amount + "%0A");
-  payload += ("Locked: " + account.locked_amount + "%0A");
-  payload += ("EventTime: " + account.event_time + "%0A");
-  payload += ("LastUpdateTime: " + account.last_account_update + "%0A");
-
-  boost::replace_all(payload, " ", "%20");
-  return payload;
+namespace {
+metric_counter_t &telegram_failures() {
+  static auto &counter = request_handler_t::get_metrics().counter(
+      "binance_orders_telegram_send_failures_total",
+      "telegram messages that could not be sent or were refused");
+  return counter;
 }
+} // namespace
 
 void telegram_delivery_failed(std::string const &error_message) {
+  telegram_failures().increment();
   spdlog::error(error_message);
 }
 
-void telegram_delivery_successful(std::string const &) {}
+void telegram_delivery_successful(std::string const &response) {
+  // the bot API answers {"ok":false,...} when it refuses a message
+  if (response.find(R"("ok":true)") == std::string::npos) {
+    telegram_failures().increment();
+  }
+}
 
 void send_telegram_message(
     std::vector<std::shared_ptr<tg_message_sender_t>> &message_senders,
@@ -1,4 +1,5 @@
 #include "tg_message_sender.hpp"
+#include "request_handler.hpp"
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/write.hpp>
 
@@ -8,6 +9,15 @@ namespace binance {
 
 char const *const tg_message_sender_t::tg_host_ = "api.telegram.org";
 
+namespace {
+latency_histogram_t &send_latency() {
+  static auto &histogram = request_handler_t::get_metrics().histogram(
+      "binance_orders_telegram_send_seconds",
+      "time from sending a telegram message to the bot API's answer");
+  return histogram;
+}
+} // namespace
+
 bool tg_message_sender_t::available_with_less_tasks() const {
   return !operation_completed_ && payloads_.size() < 20;
 }
@@ -97,6 +107,7 @@ void tg_message_sender_t::prepare_payload() {
 
 void tg_message_sender_t::send_request() {
   prepare_payload();
+  request_sent_at_ = std::chrono::steady_clock::now();
   beast::get_lowest_layer(*ssl_web_stream_)
       .expires_after(std::chrono::seconds(30));
 
@@ -126,6 +137,7 @@ void tg_message_sender_t::receive_data() {
           return self->reestablish_connection();
         }
         self->http_request_.reset();
+        record_elapsed(send_latency(), self->request_sent_at_);
         self->completion_callback_(self->http_response_->body());
         self->http_response_.reset();
         return self->send_next_request();
@@ -11,17 +11,25 @@ namespace binance {
 
 using namespace fmt::v7::literals;
 
-char const *const user_data_stream_t::rest_api_host_ = "api.binance.com";
-char const *const user_data_stream_t::ws_host_ = "stream.binance.com";
-char const *const user_data_stream_t::ws_port_number_ = "9443";
-
-using namespace fmt::v7::literals;
 
 user_data_stream_t::user_data_stream_t(net::io_context &io_context,
                                        net::ssl::context &ssl_ctx,
                                        host_info_t &&host_info)
     : io_context_{io_context}, ssl_ctx_{ssl_ctx},
-      ssl_web_stream_{}, resolver_{}, host_info_{std::move(host_info)} {}
+      ssl_web_stream_{}, resolver_{}, host_info_{std::move(host_info)} {
+  if (auto recorder = request_handler_t::get_frame_recorder();
+      recorder != nullptr) {
+    recorded_stream_id_ = recorder->add_stream(host_info_->account_alias);
+  }
+  auto &metrics = request_handler_t::get_metrics();
+  metric_labels_t const labels{{"account", host_info_->account_alias}};
+  events_counter_ = &metrics.counter("binance_orders_user_data_events_total",
+                                     "events received on user data streams",
+                                     labels);
+  reconnects_counter_ = &metrics.counter(
+      "binance_orders_websocket_reconnects_total",
+      "user data streams re-established after a failure", labels);
+}
 
 user_data_stream_t::~user_data_stream_t() {
   if (ssl_web_stream_.has_value()) {
@@ -56,7 +64,7 @@ void user_data_stream_t::rest_api_initiate_connection() {
   resolver_.emplace(io_context_);
 
   resolver_->async_resolve(
-      rest_api_host_, "https",
+      endpoints_.rest_api_host, endpoints_.rest_api_port,
       [self = shared_from_this()](auto const error_code,
                                   resolver::results_type const &results) {
         if (error_code) {
@@ -86,7 +94,7 @@ void user_data_stream_t::rest_api_connect_to(
 
 void user_data_stream_t::rest_api_perform_ssl_connection(
     resolver::results_type::endpoint_type const &ip) {
-  auto const host = "{}:{}"_format(rest_api_host_, ip.port());
+  auto const host = "{}:{}"_format(endpoints_.rest_api_host, ip.port());
 
   // Set a timeout on the operation
   beast::get_lowest_layer(*ssl_web_stream_)
@@ -122,7 +130,7 @@ void user_data_stream_t::rest_api_prepare_request() {
   request.method(verb::post);
   request.version(11);
   request.target("/api/v3/userDataStream");
-  request.set(field::host, rest_api_host_);
+  request.set(field::host, endpoints_.rest_api_host);
   request.set(field::user_agent, "PostmanRuntime/7.28.1");
   request.set(field::accept, "*/*");
   request.set(field::accept_language, "en-US,en;q=0.5 --compressed");
@@ -191,7 +199,7 @@ void user_data_stream_t::ws_initiate_connection() {
   resolver_.emplace(io_context_);
 
   resolver_->async_resolve(
-      ws_host_, ws_port_number_,
+      endpoints_.ws_host, endpoints_.ws_port,
       [self = shared_from_this()](
           auto const error_code,
           net::ip::tcp::resolver::results_type const &results) {
@@ -225,7 +233,7 @@ void user_data_stream_t::ws_connect_to_names(
 
 void user_data_stream_t::ws_perform_ssl_handshake(
     net::ip::tcp::resolver::results_type::endpoint_type const &ep) {
-  auto const host = ws_host_ + ':' + std::to_string(ep.port());
+  auto const host = endpoints_.ws_host + ':' + std::to_string(ep.port());
 
   // Set a timeout on the operation
   beast::get_lowest_layer(*ssl_web_stream_)
@@ -275,7 +283,7 @@ void user_data_stream_t::ws_upgrade_to_websocket() {
       });
 
   ssl_web_stream_->async_handshake(
-      ws_host_, binance_handshake_path,
+      endpoints_.ws_host, binance_handshake_path,
       [self = shared_from_this()](beast::error_code const ec) {
         if (ec) {
           return spdlog::error(ec.message());
@@ -297,18 +305,30 @@ void user_data_stream_t::ws_wait_for_messages() {
           spdlog::error(error_code.message());
           return self->on_ws_connection_severed();
         }
-        self->ws_interpret_generic_messages();
+
+        auto const &buffer = *self->buffer_;
+        std::string_view const frame(
+            static_cast<char const *>(buffer.cdata().data()), buffer.size());
+        if (auto recorder = request_handler_t::get_frame_recorder();
+            recorder != nullptr) {
+          recorder->record(self->recorded_stream_id_, frame);
+        }
+        self->ws_interpret_generic_messages(frame);
+        self->ws_wait_for_messages();
       });
 }
 
-void user_data_stream_t::ws_interpret_generic_messages() {
-  char const *buffer_cstr = static_cast<char const *>(buffer_->cdata().data());
-  std::string_view const buffer(buffer_cstr, buffer_->size());
+void user_data_stream_t::replay_frame(std::string_view const frame) {
+  ws_interpret_generic_messages(frame);
+}
 
+void user_data_stream_t::ws_interpret_generic_messages(
+    std::string_view const buffer) {
   try {
     json::object_t const root = json::parse(buffer).get<json::object_t>();
     if (auto const event_iter = root.find("e"); event_iter != root.cend()) {
       auto const event_type = event_iter->second.get<json::string_t>();
+      events_counter_->increment();
 
       // only three events are expected
       if (event_type == "executionReport") {
@@ -322,8 +342,6 @@ void user_data_stream_t::ws_interpret_generic_messages() {
   } catch (std::exception const &e) {
     spdlog::error(e.what());
   }
-
-  return ws_wait_for_messages();
 }
 
 void user_data_stream_t::on_periodic_time_timeout() {
@@ -343,6 +361,7 @@ void user_data_stream_t::on_periodic_time_timeout() {
 }
 
 void user_data_stream_t::on_ws_connection_severed() {
+  reconnects_counter_->increment();
   if (ssl_web_stream_.has_value()) {
     ssl_web_stream_->close({});
     ssl_web_stream_.reset();
@@ -367,59 +386,10 @@ void user_data_stream_t::activate_listen_key_keepalive() {
   on_periodic_time_timeout();
 }
 
-void process_timet(std::string &result, std::size_t const time_t_value_ms) {
-  std::size_t const time_t_value = time_t_value_ms / 1'000;
-  if (auto opt_event_time = utilities::timet_to_string(time_t_value);
-      opt_event_time.has_value()) {
-    result = std::move(*opt_event_time);
-  }
-}
-
 // https://binance-docs.github.io/apidocs/spot/en/#payload-order-update
 void user_data_stream_t::ws_process_orders_execution_report(
     json::object_t const &order_object) {
-  using utilities::get_value;
-
-  ws_order_info_t order_info{};
-  order_info.instrument_id = get_value<string_t>(order_object, "s");
-  order_info.order_side = get_value<string_t>(order_object, "S");
-  order_info.order_type = get_value<string_t>(order_object, "o");
-  order_info.time_in_force = get_value<string_t>(order_object, "f");
-  order_info.quantity_purchased = get_value<string_t>(order_object, "q");
-  order_info.order_price = get_value<string_t>(order_object, "p");
-  order_info.stop_price = get_value<string_t>(order_object, "P");
-  order_info.execution_type = get_value<string_t>(order_object, "x");
-  order_info.order_status = get_value<string_t>(order_object, "X");
-  order_info.reject_reason = get_value<string_t>(order_object, "r");
-  order_info.last_filled_quantity = get_value<string_t>(order_object, "l");
-  order_info.commission_amount = get_value<string_t>(order_object, "n");
-  order_info.last_executed_price = get_value<string_t>(order_object, "L");
-  order_info.cummulative_filled_quantity =
-      get_value<string_t>(order_object, "z");
-
-  order_info.order_id = std::to_string(get_value<inumber_t>(order_object, "i"));
-  order_info.trade_id = std::to_string(get_value<inumber_t>(order_object, "t"));
-
-  if (auto const commission_asset_iter = order_object.find("N");
-      commission_asset_iter != order_object.cend()) {
-
-    auto json_commission_asset = commission_asset_iter->second;
-    // documentation doesn't specify the type of this data but
-    // my best guess is that this type is most likely a string
-    if (json_commission_asset.is_string()) {
-      order_info.commission_asset = json_commission_asset.get<string_t>();
-    } else if (json_commission_asset.is_number()) {
-      order_info.commission_asset =
-          std::to_string(json_commission_asset.get<fnumber_t>());
-    }
-  }
-
-  process_timet(order_info.event_time, get_value<inumber_t>(order_object, "E"));
-  process_timet(order_info.transaction_time,
-                get_value<inumber_t>(order_object, "T"));
-  process_timet(order_info.created_time,
-                get_value<inumber_t>(order_object, "O"));
-
+  auto order_info = decode_execution_report(order_object);
   order_info.for_aliased_account = host_info_->account_alias;
   order_info.telegram_group = host_info_->tg_group_name;
 
@@ -433,7 +403,7 @@ void user_data_stream_t::ws_process_balance_update(
   using utilities::get_value;
 
   ws_balance_info_t balance_data{};
-  balance_data.balance = get_value<string_t>(balance_object, "d");
+  balance_data.balance = get_value<decimal_t>(balance_object, "d");
   balance_data.instrument_id = get_value<string_t>(balance_object, "a");
 
   process_timet(balance_data.event_time,
@@ -470,8 +440,8 @@ void user_data_stream_t::ws_process_account_position(
   for (auto const &json_item : balances_array) {
     auto const asset_item = json_item.get<json::object_t>();
     data.instrument_id = get_value<string_t>(asset_item, "a");
-    data.free_amount = get_value<string_t>(asset_item, "f");
-    data.locked_amount = get_value<string_t>(asset_item, "l");
+    data.free_amount = get_value<decimal_t>(asset_item, "f");
+    data.locked_amount = get_value<decimal_t>(asset_item, "l");
     updates.push_back(data);
   }
   auto &streams_container = request_handler_t::get_stream_container();
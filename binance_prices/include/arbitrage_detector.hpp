@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cross_rates.hpp"
+#include "subscription_data.hpp"
+#include "symbol_registry.hpp"
+
+namespace binance {
+
+struct arbitrage_leg_t {
+  symbol_id_t symbol_id{invalid_symbol_id};
+  trade_direction_e direction{trade_direction_e::none}; // of the base asset
+};
+
+// a cycle whose net product crossed the threshold
+struct arbitrage_opportunity_t {
+  std::array<arbitrage_leg_t, 4> legs{}; // in trading order
+  std::uint32_t leg_count{};
+  // the product of the rates, before and after the fees of every leg
+  double gross_product{};
+  double net_product{};
+  std::uint64_t event_time{}; // of the tick that completed it
+};
+
+// called on the detector's thread for every opportunity, it must not block
+using arbitrage_subscriber_t =
+    std::function<void(arbitrage_opportunity_t const &)>;
+
+struct arbitrage_config_t {
+  // the assets every cycle starts and ends in, e.g. USDT. The detector is
+  // off when it's empty
+  std::vector<std::string> anchors{};
+  // the taker fee paid on every leg, 0.1% on Binance by default
+  double fee{0.001};
+  // the profit after fees an opportunity must at least make
+  double min_profit{0.0};
+  // the enumeration stops there, so a dense listing can't exhaust memory
+  std::size_t max_cycles{1'000'000};
+  std::vector<std::string> quote_assets{default_quote_assets()};
+  // the only stream the rates are taken from
+  stream_type_e source{stream_type_e::mini_ticker};
+};
+
+/* Finds triangular (and four-leg) arbitrage across the whole market: a
+ * cycle of symbols starting and ending in an anchor asset, e.g. USDT ->
+ * BTC -> ETH -> USDT, whose product of rates beats the fees.
+ *
+ * The three- and four-leg cycles through the anchors are enumerated once,
+ * when the symbols are loaded, along with a symbol -> cycles index in CSR
+ * form. A tick then only recomputes the products of the cycles its symbol
+ * is a leg of, from the last rate of each leg so no error accumulates.
+ * Rates are last (or mid) prices, so a cycle's product one way is the
+ * inverse of the other and both ways are checked from it. A cycle is
+ * published when its net product crosses `1 + min_profit` and again only
+ * after it fell back under.
+ *
+ * There must be a single writer: background_price_saver.
+ */
+class arbitrage_detector_t {
+  struct cycle_t {
+    std::array<symbol_id_t, 4> symbols{};
+    // bit i is set if leg i is traded from the base to the quote asset
+    std::uint8_t sells{};
+    std::uint8_t leg_count{};
+    bool open{}; // the last evaluation was over the threshold
+    double product{};
+    // `product` must be over it one way, or its inverse the other way
+    double threshold{};
+  };
+
+  symbol_registry_t const &symbols_;
+  arbitrage_config_t config_{};
+  std::vector<arbitrage_subscriber_t> subscribers_{};
+  std::vector<cycle_t> cycles_{};
+  // the cycles of symbol i are cycle_ids_[cycle_offsets_[i],
+  // cycle_offsets_[i + 1])
+  std::vector<std::uint32_t> cycle_offsets_{};
+  std::vector<std::uint32_t> cycle_ids_{};
+  std::unique_ptr<double[]> rates_; // the last price, 0 if none yet
+  std::size_t loaded_symbol_count_{};
+  std::uint64_t published_count_{};
+
+  void enumerate_cycles();
+  void evaluate(cycle_t &cycle, std::uint64_t const event_time,
+                bool const publish);
+
+public:
+  explicit arbitrage_detector_t(symbol_registry_t const &symbols);
+  arbitrage_detector_t(arbitrage_detector_t const &) = delete;
+  arbitrage_detector_t &operator=(arbitrage_detector_t const &) = delete;
+
+  // not thread-safe, both must be called before the first tick
+  void configure(arbitrage_config_t config);
+  void subscribe(arbitrage_subscriber_t subscriber);
+
+  bool enabled() const { return !config_.anchors.empty(); }
+
+  // writer side
+  void on_tick(pushed_subscription_data_t const &tick);
+  // enumerates the cycles again if symbols were registered since the last
+  // time. The opportunities open then are not published
+  void load_symbols();
+
+  std::size_t cycle_count() const { return cycles_.size(); }
+  std::uint64_t published_count() const { return published_count_; }
+};
+
+// e.g. "BTCUSDT buy, ETHBTC buy, ETHUSDT sell: +0.12%"
+std::string arbitrage_to_string(symbol_registry_t const &symbols,
+                                arbitrage_opportunity_t const &opportunity);
+
+} // namespace binance
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "subscription_data.hpp"
+#include "symbol_registry.hpp"
+
+namespace binance {
+
+// assets (BTC, USDT, DOGE, ...) are interned like the symbols
+using asset_id_t = symbol_id_t;
+constexpr asset_id_t invalid_asset_id = invalid_symbol_id;
+
+// the quote assets of the symbols listed on Binance
+std::vector<std::string> default_quote_assets();
+
+struct asset_pair_t {
+  std::string_view base{};
+  std::string_view quote{};
+};
+
+// splits `symbol` on the longest of `quote_assets` it ends with, e.g.
+// DOGEBTC into DOGE and BTC. std::nullopt if it ends with none
+std::optional<asset_pair_t>
+split_symbol(std::string_view const symbol,
+             std::vector<std::string> const &quote_assets);
+
+struct cross_rates_config_t {
+  // the currencies every asset is priced in, e.g. EUR or USDT. The engine
+  // is off when it's empty
+  std::vector<std::string> home_currencies{};
+  // see split_symbol(); the symbols that end with none are ignored
+  std::vector<std::string> quote_assets{default_quote_assets()};
+  // the only stream the rates are taken from
+  stream_type_e source{stream_type_e::mini_ticker};
+};
+
+/* Implied prices of any asset in any other, derived from the graph the
+ * listed symbols make: assets are the vertices and every symbol an edge
+ * from its base to its quote asset, e.g. DOGE in EUR through DOGEBTC and
+ * BTCEUR.
+ *
+ * Every home currency is the root of a spanning tree of the fewest hops
+ * to each asset it reaches, and each asset's price in it is the product
+ * of the rates along its path. A tick only re-derives the assets below
+ * its symbol's edge, and only if that edge is in the tree: a DOGEBTC tick
+ * reprices DOGE alone and a BTCEUR tick the assets priced through BTC. A
+ * symbol's first tick adds its edge, which only re-roots the assets it
+ * brings closer to a home currency.
+ *
+ * There must be a single writer: background_price_saver. The prices are
+ * published per (home currency, asset) as atomics, so any thread can read
+ * them without blocking the writer; the price of an asset in a currency
+ * other than the home ones is the ratio of two of them.
+ */
+class cross_rates_t {
+public:
+  // Binance lists a little over 500 assets at the time of writing
+  static constexpr std::size_t max_assets = 4'096;
+
+private:
+  static constexpr std::uint32_t unreached = ~std::uint32_t{0};
+
+  // a symbol seen from one of its assets
+  struct adjacent_t {
+    asset_id_t asset{invalid_asset_id};
+    symbol_id_t symbol_id{invalid_symbol_id};
+    bool is_quote{}; // `asset` is the symbol's quote asset
+  };
+  struct node_t {
+    asset_id_t parent{invalid_asset_id};
+    // the edge to the parent and whether this asset is its base
+    symbol_id_t symbol_id{invalid_symbol_id};
+    bool is_base{};
+    std::uint32_t depth{unreached};
+    std::vector<asset_id_t> children{};
+  };
+  struct tree_t {
+    asset_id_t root{invalid_asset_id};
+    std::unique_ptr<node_t[]> nodes{}; // writer only
+    // indexed by symbol ID: the asset whose edge to its parent the symbol
+    // is, invalid_asset_id if it's not in the tree. Writer only
+    std::unique_ptr<asset_id_t[]> child_by_symbol{};
+    // indexed by asset ID, 0 if the asset isn't reached (yet)
+    std::unique_ptr<std::atomic<double>[]> prices{};
+  };
+  enum class listing_e : std::uint8_t { unseen, listed, ignored };
+  struct listing_t {
+    listing_e state{listing_e::unseen};
+    asset_id_t base{invalid_asset_id};
+    asset_id_t quote{invalid_asset_id};
+  };
+
+  symbol_registry_t const &symbols_;
+  cross_rates_config_t config_{};
+  symbol_registry_t assets_{};
+  std::vector<tree_t> trees_{};
+  // writer only, indexed by symbol ID
+  std::unique_ptr<listing_t[]> listings_;
+  std::unique_ptr<double[]> rates_; // the last price, 0 if none yet
+  // writer only, indexed by asset ID
+  std::vector<std::vector<adjacent_t>> adjacency_{};
+  std::vector<asset_id_t> scratch_{};
+
+  bool list(symbol_id_t const id);
+  double rate(symbol_id_t const id, bool const is_base) const;
+  void reparent(tree_t &tree, asset_id_t const asset, asset_id_t const parent,
+                adjacent_t const &edge);
+  bool add_edge(tree_t &tree, symbol_id_t const id);
+  // re-derives the prices of `asset` and of every asset below it
+  void reprice(tree_t &tree, asset_id_t const asset);
+
+public:
+  explicit cross_rates_t(symbol_registry_t const &symbols);
+  cross_rates_t(cross_rates_t const &) = delete;
+  cross_rates_t &operator=(cross_rates_t const &) = delete;
+
+  // not thread-safe, must be called before the first tick. Returns false,
+  // after logging why, if a home currency can't be registered
+  bool configure(cross_rates_config_t config);
+  bool enabled() const { return !trees_.empty(); }
+
+  // writer side
+  void on_tick(pushed_subscription_data_t const &tick);
+
+  // reader side, lock-free and safe from any thread
+  asset_id_t find_asset(std::string_view const asset) const {
+    return assets_.find(asset);
+  }
+  // the price of one `base` in `quote`, std::nullopt if no home currency
+  // reaches both
+  std::optional<double> implied_price(asset_id_t const base,
+                                      asset_id_t const quote) const;
+  std::optional<double> implied_price(std::string_view const base,
+                                      std::string_view const quote) const;
+};
+
+} // namespace binance
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "history_block.hpp"
+
+namespace binance {
+
+enum class downsampling_e : std::uint8_t {
+  none,    // every point
+  min_max, // the lowest and the highest point of every bucket
+  lttb     // Largest-Triangle-Three-Buckets, one point per bucket
+};
+
+std::optional<downsampling_e> string_to_downsampling(std::string_view const);
+char const *downsampling_to_string(downsampling_e const);
+
+/* Reduces a price series, fed oldest first, to a few points per time bucket
+ * of `bucket_width` milliseconds from `origin`, so that a chart gets the
+ * shape of a day of ticks from a thousand points. The points kept are
+ * actual ticks, never averages.
+ *
+ * min_max keeps the spikes; LTTB keeps the point of each bucket that makes
+ * the largest triangle with the point kept in the bucket before and the
+ * average of the bucket after, which follows the visual shape more
+ * closely. Both work bucket by bucket as the points come, holding at most
+ * two buckets, so a range can be downsampled in slices.
+ */
+class downsampler_t {
+  downsampling_e const method_;
+  std::uint64_t const origin_;
+  std::uint64_t const bucket_width_;
+
+  std::uint64_t bucket_{};
+  bool has_points_{false};
+  // min_max
+  price_point_t min_{};
+  price_point_t max_{};
+  // lttb: the last point kept, the bucket waiting for the next one to
+  // complete and the bucket being filled
+  price_point_t selected_{};
+  std::vector<price_point_t> previous_{};
+  std::vector<price_point_t> current_{};
+
+  void close_bucket(std::vector<price_point_t> &out);
+  void select(std::vector<price_point_t> const &bucket, double const next_x,
+              double const next_y, std::vector<price_point_t> &out);
+
+public:
+  downsampler_t(downsampling_e const method, std::uint64_t const origin,
+                std::uint64_t const bucket_width);
+
+  // appends the points that are final to `out`
+  void add(price_point_t const &point, std::vector<price_point_t> &out);
+  // after the last point
+  void finish(std::vector<price_point_t> &out);
+};
+
+} // namespace binance
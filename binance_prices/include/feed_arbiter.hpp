@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "subscription_data.hpp"
+#include "symbol_registry.hpp"
+
+namespace binance {
+
+/* Merges redundant copies of the same market data feed: for every symbol and
+ * stream type it remembers the highest sequence seen so far, so the first
+ * copy of an update to arrive (on whichever connection) is forwarded and the
+ * later ones are dropped. Safe to call from every feed's thread at once.
+ */
+class feed_arbiter_t {
+  std::unique_ptr<std::atomic<std::uint64_t>[]> last_sequences_;
+
+public:
+  feed_arbiter_t();
+  feed_arbiter_t(feed_arbiter_t const &) = delete;
+  feed_arbiter_t &operator=(feed_arbiter_t const &) = delete;
+
+  // true if `data` is newer than anything seen for its symbol and stream
+  bool accept(pushed_subscription_data_t const &data) noexcept;
+  // removes the updates that were already forwarded by another feed
+  void filter(std::vector<pushed_subscription_data_t> &pushed_list) noexcept;
+};
+
+} // namespace binance
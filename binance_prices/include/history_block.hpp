@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/decimal.hpp"
+
+namespace binance {
+
+struct price_point_t {
+  std::uint64_t time{}; // in milliseconds
+  decimal_t price{};
+};
+
+/* The price history of a symbol is a file of fixed-size blocks, each one a
+ * history_block_header_t followed by a bit stream of up to a few thousand
+ * points, compressed as in Facebook's Gorilla:
+ *
+ * - the first point is stored as is, time then price, in 64 bits each;
+ * - a time is stored as the difference between its delta to the previous
+ *   time and the previous delta: '0' if they are equal, otherwise '10',
+ *   '110', '1110' or '1111' then the difference in 7, 9, 12 or 32 bits;
+ * - a price, in decimal_t units, is XORed with the previous one: '0' if
+ *   they are equal, '10' then the meaningful bits if they fit in the
+ *   previous point's leading and trailing zeros, otherwise '11', 5 bits of
+ *   leading zeros, 6 bits of length - 1 and the meaningful bits.
+ *
+ * Ticks every second that move by a few units then take about 2 to 4 bytes
+ * instead of 16. Bits are written most significant first and integers in
+ * the host's byte order. The header bounds the block's times and prices, so
+ * a reader skips the blocks outside its range without decoding them.
+ */
+constexpr char history_block_magic[4] = {'B', 'N', 'P', 'H'};
+constexpr std::uint16_t history_block_version = 1;
+constexpr std::size_t history_block_size = 4'096;
+
+struct history_block_header_t {
+  char magic[4];
+  std::uint16_t version;
+  std::uint16_t reserved;
+  std::uint32_t count;      // of points
+  std::uint32_t bit_length; // of the stream
+  std::uint64_t first_time;
+  std::uint64_t last_time;
+  std::int64_t min_price; // in decimal_t units
+  std::int64_t max_price;
+};
+
+struct history_block_t {
+  history_block_header_t header;
+  std::uint8_t stream[history_block_size - sizeof(history_block_header_t)];
+};
+
+static_assert(sizeof(history_block_header_t) == 48);
+static_assert(sizeof(history_block_t) == history_block_size);
+
+// appends points to a block until it is full
+class history_block_encoder_t {
+  history_block_t block_{};
+  std::uint64_t last_delta_{};
+  std::uint64_t last_price_{};
+  unsigned leading_zeros_{};
+  unsigned trailing_zeros_{};
+
+  void write_bits(std::uint64_t const value, unsigned count);
+  bool write_time(std::uint64_t const time);
+  void write_price(std::uint64_t const price);
+
+public:
+  history_block_encoder_t() { reset(); }
+
+  // starts a new, empty block
+  void reset();
+  // returns false if the block is full; it must then be sealed and the
+  // encoder reset. A time before the last one is stored as the last one,
+  // so a block's times never decrease
+  bool append(std::uint64_t time, decimal_t const price);
+
+  history_block_t const &block() const { return block_; }
+  std::uint32_t count() const { return block_.header.count; }
+  bool empty() const { return block_.header.count == 0; }
+};
+
+// iterates the points of a block, oldest first
+class history_block_decoder_t {
+  history_block_t const &block_;
+  std::uint32_t index_{};
+  std::uint32_t bit_position_{};
+  std::uint64_t last_time_{};
+  std::uint64_t last_delta_{};
+  std::uint64_t last_price_{};
+  unsigned leading_zeros_{};
+  unsigned trailing_zeros_{};
+
+  std::uint64_t read_bits(unsigned count);
+
+public:
+  explicit history_block_decoder_t(history_block_t const &block)
+      : block_{block} {}
+
+  bool next(price_point_t &point);
+};
+
+// true if `block` is a block of this version, with a stream in bounds
+bool is_valid_history_block(history_block_t const &block);
+
+} // namespace binance
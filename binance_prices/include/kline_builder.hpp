@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "common/seqlock.hpp"
+#include "subscription_data.hpp"
+
+namespace binance {
+
+enum class kline_interval_e : std::uint8_t {
+  one_second,
+  one_minute,
+  five_minutes,
+  one_hour
+};
+
+constexpr std::size_t kline_interval_count = 4;
+
+std::uint64_t interval_to_milliseconds(kline_interval_e const);
+// Binance's names: "1s", "1m", "5m", "1h"
+char const *kline_interval_to_string(kline_interval_e const);
+std::optional<kline_interval_e> string_to_kline_interval(std::string_view);
+
+// an OHLCV candle, times are in milliseconds
+struct kline_t {
+  symbol_id_t symbol_id{invalid_symbol_id};
+  kline_interval_e interval{kline_interval_e::one_minute};
+  std::uint32_t tick_count{}; // 0 means there is no bar
+  std::uint64_t open_time{};
+  std::uint64_t last_event_time{};
+  decimal_t open{};
+  decimal_t high{};
+  decimal_t low{};
+  decimal_t close{};
+  decimal_sum_t volume{}; // only aggTrade ticks carry a quantity
+
+  std::uint64_t close_time() const {
+    return open_time + interval_to_milliseconds(interval) - 1;
+  }
+};
+
+// called on the builder's thread for every closed bar, it must not block
+using kline_subscriber_t = std::function<void(kline_t const &)>;
+
+struct kline_config_t {
+  // the builder is off when this is 0
+  std::size_t history_size{};
+  // the only stream the bars are built from, so a trade is never counted
+  // twice when several streams are subscribed to
+  stream_type_e source{stream_type_e::mini_ticker};
+  // how long after its end a bar that got no later tick is closed anyway,
+  // which leaves room for ticks arriving late
+  std::uint64_t close_delay_ms{2'000};
+};
+
+/* Builds 1s/1m/5m/1h candles of every symbol from the ticks as they come
+ * in, so that nothing downstream has to rebuild them from raw history.
+ *
+ * Each (symbol, interval) pair has an open bar and a preallocated ring of
+ * its last `history_size` closed bars, created with the first tick of the
+ * symbol. A tick updates the open bar of every interval in O(1); when a tick
+ * falls in a later interval the bar is closed, stored in the ring and handed
+ * to the subscribers.
+ *
+ * There must be a single writer: background_price_saver. The open bars and
+ * the rings are published through sequence locks, so any thread can read
+ * them without blocking it.
+ */
+class kline_builder_t {
+  struct series_t {
+    kline_t open_bar{}; // writer only
+    std::uint64_t last_closed_open_time{};
+    seqlocked_t<kline_t> published_open_bar{};
+    std::unique_ptr<seqlocked_t<kline_t>[]> closed_bars{};
+    std::atomic<std::uint64_t> closed_count{};
+  };
+  using symbol_series_t = std::array<series_t, kline_interval_count>;
+
+  kline_config_t config_{};
+  std::vector<kline_subscriber_t> subscribers_{};
+  // indexed by symbol ID, null until the symbol's first tick
+  std::unique_ptr<std::atomic<symbol_series_t *>[]> series_;
+  std::vector<std::unique_ptr<symbol_series_t>> allocated_series_{};
+  std::uint64_t late_ticks_{};
+
+  symbol_series_t *get_or_create(symbol_id_t const id);
+  symbol_series_t const *find(symbol_id_t const id) const;
+  void close_bar(series_t &series);
+
+public:
+  kline_builder_t();
+  kline_builder_t(kline_builder_t const &) = delete;
+  kline_builder_t &operator=(kline_builder_t const &) = delete;
+
+  // not thread-safe, both must be called before the first tick
+  void configure(kline_config_t const &config);
+  void subscribe(kline_subscriber_t subscriber);
+
+  bool enabled() const { return config_.history_size != 0; }
+
+  // writer side
+  void on_tick(pushed_subscription_data_t const &tick);
+  // resumes a bar that was open when a state snapshot was taken, before the
+  // first tick of its symbol
+  void restore_open_bar(kline_t const &bar);
+  // closes the bars that ended more than `close_delay_ms` before `now_ms`
+  // and got no tick since, so quiet symbols still get their bars closed.
+  // `now_ms` is the exchange's time, i.e. the latest event time applied
+  void close_expired_bars(std::uint64_t const now_ms);
+  // ticks dropped from at least one interval whose bar was already closed
+  std::uint64_t late_ticks() const { return late_ticks_; }
+
+  // reader side, lock-free and safe from any thread
+  std::optional<kline_t> open_bar(symbol_id_t const id,
+                                  kline_interval_e const interval) const;
+  // appends up to `count` of the latest closed bars, oldest first, and
+  // returns how many were appended
+  std::size_t closed_bars(symbol_id_t const id,
+                          kline_interval_e const interval,
+                          std::size_t const count,
+                          std::vector<kline_t> &result) const;
+};
+
+} // namespace binance
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "common/containers.hpp"
+#include "kline_builder.hpp"
+
+namespace binance {
+
+/* Persists the closed bars of a kline_builder_t as CSV, one file per
+ * interval (`<directory>/klines_1m.csv`, ...) with the columns
+ * `symbol,open_time,close_time,open,high,low,close,volume,ticks`.
+ *
+ * The builder's thread only pushes the bars into a ring; they are formatted
+ * and written on the writer's own thread, so the tick path never waits on
+ * the disk. Bars are dropped (and counted) if the disk can't keep up.
+ */
+class kline_writer_t {
+  std::string const directory_;
+  spsc_ring_t<kline_t> bars_;
+  std::atomic<std::uint64_t> dropped_bars_{};
+  std::thread thread_;
+
+  void write_bars();
+
+public:
+  explicit kline_writer_t(std::string directory);
+  kline_writer_t(kline_writer_t const &) = delete;
+  kline_writer_t &operator=(kline_writer_t const &) = delete;
+
+  // subscribes to `builder` and starts the writer thread
+  void run(kline_builder_t &builder);
+  std::uint64_t dropped_bars() const {
+    return dropped_bars_.load(std::memory_order_relaxed);
+  }
+};
+
+} // namespace binance
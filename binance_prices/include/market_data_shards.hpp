@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "market_data_stream.hpp"
+
+namespace binance {
+
+struct shard_config_t {
+  std::size_t shard_count{1};
+  std::vector<stream_type_e> stream_types{stream_type_e::mini_ticker};
+  // identical connections opened for every shard, see feed_arbiter_t
+  std::size_t redundancy{1};
+};
+
+/* Splits the per-symbol streams of every listed instrument across several
+ * combined-stream connections (/stream?streams=a/b/c). Each connection has
+ * its own io_context and thread, and all of them feed the same tokens
+ * container, so ingestion scales with cores and a slow connection only
+ * delays the symbols it carries.
+ *
+ * With a redundancy above 1, every shard is opened that many times and the
+ * copies are arbitrated, so losing a connection costs no reconnect latency.
+ */
+class market_data_shards_t {
+public:
+  // https://binance-docs.github.io/apidocs/spot/en/#websocket-market-streams
+  static constexpr std::size_t max_streams_per_connection = 1'024;
+
+private:
+  struct shard_t {
+    net::io_context io_context{1};
+    std::unique_ptr<market_data_stream_t> stream;
+    std::thread thread;
+  };
+
+  net::ssl::context &ssl_ctx_;
+  shard_config_t const config_;
+  std::vector<std::unique_ptr<shard_t>> shards_;
+  // fetches the listing next to the shards after a state snapshot restore
+  std::unique_ptr<shard_t> bootstrap_;
+
+  bool fetch_instruments();
+  void reconcile_instruments();
+
+public:
+  market_data_shards_t(net::ssl::context &, shard_config_t);
+  ~market_data_shards_t();
+  market_data_shards_t(market_data_shards_t const &) = delete;
+  market_data_shards_t &operator=(market_data_shards_t const &) = delete;
+
+  // fetches the listed instruments and starts one thread per connection.
+  // Returns false if the instruments could not be fetched. After a state
+  // snapshot restore, the restored symbols are streamed right away and the
+  // listing is fetched next to them; symbols listed since the snapshot are
+  // then only streamed after the next restart.
+  bool run();
+  // blocks until every connection's io_context has stopped
+  void join();
+  std::size_t shard_count() const { return shards_.size(); }
+};
+
+/* Groups the streams of every registered symbol into the handshake paths of
+ * at least `shard_count` combined-stream connections. All streams of a symbol
+ * go to the same connection, and more connections are used if needed to
+ * stay under max_streams_per_connection.
+ */
+std::vector<std::string>
+make_combined_stream_paths(symbol_registry_t const &symbols,
+                           std::vector<stream_type_e> const &stream_types,
+                           std::size_t shard_count);
+
+} // namespace binance
@@ -10,7 +10,9 @@
 #include <boost/beast/websocket/stream.hpp>
 #include <optional>
 
+#include "common/exchange_endpoints.hpp"
 #include "common/json_utils.hpp"
+#include "subscription_data.hpp"
 
 namespace binance {
 
@@ -20,22 +22,39 @@ namespace websock = beast::websocket;
 namespace http = beast::http;
 namespace ip = net::ip;
 
+struct stream_options_t {
+  // "/ws/!miniTicker@arr", or "/stream?streams=a/b/c" for a combined stream.
+  // Empty if the stream should only fetch the instruments.
+  std::string ws_path{"/ws/!miniTicker@arr"};
+  // fill the symbol registry from the REST API before connecting
+  bool fetch_instruments{true};
+  // used to tell the connections apart in the logs
+  std::size_t shard_id{};
+  // which of the redundant copies of a feed this is. Copy `i` prefers the
+  // i-th resolved address, so the copies don't all share the same route.
+  std::size_t feed_id{};
+  // drop the updates another copy of the feed already forwarded
+  bool arbitrate{false};
+};
+
 class market_data_stream_t {
-  static char const *const rest_api_host_;
-  static char const *const ws_host_;
-  static char const *const ws_port_number_;
 
   using resolver = ip::tcp::resolver;
   using results_type = resolver::results_type;
 
   net::io_context &io_context_;
   net::ssl::context &ssl_ctx_;
+  exchange_endpoints_t const endpoints_ = exchange_endpoints();
+  stream_options_t const options_;
+  bool const is_combined_stream_;
   std::optional<resolver> resolver_;
   std::optional<websock::stream<beast::ssl_stream<beast::tcp_stream>>>
       ssl_web_stream_;
   std::optional<beast::flat_buffer> buffer_;
   std::optional<http::request<http::empty_body>> http_request_;
   std::optional<http::response<http::string_body>> http_response_;
+  std::size_t last_frame_size_{};
+  std::uint32_t recorded_stream_id_{};
 
 private:
   void rest_api_prepare_request();
@@ -53,13 +72,23 @@ private:
   void websock_connect_to_resolved_names(results_type const &);
   void perform_websocket_handshake();
   void wait_for_messages();
-  void interpret_generic_messages();
+  // `received_at_ns` is 0 unless latency tracking is on. `receive_time_ms`
+  // is 0 for frames that were just received
+  void interpret_generic_messages(std::string_view const frame,
+                                  std::uint64_t const received_at_ns,
+                                  std::uint64_t const receive_time_ms = 0);
   void process_pushed_instruments_data(json::array_t const &);
-  void process_pushed_tickers_data(json::array_t const &);
+  void process_pushed_tickers_data(std::vector<pushed_subscription_data_t> &&);
+  void stamp_receive_time(std::vector<pushed_subscription_data_t> &,
+                          std::uint64_t receive_time_ms);
 
 public:
-  market_data_stream_t(net::io_context &, net::ssl::context &);
+  market_data_stream_t(net::io_context &, net::ssl::context &,
+                       stream_options_t options = {});
   void run();
+  // decodes a frame captured by the frame recorder as if it was received
+  void replay_frame(std::string_view const frame,
+                    std::uint64_t const receive_time_ms);
 };
 
 namespace utilities {
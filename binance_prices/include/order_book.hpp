@@ -0,0 +1,127 @@
+#pragma once
+
+#include "common/decimal.hpp"
+#include "common/seqlock.hpp"
+#include "symbol_registry.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace binance {
+
+struct price_level_t {
+  decimal_t price{};
+  decimal_t quantity{};
+};
+
+// a diff from the `<symbol>@depth@100ms` stream
+struct depth_update_t {
+  symbol_id_t symbol_id{invalid_symbol_id};
+  std::uint64_t event_time{};
+  std::uint64_t first_update_id{}; // "U"
+  std::uint64_t final_update_id{}; // "u"
+  std::vector<price_level_t> bids{};
+  std::vector<price_level_t> asks{};
+};
+
+// the response of GET /api/v3/depth, best levels first
+struct depth_snapshot_t {
+  std::uint64_t last_update_id{};
+  std::vector<price_level_t> bids{};
+  std::vector<price_level_t> asks{};
+};
+
+// what the readers of a book get: the best `max_levels` levels of each side
+struct book_top_t {
+  static constexpr std::size_t max_levels = 10;
+
+  std::uint64_t update_id{}; // 0 while the book is not in sync
+  std::uint64_t event_time{};
+  std::uint32_t bid_count{};
+  std::uint32_t ask_count{};
+  price_level_t bids[max_levels]{}; // best first
+  price_level_t asks[max_levels]{};
+
+  bool empty() const { return bid_count == 0 || ask_count == 0; }
+  std::optional<decimal_t> mid_price() const;
+  // the mid price weighted by the quantities on the opposite side
+  std::optional<decimal_t> micro_price() const;
+  // the total quantity of the best `levels` levels
+  decimal_t bid_depth(std::size_t const levels) const;
+  decimal_t ask_depth(std::size_t const levels) const;
+};
+
+enum class book_state_e { awaiting_snapshot, synced };
+
+enum class book_update_result_e {
+  applied,
+  buffered, // waiting for the snapshot
+  stale,    // older than the book
+  gap       // an update was missed, the book needs a new snapshot
+};
+
+/* A local L2 order book kept in sync with the diff-depth stream, following
+ * https://binance-docs.github.io/apidocs/spot/en/#how-to-manage-a-local-order-book-correctly
+ *
+ * Each side is a flat array sorted so that the best price is at the back,
+ * since most updates land near the top of the book where inserting or
+ * erasing moves the fewest elements.
+ *
+ * A book has one writer (the thread of the connection that owns it). Every
+ * applied update publishes the top of the book through a sequence lock, so
+ * any thread can read it without blocking the writer.
+ */
+class order_book_t {
+  symbol_id_t const symbol_id_;
+  std::vector<price_level_t> bids_{}; // ascending prices
+  std::vector<price_level_t> asks_{}; // descending prices
+  std::vector<depth_update_t> pending_updates_{};
+  std::uint64_t last_update_id_{};
+  book_state_e state_{book_state_e::awaiting_snapshot};
+  // no update was applied since the last snapshot
+  bool awaiting_first_update_{true};
+  seqlocked_t<book_top_t> top_{};
+
+  void apply_levels(depth_update_t const &update);
+  void publish(std::uint64_t const event_time);
+
+public:
+  // updates buffered while the snapshot is fetched, older ones are dropped
+  static constexpr std::size_t max_pending_updates = 1'024;
+
+  explicit order_book_t(symbol_id_t const symbol_id);
+
+  // writer side
+  book_update_result_e on_update(depth_update_t const &update);
+  // returns false if the buffered updates don't line up with `snapshot`, in
+  // which case the book waits for another snapshot
+  bool on_snapshot(depth_snapshot_t const &snapshot);
+  // drops the book's content and waits for a new snapshot
+  void reset();
+
+  book_state_e state() const { return state_; }
+  symbol_id_t symbol_id() const { return symbol_id_; }
+
+  // reader side, lock-free and safe from any thread
+  book_top_t top() const { return top_.load(); }
+};
+
+/* The order books of a process, indexed by symbol ID. The books are all
+ * created before the streams start and are never destroyed, so looking one
+ * up needs no lock.
+ */
+class order_books_t {
+  std::unique_ptr<std::unique_ptr<order_book_t>[]> books_;
+
+public:
+  order_books_t();
+
+  // not thread-safe, call it before the streams start
+  order_book_t &get_or_create(symbol_id_t const id);
+  // nullptr if there is no book for `id`
+  order_book_t *find(symbol_id_t const id) const;
+};
+
+} // namespace binance
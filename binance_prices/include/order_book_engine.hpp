@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "order_book_stream.hpp"
+
+namespace binance {
+
+struct order_book_config_t {
+  std::vector<std::string> symbols{};
+  // levels requested from /api/v3/depth, at most 5,000
+  std::size_t snapshot_depth{1'000};
+  // books kept in sync by one connection (and one thread)
+  std::size_t books_per_connection{100};
+};
+
+/* Runs the order books of `config.symbols`, spread over connections of
+ * `books_per_connection` books each. Each connection has its own io_context
+ * and thread and is the only writer of its books; the books themselves are
+ * read through request_handler_t::get_order_books().
+ */
+class order_book_engine_t {
+  struct connection_t {
+    net::io_context io_context{1};
+    std::unique_ptr<order_book_stream_t> stream;
+    std::thread thread;
+  };
+
+  net::ssl::context &ssl_ctx_;
+  order_book_config_t const config_;
+  std::vector<std::unique_ptr<connection_t>> connections_;
+
+public:
+  order_book_engine_t(net::ssl::context &, order_book_config_t);
+  ~order_book_engine_t();
+  order_book_engine_t(order_book_engine_t const &) = delete;
+  order_book_engine_t &operator=(order_book_engine_t const &) = delete;
+
+  // creates the books and starts their connections. Returns false if a
+  // symbol could not be registered.
+  bool run();
+  void join();
+};
+
+} // namespace binance
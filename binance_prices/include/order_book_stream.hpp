@@ -0,0 +1,74 @@
+#pragma once
+
+#include <boost/asio/steady_timer.hpp>
+#include <deque>
+
+#include "market_data_stream.hpp"
+#include "order_book.hpp"
+
+namespace binance {
+
+/* Keeps the order books of a group of symbols in sync: it listens to their
+ * `@depth@100ms` diffs on one combined-stream connection and fetches the
+ * /api/v3/depth snapshots, one at a time, over a kept-alive REST connection
+ * whenever a book is out of sync.
+ *
+ * Everything runs on one io_context, so the thread running it is the only
+ * writer of these books.
+ */
+class order_book_stream_t {
+  using resolver = ip::tcp::resolver;
+  using results_type = resolver::results_type;
+  using ssl_stream_t = beast::ssl_stream<beast::tcp_stream>;
+
+  net::io_context &io_context_;
+  net::ssl::context &ssl_ctx_;
+  exchange_endpoints_t const endpoints_ = exchange_endpoints();
+  order_books_t &books_;
+  std::vector<symbol_id_t> const symbol_ids_;
+  std::size_t const snapshot_depth_;
+  std::size_t const connection_id_;
+
+  std::optional<resolver> ws_resolver_;
+  std::optional<websock::stream<ssl_stream_t>> ws_stream_;
+  std::optional<beast::flat_buffer> ws_buffer_;
+  depth_update_t update_{}; // reused for every frame
+
+  std::optional<resolver> rest_resolver_;
+  std::optional<ssl_stream_t> rest_stream_;
+  std::optional<beast::flat_buffer> rest_buffer_;
+  std::optional<http::request<http::empty_body>> http_request_;
+  std::optional<http::response<http::string_body>> http_response_;
+  net::steady_timer retry_timer_;
+  depth_snapshot_t snapshot_{};
+  std::deque<symbol_id_t> snapshot_queue_{};
+  bool is_fetching_snapshot_{false};
+
+private:
+  void ws_initiate_connection();
+  void ws_connect_to_resolved_names(results_type const &);
+  void ws_perform_ssl_handshake();
+  void ws_perform_websocket_handshake();
+  void ws_wait_for_messages();
+  void ws_interpret_message();
+  void ws_reconnect();
+
+  void request_snapshot(symbol_id_t const id);
+  void rest_fetch_next_snapshot();
+  void rest_initiate_connection();
+  void rest_connect_to_resolved_names(results_type const &);
+  void rest_perform_ssl_handshake();
+  void rest_send_request();
+  void rest_receive_response();
+  void rest_on_response_received(beast::error_code const);
+  void rest_retry_later(std::chrono::seconds const delay);
+
+public:
+  order_book_stream_t(net::io_context &, net::ssl::context &, order_books_t &,
+                      std::vector<symbol_id_t> symbol_ids,
+                      std::size_t const snapshot_depth,
+                      std::size_t const connection_id);
+  void run();
+};
+
+} // namespace binance
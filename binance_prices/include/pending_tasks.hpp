@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "subscription_data.hpp"
+
+namespace binance {
+
+/* The tasks added to or removed from a task engine by any thread, until the
+ * engine's single writer applies them in the order they were queued. A
+ * removal is a task with only its request_id and task_state_e::remove set.
+ * Checking for changes is a relaxed load, so the writer can do it per tick.
+ */
+class pending_tasks_t {
+  std::mutex mutex_{};
+  std::vector<scheduled_task_t> pending_{};
+  std::atomic<bool> has_pending_{};
+  std::vector<scheduled_task_t> applying_{}; // writer only
+
+  void push(scheduled_task_t &&task) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    pending_.push_back(std::move(task));
+    has_pending_.store(true, std::memory_order_release);
+  }
+
+  static scheduled_task_t make_removal(std::string request_id) {
+    scheduled_task_t removal{};
+    removal.request_id = std::move(request_id);
+    removal.status = task_state_e::remove;
+    return removal;
+  }
+
+public:
+  void add(scheduled_task_t task) { push(std::move(task)); }
+
+  void remove(std::string request_id) {
+    push(make_removal(std::move(request_id)));
+  }
+
+  // queues the removals under a single lock
+  void remove(std::vector<std::string> const &request_ids) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (auto const &request_id : request_ids) {
+      pending_.push_back(make_removal(request_id));
+    }
+    has_pending_.store(true, std::memory_order_release);
+  }
+
+  // writer side: calls `apply(scheduled_task_t &)` for every queued change
+  template <typename Apply> void apply(Apply &&apply) {
+    if (!has_pending_.load(std::memory_order_acquire)) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      std::swap(pending_, applying_);
+      has_pending_.store(false, std::memory_order_relaxed);
+    }
+    for (auto &task : applying_) {
+      apply(task);
+    }
+    applying_.clear();
+  }
+};
+
+} // namespace binance
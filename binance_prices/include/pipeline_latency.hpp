@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "common/latency_histogram.hpp"
+
+namespace binance {
+
+// where a tick spends its time, from Binance to the price table
+enum class latency_stage_e : std::uint8_t {
+  // "E" to the local receive time, per tick. Includes the clock skew
+  // between Binance and this host, which is clamped at 0
+  exchange_to_receive,
+  // read completion to the end of decoding, per frame
+  receive_to_parsed,
+  // end of decoding to the push into tokens_container_, per frame. Includes
+  // the arbitration of redundant feeds
+  parsed_to_enqueued,
+  // waiting in tokens_container_ for background_price_saver, per tick
+  enqueued_to_applied,
+  // read completion to the price table update, per tick
+  receive_to_applied,
+};
+
+constexpr std::size_t latency_stage_count = 5;
+
+std::string latency_stage_to_string(latency_stage_e const);
+
+// a monotonic timestamp in nanoseconds, for the `*_at_ns` fields of ticks
+std::uint64_t steady_clock_ns();
+
+/* One histogram per stage of the price pipeline. Tracking is off unless
+ * enabled, in which case the market data streams and the price saver take
+ * timestamps and record into the histograms; see latency_stage_e.
+ */
+class pipeline_latency_t {
+  std::atomic<bool> enabled_{false};
+  std::array<latency_histogram_t, latency_stage_count> histograms_{};
+
+public:
+  pipeline_latency_t() = default;
+  pipeline_latency_t(pipeline_latency_t const &) = delete;
+  pipeline_latency_t &operator=(pipeline_latency_t const &) = delete;
+
+  void enable(bool const enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void record(latency_stage_e const stage, std::uint64_t const nanoseconds) {
+    histograms_[static_cast<std::size_t>(stage)].record(nanoseconds);
+  }
+  // records `later - earlier`, or 0 if the clocks went the other way
+  void record(latency_stage_e const stage, std::uint64_t const earlier,
+              std::uint64_t const later) {
+    record(stage, later > earlier ? later - earlier : 0);
+  }
+  latency_summary_t summary(latency_stage_e const stage) const {
+    return histograms_[static_cast<std::size_t>(stage)].summary();
+  }
+  void reset();
+  // logs p50/p99/p99.9/max of every stage
+  void dump() const;
+};
+
+/* Dumps the histograms to the log on SIGUSR1 and resets them on SIGUSR2, on
+ * a thread of its own. Does nothing where those signals don't exist.
+ */
+void watch_latency_signals(pipeline_latency_t &latency);
+
+} // namespace binance
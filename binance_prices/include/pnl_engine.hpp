@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pending_tasks.hpp"
+#include "pnl_kernels.hpp"
+#include "subscription_data.hpp"
+#include "symbol_registry.hpp"
+#include "task_registry.hpp"
+
+namespace binance {
+
+struct pnl_engine_config_t {
+  // the only stream the PnLs are computed from: a price alternating between
+  // the bookTicker mid and the last trade would republish every task of its
+  // symbol on each tick
+  stream_type_e source{stream_type_e::mini_ticker};
+};
+
+/* Keeps the profit and loss of the profit_and_loss tasks up to date: a
+ * "buy" task made quantity * (market price - order_price), a "sell" task
+ * quantity * (order_price - market price). A task without a quantity gets
+ * money / order_price.
+ *
+ * The tasks of a symbol are stored as parallel arrays of signed quantities,
+ * costs and last PnLs, so when its price moves all of them are recomputed
+ * by one vectorized kernel (see pnl_kernels.hpp) and only the tasks whose
+ * PnL changed are handed to the subscribers. The PnLs are computed in
+ * doubles of decimal_t units, exact up to ~90 million in the quote asset.
+ *
+ * There must be a single writer: background_price_saver. Tasks can be
+ * added and removed from any thread; the changes are queued and applied
+ * before the next tick is evaluated.
+ */
+class pnl_engine_t {
+  struct symbol_tasks_t {
+    std::vector<double> quantities{}; // negative for sells
+    std::vector<double> costs{};      // quantity * order_price, in units
+    std::vector<double> pnls{};       // in units, NaN until first computed
+    std::vector<std::uint32_t> tasks{}; // task indices
+    double last_price{};              // NaN when the PnLs are out of date
+  };
+
+  task_registry_t &registry_;
+  pnl_engine_config_t config_{};
+  // writer only
+  std::unique_ptr<symbol_tasks_t[]> symbols_; // indexed by symbol ID
+  // indexed by task index: the result each task produces, minus the price,
+  // the time and the PnL, and where it is in its symbol's arrays. A task
+  // that is not in the engine has no symbol
+  std::vector<scheduled_task_t::task_result_t> results_{};
+  std::vector<std::uint32_t> positions_{};
+  std::vector<task_result_subscriber_t> subscribers_{};
+  std::vector<std::uint32_t> changed_{};
+  pnl_kernel_t const kernel_;
+  std::atomic<std::size_t> size_{};
+
+  pending_tasks_t pending_{};
+
+  void insert(scheduled_task_t &&task);
+  void erase(std::string const &request_id);
+
+public:
+  explicit pnl_engine_t(task_registry_t &registry);
+  pnl_engine_t(pnl_engine_t const &) = delete;
+  pnl_engine_t &operator=(pnl_engine_t const &) = delete;
+
+  // not thread-safe, both must be called before the first tick
+  void configure(pnl_engine_config_t const &config);
+  void subscribe(task_result_subscriber_t subscriber);
+
+  // any thread. Returns false, after logging why, if the task is not a
+  // valid profit_and_loss task; a task with the same request_id is replaced
+  bool add(scheduled_task_t task);
+  void remove(std::string request_id);
+  void remove(std::vector<std::string> const &request_ids);
+
+  // writer side
+  void on_tick(pushed_subscription_data_t const &tick);
+  // the number of tasks, for monitoring
+  std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+};
+
+} // namespace binance
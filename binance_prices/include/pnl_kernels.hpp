@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace binance {
+
+/* The inner loop of pnl_engine_t, over one symbol's tasks:
+ *
+ *   pnls[i] = round(quantities[i] * price - costs[i])
+ *
+ * where the quantities are signed (negative for a sell) and the price, the
+ * costs and the PnLs are in decimal_t units held in doubles, exact up to
+ * 2^53 units. The indices of the PnLs that changed are written to
+ * `changed`, which must have room for `count` of them, and their number is
+ * returned. A NaN PnL always counts as changed.
+ */
+using pnl_kernel_t = std::size_t (*)(double const *quantities,
+                                     double const *costs, double *pnls,
+                                     std::size_t count, double price,
+                                     std::uint32_t *changed);
+
+namespace detail {
+std::size_t update_pnls_scalar(double const *quantities, double const *costs,
+                               double *pnls, std::size_t count,
+                               double const price, std::uint32_t *changed);
+} // namespace detail
+
+// the fastest kernel the CPU supports (AVX2 or NEON), picked once at start-up
+pnl_kernel_t pnl_kernel();
+// "avx2", "neon" or "scalar"
+char const *pnl_kernel_name();
+
+} // namespace binance
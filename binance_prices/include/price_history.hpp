@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "common/containers.hpp"
+#include "history_block.hpp"
+#include "subscription_data.hpp"
+
+namespace binance {
+
+struct price_history_config_t {
+  std::string directory{}; // no history is kept without one
+  // the stream whose prices are kept, the others are ignored
+  stream_type_e source{stream_type_e::mini_ticker};
+  // how often the blocks being filled are written, so that a crash loses at
+  // most that much history
+  std::chrono::seconds flush_interval{5};
+};
+
+// called with the points of a scan, oldest first
+using price_point_visitor_t = std::function<void(price_point_t const &)>;
+
+/* An append-only store of the price history of every symbol, in
+ * `<directory>/<SYMBOL>.history`: a file of the compressed blocks described
+ * in history_block.hpp, in time order.
+ *
+ * The tick path only pushes the ticks into a ring; they are compressed and
+ * written on the store's own thread. A symbol's last block is kept in
+ * memory while it fills, written over its place in the file every
+ * `flush_interval`, and sealed once full; after a restart appending starts
+ * in a new block. Ticks are dropped (and counted) if the writer can't keep
+ * up.
+ *
+ * Readers, from any thread, map the file and find the first block of their
+ * range by a binary search over the block headers, so a scan decodes at
+ * most the part of a block before its range. The block being filled is
+ * read from memory, so a scan sees every tick the writer processed.
+ */
+class price_history_t {
+  struct tick_t {
+    symbol_id_t symbol_id{invalid_symbol_id};
+    std::uint64_t time{};
+    decimal_t price{};
+  };
+  struct symbol_history_t {
+    // held by the writer while it changes the block, and by readers while
+    // they copy it
+    std::mutex mutex{};
+    history_block_encoder_t encoder{};
+    std::uint64_t block_index{}; // of the block being filled, in the file
+    bool dirty{false};           // writer only
+  };
+
+  price_history_config_t config_{};
+  spsc_ring_t<tick_t> ticks_;
+  std::atomic<std::uint64_t> dropped_ticks_{};
+  // indexed by symbol ID, created by the writer on a symbol's first tick
+  std::unique_ptr<std::atomic<symbol_history_t *>[]> symbols_;
+  std::thread thread_;
+
+  std::string filename(symbol_id_t const symbol_id) const;
+  symbol_history_t &get_or_insert(symbol_id_t const symbol_id);
+  bool write_block(symbol_id_t const symbol_id,
+                   symbol_history_t const &symbol);
+  void append(tick_t const &tick);
+  void flush();
+  void write_ticks();
+
+public:
+  price_history_t();
+  ~price_history_t();
+  price_history_t(price_history_t const &) = delete;
+  price_history_t &operator=(price_history_t const &) = delete;
+
+  // not thread-safe, must be called before run()
+  void configure(price_history_config_t config);
+  bool enabled() const { return !config_.directory.empty(); }
+  // returns false, after logging why, if the directory can't be created.
+  // Otherwise starts the writer thread
+  bool run();
+
+  // the price saver's thread
+  void on_tick(pushed_subscription_data_t const &tick);
+
+  // any thread: visits the points of `symbol_id` from `from` to `to`, both
+  // in milliseconds and included. Returns the number of points visited
+  std::size_t scan(symbol_id_t const symbol_id, std::uint64_t const from,
+                   std::uint64_t const to,
+                   price_point_visitor_t const &visit) const;
+
+  std::uint64_t dropped_ticks() const {
+    return dropped_ticks_.load(std::memory_order_relaxed);
+  }
+};
+
+} // namespace binance
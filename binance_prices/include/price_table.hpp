@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "subscription_data.hpp"
+#include "symbol_registry.hpp"
+
+namespace binance {
+
+/* The latest tick of every symbol, stored as parallel arrays indexed by
+ * symbol ID. Each slot has its own sequence lock, so readers (PnL, alerts,
+ * HTTP snapshots) get a consistent (price, open, event time) triple without
+ * taking a lock, and the writer never waits on them.
+ *
+ * There must be a single writer: background_price_saver.
+ */
+class price_table_t {
+public:
+  static constexpr std::size_t capacity = symbol_registry_t::max_symbols;
+
+private:
+  std::unique_ptr<std::atomic<std::int64_t>[]> current_prices_;
+  std::unique_ptr<std::atomic<std::int64_t>[]> open_24h_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> event_times_;
+  // 0 means the slot was never written, odd means a write is in progress
+  std::unique_ptr<std::atomic<std::uint64_t>[]> versions_;
+
+public:
+  price_table_t();
+  price_table_t(price_table_t const &) = delete;
+  price_table_t &operator=(price_table_t const &) = delete;
+
+  // writer side; ticks with an unknown symbol ID are dropped
+  void update(pushed_subscription_data_t const &data) noexcept;
+
+  // std::nullopt if no tick was seen for `id` yet
+  std::optional<pushed_subscription_data_t> get(symbol_id_t const id) const;
+  // the number of updates written to `id`'s slot
+  std::uint64_t update_count(symbol_id_t const id) const noexcept;
+  // appends a copy of every populated slot with an ID below `symbol_count`
+  void snapshot(std::size_t const symbol_count,
+                std::vector<pushed_subscription_data_t> &result) const;
+};
+
+} // namespace binance
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pending_tasks.hpp"
+#include "subscription_data.hpp"
+#include "symbol_registry.hpp"
+#include "task_registry.hpp"
+
+namespace binance {
+
+struct price_thresholds_config_t {
+  // the only stream the tasks are evaluated against, so a task set against
+  // last prices never triggers on a bookTicker mid price
+  stream_type_e source{stream_type_e::mini_ticker};
+};
+
+/* Evaluates the price_changes tasks: a "sell" task triggers once the price
+ * of its symbol rises to its order_price, a "buy" task once it falls to it.
+ * Each task triggers once and is then removed.
+ *
+ * Every symbol has two ladders of thresholds, an up-cross one sorted
+ * descending and a down-cross one sorted ascending, so the rungs a tick
+ * crosses are always at the back of a ladder. A tick that crosses nothing
+ * costs two comparisons; otherwise a binary search finds the first crossed
+ * rung and the range up to the end is triggered and cut off. The cost of a
+ * tick therefore does not depend on how many tasks are watching a symbol.
+ *
+ * There must be a single writer: background_price_saver. Tasks can be
+ * added and removed from any thread; the changes are queued and applied
+ * before the next tick is evaluated.
+ */
+class price_thresholds_t {
+  struct rung_t {
+    std::int64_t threshold{}; // order_price, in decimal_t units
+    std::uint32_t task{};     // task index, see task_registry_t
+  };
+  struct ladders_t {
+    std::vector<rung_t> up{};   // descending thresholds
+    std::vector<rung_t> down{}; // ascending thresholds
+  };
+
+  task_registry_t &registry_;
+  price_thresholds_config_t config_{};
+  // writer only
+  std::unique_ptr<ladders_t[]> ladders_; // indexed by symbol ID
+  // indexed by task index: the result each task produces, minus the tick's
+  // price and time. A task that is not in the ladders has no symbol
+  std::vector<scheduled_task_t::task_result_t> results_{};
+  std::vector<task_result_subscriber_t> subscribers_{};
+  std::atomic<std::size_t> size_{};
+
+  pending_tasks_t pending_{};
+
+  void insert(scheduled_task_t &&task);
+  void erase(std::string const &request_id);
+  void trigger(std::vector<rung_t> &ladder, std::size_t const first,
+               pushed_subscription_data_t const &tick);
+
+public:
+  explicit price_thresholds_t(task_registry_t &registry);
+  price_thresholds_t(price_thresholds_t const &) = delete;
+  price_thresholds_t &operator=(price_thresholds_t const &) = delete;
+
+  // not thread-safe, both must be called before the first tick
+  void configure(price_thresholds_config_t const &config);
+  void subscribe(task_result_subscriber_t subscriber);
+
+  // any thread. Returns false, after logging why, if the task is not a
+  // valid price_changes task; a task with the same request_id is replaced
+  bool add(scheduled_task_t task);
+  void remove(std::string request_id);
+  void remove(std::vector<std::string> const &request_ids);
+
+  // writer side
+  void on_tick(pushed_subscription_data_t const &tick);
+  // the number of tasks in the ladders, for monitoring
+  std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+};
+
+} // namespace binance
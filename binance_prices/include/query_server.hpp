@@ -0,0 +1,38 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/error.hpp>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace binance {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+
+/* The HTTP server answering queries over the price history (see
+ * query_session_t). It runs on its own thread and io_context, so queries
+ * never hold up the market data connections, whichever way those are run.
+ */
+class query_server_t {
+  net::io_context io_context_{1};
+  net::ip::tcp::acceptor acceptor_;
+  std::thread thread_;
+
+  void accept_connections();
+  void on_connection_accepted(beast::error_code const &ec,
+                              net::ip::tcp::socket socket);
+
+public:
+  query_server_t();
+  query_server_t(query_server_t const &) = delete;
+  query_server_t &operator=(query_server_t const &) = delete;
+
+  // returns false, after logging why, if it can't listen on `address`:`port`.
+  // Otherwise starts the server's thread
+  bool run(std::string const &address, std::uint16_t const port);
+};
+
+} // namespace binance
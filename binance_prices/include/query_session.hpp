@@ -0,0 +1,96 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/http_router.hpp"
+#include "downsampling.hpp"
+#include "symbol_registry.hpp"
+
+namespace binance {
+
+namespace net = boost::asio;
+
+using string_response_t = http::response<http::string_body>;
+
+/* A connection to the query server. Requests are routed by an endpoint_t
+ * as on binance_orders' web server:
+ *
+ * GET /history?symbol=BTCUSDT&from=<ms>&to=<ms>&resolution=<s>
+ *             &downsampling=minmax|lttb|none
+ *   the prices of `symbol` from `from` to `to` (default: the last 24h), in
+ *   buckets of `resolution` seconds (default: ~1,000 buckets), as
+ *   {"symbol", "from", "to", "resolution", "downsampling",
+ *    "points": [[time, "price"], ...]}
+ *   with downsampling=none, the range spans 7 days at most
+ *
+ * GET /rate?base=DOGE&quote=EUR
+ *   the price of one `base` in `quote` implied by the listed pairs, as
+ *   {"base", "quote", "price"}; 404 if no home currency reaches both
+ *
+ * The history is scanned one slice of buckets at a time and every slice
+ * is sent as an HTTP chunk once downsampled, so neither the range nor the
+ * response is ever held in memory. A run of slices without points is
+ * scanned a few at a time, so a sparse range never holds up the other
+ * sessions of the io thread.
+ */
+class query_session_t : public std::enable_shared_from_this<query_session_t> {
+  struct history_query_t {
+    symbol_id_t symbol_id{invalid_symbol_id};
+    std::uint64_t from{};
+    std::uint64_t to{};
+    std::uint64_t bucket_width{}; // in milliseconds
+    downsampling_e downsampling{downsampling_e::min_max};
+    std::uint64_t next_from{}; // of the next slice
+    std::optional<downsampler_t> downsampler{};
+  };
+
+  beast::tcp_stream tcp_stream_;
+  beast::flat_buffer buffer_{};
+  std::optional<string_request_t> request_{};
+  std::optional<string_response_t> response_{};
+  endpoint_t endpoint_apis_{};
+
+  // the chunked response being streamed
+  std::optional<http::response<http::empty_body>> chunked_response_{};
+  std::optional<http::response_serializer<http::empty_body>> serializer_{};
+  std::optional<history_query_t> query_{};
+  std::vector<price_point_t> points_{};
+  std::string chunk_{};
+  bool first_point_{true};
+
+  void add_endpoint_interfaces();
+  void http_read_data();
+  void on_data_read(beast::error_code const ec);
+  void handle_requests(string_request_t const &request);
+  void history_handler(string_request_t const &request,
+                       url_query_t const &query);
+  void rate_handler(string_request_t const &request,
+                    url_query_t const &query);
+  void send_response(string_response_t &&response);
+  void on_data_written(beast::error_code const ec, bool const keep_alive);
+  void write_next_chunk();
+  bool fill_next_chunk();
+  void shutdown_socket();
+
+  static string_response_t error_response(http::status const status,
+                                          std::string const &message,
+                                          string_request_t const &request);
+
+public:
+  explicit query_session_t(net::ip::tcp::socket &&socket);
+  void run();
+};
+
+} // namespace binance
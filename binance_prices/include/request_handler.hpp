@@ -1,22 +1,82 @@
 #pragma once
 
+#include "arbitrage_detector.hpp"
 #include "common/containers.hpp"
-#include "orders_info.hpp"
+#include "common/frame_log.hpp"
+#include "cross_rates.hpp"
+#include "feed_arbiter.hpp"
+#include "kline_builder.hpp"
+#include "order_book.hpp"
+#include "pipeline_latency.hpp"
+#include "pnl_engine.hpp"
+#include "price_history.hpp"
+#include "price_table.hpp"
+#include "price_thresholds.hpp"
+#include "rolling_stats.hpp"
+#include "state_snapshot.hpp"
 #include "subscription_data.hpp"
+#include "symbol_registry.hpp"
+#include "task_monitor.hpp"
+#include "task_registry.hpp"
 #include <variant>
 
 namespace binance {
 
 class request_handler_t {
 
-  static waitable_container_t<pushed_subscription_data_t> tokens_container_;
-  static locked_set_t<instrument_type_t> all_listed_instruments_;
-  static subscription_data_map_t all_pushed_sub_data_;
+  static mpsc_ring_t<pushed_subscription_data_t> tokens_container_;
+  static conflating_container_t<pushed_subscription_data_t, tick_conflation_t>
+      latest_ticks_;
+  static bool conflating_ticks_;
+  static symbol_registry_t symbol_registry_;
+  static price_table_t price_table_;
+  static feed_arbiter_t feed_arbiter_;
+  static order_books_t order_books_;
+  static kline_builder_t kline_builder_;
+  static rolling_stats_t rolling_stats_;
+  static cross_rates_t cross_rates_;
+  static arbitrage_detector_t arbitrage_detector_;
+  static price_history_t price_history_;
+  static task_registry_t task_registry_;
+  static price_thresholds_t price_thresholds_;
+  static pnl_engine_t pnl_engine_;
+  static task_monitor_t task_monitor_;
+  static state_snapshot_t state_snapshot_;
+  static std::unique_ptr<frame_recorder_t> frame_recorder_;
+  static pipeline_latency_t pipeline_latency_;
 
 public:
   static auto &get_tokens_container() { return tokens_container_; }
-  static auto &get_all_listed_instruments() { return all_listed_instruments_; }
-  static auto &get_all_pushed_data() { return all_pushed_sub_data_; }
+  // used instead of the tokens container when ticks are conflated
+  static auto &get_latest_ticks() { return latest_ticks_; }
+  static bool conflating_ticks() { return conflating_ticks_; }
+  // must be called before the streams and the price saver are started
+  static void set_conflating_ticks(bool const conflate) {
+    conflating_ticks_ = conflate;
+  }
+  static auto &get_symbol_registry() { return symbol_registry_; }
+  static auto &get_price_table() { return price_table_; }
+  static auto &get_feed_arbiter() { return feed_arbiter_; }
+  static auto &get_order_books() { return order_books_; }
+  static auto &get_kline_builder() { return kline_builder_; }
+  static auto &get_rolling_stats() { return rolling_stats_; }
+  static auto &get_cross_rates() { return cross_rates_; }
+  static auto &get_arbitrage_detector() { return arbitrage_detector_; }
+  static auto &get_price_history() { return price_history_; }
+  static auto &get_task_registry() { return task_registry_; }
+  static auto &get_price_thresholds() { return price_thresholds_; }
+  static auto &get_pnl_engine() { return pnl_engine_; }
+  static auto &get_task_monitor() { return task_monitor_; }
+  static auto &get_state_snapshot() { return state_snapshot_; }
+  static auto &get_pipeline_latency() { return pipeline_latency_; }
+  // nullptr unless the frames are being recorded
+  static frame_recorder_t *get_frame_recorder() {
+    return frame_recorder_.get();
+  }
+  // must be called before the streams are created
+  static void set_frame_recorder(std::unique_ptr<frame_recorder_t> recorder) {
+    frame_recorder_ = std::move(recorder);
+  }
 };
 
 } // namespace binance
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "common/seqlock.hpp"
+#include "subscription_data.hpp"
+
+namespace binance {
+
+// "30s", "5m", "1h", "24h", "7d"; std::nullopt if malformed or zero
+std::optional<std::uint64_t> string_to_window_ms(std::string_view);
+
+// the statistics of a symbol over one window, times are in milliseconds
+struct rolling_window_stats_t {
+  symbol_id_t symbol_id{invalid_symbol_id};
+  std::uint32_t window_index{};
+  std::uint64_t tick_count{}; // 0 means no tick in the window
+  // the start of the oldest bucket still in the window
+  std::uint64_t first_time{};
+  std::uint64_t last_event_time{};
+  decimal_t high{};
+  decimal_t low{};
+  // weighted by the tick quantities; by tick for streams without any
+  decimal_t vwap{};
+  decimal_sum_t volume{}; // only aggTrade ticks carry a quantity
+  // the realized range: the sum of every bucket's squared ln(high / low)
+  double realized_range{};
+};
+
+struct rolling_stats_config_t {
+  // the windows, in milliseconds. The statistics are off when it's empty
+  std::vector<std::uint64_t> windows_ms{};
+  // the number of time buckets a window is split in. A window covers its
+  // last `bucket_count` buckets, the one being filled included, so its span
+  // is between `window - window / bucket_count` and `window`
+  std::size_t bucket_count{60};
+  // the only stream the statistics are computed from
+  stream_type_e source{stream_type_e::mini_ticker};
+};
+
+/* Rolling high, low, VWAP, volume, tick count and realized range of every
+ * symbol over a handful of windows (e.g. 5m, 1h and 24h), so alerts and PnL
+ * can look at any of them without going to the database.
+ *
+ * Each window is cut in time buckets. The closed buckets of a (symbol,
+ * window) pair sit in a ring, with two monotonic deques of ring positions
+ * for the high and the low and running sums for the rest, so a tick costs
+ * O(1) amortised per window whatever the window's length. Everything is
+ * preallocated with the symbol's first tick.
+ *
+ * There must be a single writer: background_price_saver. The statistics of
+ * every pair are republished after each of its ticks through a sequence
+ * lock, so any thread can read them without blocking the writer.
+ */
+class rolling_stats_t {
+  struct bucket_t {
+    std::uint64_t index{}; // time / bucket_ms
+    std::uint64_t tick_count{};
+    decimal_t high{};
+    decimal_t low{};
+    decimal_sum_t volume{};
+    double weighted_prices{};
+    double weights{};
+  };
+  // a ring of bucket sequence numbers, ordered by high (or low)
+  struct monotonic_deque_t {
+    std::unique_ptr<std::uint64_t[]> sequences{};
+    std::uint64_t front{};
+    std::uint64_t back{};
+  };
+  struct series_t {
+    symbol_id_t symbol_id{invalid_symbol_id};
+    std::uint32_t window_index{};
+    std::uint64_t bucket_ms{};
+    // the newest bucket index a tick or expire() got to
+    std::uint64_t current_index{};
+    std::uint64_t last_event_time{};
+    bucket_t open_bucket{}; // tick_count is 0 until its first tick
+    // closed buckets [oldest, next) live at `sequence % bucket_count`
+    std::unique_ptr<bucket_t[]> closed_buckets{};
+    std::uint64_t oldest{};
+    std::uint64_t next{};
+    monotonic_deque_t highs{};
+    monotonic_deque_t lows{};
+    // of the closed buckets in the window
+    std::uint64_t tick_count{};
+    decimal_sum_t volume{};
+    double weighted_prices{};
+    double weights{};
+    double realized_range{};
+    seqlocked_t<rolling_window_stats_t> published{};
+  };
+
+  rolling_stats_config_t config_{};
+  // indexed by symbol ID, each points to one series per window. Null until
+  // the symbol's first tick
+  std::unique_ptr<std::atomic<series_t *>[]> series_;
+  std::vector<std::unique_ptr<series_t[]>> allocated_series_{};
+  std::uint64_t late_ticks_{};
+
+  series_t *get_or_create(symbol_id_t const id);
+  bucket_t const &closed_bucket(series_t const &series,
+                                std::uint64_t const sequence) const;
+  void close_bucket(series_t &series);
+  // closes the bucket being filled if it's older than `bucket_index` and
+  // drops the buckets that left the window. Returns true if anything did
+  bool advance(series_t &series, std::uint64_t const bucket_index);
+  void resum(series_t &series) const;
+  void publish(series_t &series);
+
+public:
+  rolling_stats_t();
+  rolling_stats_t(rolling_stats_t const &) = delete;
+  rolling_stats_t &operator=(rolling_stats_t const &) = delete;
+
+  // not thread-safe, must be called before the first tick
+  void configure(rolling_stats_config_t config);
+
+  bool enabled() const { return !config_.windows_ms.empty(); }
+  std::size_t window_count() const { return config_.windows_ms.size(); }
+  // the index of the configured window of `window_ms`, if there is one
+  std::optional<std::uint32_t>
+  window_index(std::uint64_t const window_ms) const;
+
+  // writer side
+  void on_tick(pushed_subscription_data_t const &tick);
+  // drops the buckets that left their window by `now_ms`, so the statistics
+  // of quiet symbols don't go stale. `now_ms` is the exchange's time, i.e.
+  // the latest event time applied
+  void expire(std::uint64_t const now_ms);
+  // ticks older than their symbol's current bucket, counted in it
+  std::uint64_t late_ticks() const { return late_ticks_; }
+
+  // reader side, lock-free and safe from any thread. std::nullopt if the
+  // symbol had no tick in the window
+  std::optional<rolling_window_stats_t>
+  stats(symbol_id_t const id, std::uint32_t const window_index) const;
+};
+
+} // namespace binance
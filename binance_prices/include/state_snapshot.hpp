@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "subscription_data.hpp"
+
+namespace binance {
+
+struct state_snapshot_config_t {
+  std::string filename{}; // no snapshot is taken without one
+  std::chrono::seconds interval{10};
+};
+
+/* Periodic binary snapshots of what binance_prices otherwise rebuilds from
+ * the network on start: the symbol registry, the price table and the open
+ * candles. After a restart the snapshot is mapped and copied back before
+ * the first connection is made, so prices are served right away, and the
+ * REST bootstrap runs next to the websockets instead of before them.
+ *
+ * A snapshot is written to `<filename>.tmp` and renamed over `filename`, so
+ * the file is always a complete snapshot. It is a snapshot_header_t followed
+ * by `symbol_count` names, `price_count` price slots and `bar_count`
+ * kline_t, and is only valid on the architecture that wrote it.
+ *
+ * Everything is read with the lock-free reader sides of the structures, so
+ * the snapshots are taken on the snapshotter's own thread without stopping
+ * the price saver.
+ */
+class state_snapshot_t {
+  state_snapshot_config_t config_{};
+  // when the restored snapshot was written, in milliseconds. 0 if none was
+  std::uint64_t restored_at_{};
+  std::size_t restored_symbol_count_{};
+  std::thread thread_;
+  // the listed prices reconcile() kept, until the price saver applies them
+  std::mutex reconciled_mutex_{};
+  std::vector<pushed_subscription_data_t> reconciled_prices_{};
+  std::atomic<bool> has_reconciled_prices_{false};
+
+  void take_snapshots();
+
+public:
+  state_snapshot_t() = default;
+  state_snapshot_t(state_snapshot_t const &) = delete;
+  state_snapshot_t &operator=(state_snapshot_t const &) = delete;
+
+  // not thread-safe, must be called before load() and run()
+  void configure(state_snapshot_config_t config);
+  bool enabled() const { return !config_.filename.empty(); }
+
+  // must be called before the price saver and the streams are started, and
+  // after the kline builder is configured. Returns false, after logging
+  // why, if there is no usable snapshot; nothing is restored then
+  bool load();
+  // starts the snapshotter thread
+  void run();
+  // returns false, after logging why, if the snapshot couldn't be written
+  bool write() const;
+
+  bool restored() const { return restored_at_ != 0; }
+  std::uint64_t restored_at() const { return restored_at_; }
+
+  // called once with the prices of every listed symbol fetched from the
+  // REST API after a restore. Keeps the prices of the restored symbols for
+  // apply_reconciled_prices() and logs how the listing differs from the
+  // snapshot
+  void reconcile(std::vector<pushed_subscription_data_t> &&listed);
+  // the price saver's thread: writes the kept prices to the price table of
+  // the symbols no live tick has updated since the snapshot. They are not
+  // ticks, so nothing else sees them
+  void apply_reconciled_prices();
+};
+
+} // namespace binance
@@ -1,15 +1,58 @@
 #pragma once
 
+#include "common/decimal.hpp"
+#include "symbol_registry.hpp"
+#include "task_registry.hpp"
+
+#include <cstdint>
+#include <functional>
 #include <string>
-#include <unordered_map>
 #include <variant>
 
 namespace binance {
 
+// the market data streams a tick can come from
+enum class stream_type_e : std::uint8_t { mini_ticker, book_ticker, agg_trade };
+constexpr std::size_t stream_type_count = 3;
+
 struct pushed_subscription_data_t {
-  std::string instrument_id{};
-  double current_price{};
-  double open_24h{};
+  symbol_id_t symbol_id{invalid_symbol_id};
+  stream_type_e stream_type{stream_type_e::mini_ticker};
+  // the last price for miniTicker/aggTrade, the mid price for bookTicker
+  decimal_t current_price{};
+  decimal_t open_24h{}; // miniTicker only
+  decimal_t quantity{}; // aggTrade only
+  // "E", in milliseconds. bookTicker has none, so it gets the receive time
+  std::uint64_t event_time{};
+  // increases with every update of a symbol's stream: "E" for miniTicker,
+  // the update ID "u" for bookTicker and the aggregate trade ID "a" for
+  // aggTrade. Used to tell duplicate updates from redundant feeds apart.
+  std::uint64_t sequence{};
+  // steady_clock_ns() at read completion and at the push into the tokens
+  // container. 0 unless latency tracking is on
+  std::uint64_t received_at_ns{};
+  std::uint64_t enqueued_at_ns{};
+};
+
+/* The slots of the conflating tokens container: one per symbol and stream
+ * type, so that a bookTicker update never replaces the aggTrade the candles
+ * are built from. A newer tick replaces a pending one but the aggTrade
+ * quantities add up, so the candle volumes stay exact; the intermediate
+ * prices, and with them the candles' highs and lows, are lost.
+ */
+struct tick_conflation_t {
+  static constexpr std::size_t slot_count =
+      symbol_registry_t::max_symbols * stream_type_count;
+
+  static std::size_t key(pushed_subscription_data_t const &tick) {
+    return static_cast<std::size_t>(tick.symbol_id) * stream_type_count +
+           static_cast<std::size_t>(tick.stream_type);
+  }
+  static void merge(pushed_subscription_data_t &pending,
+                    pushed_subscription_data_t &&newer) {
+    newer.quantity += pending.quantity;
+    pending = newer;
+  }
 };
 
 enum class task_state_e : std::size_t {
@@ -32,33 +75,35 @@ enum class trade_direction_e : std::size_t { none, sell, buy };
 struct scheduled_task_t {
   std::string request_id{};
   std::string for_username{};
-  std::string token_name{};
   std::string direction{};
   std::size_t monitor_time_secs{};
   std::size_t column_id{};
   std::size_t current_time{};
+  symbol_id_t symbol_id{invalid_symbol_id};
   task_state_e status{task_state_e::unknown};
   task_type_e task_type{task_type_e::unknown};
-  double order_price{};
+  decimal_t order_price{};
   // used when the current market price is needed
-  double money{};
-  double quantity{};
+  decimal_t money{};
+  decimal_t quantity{};
 
+  /* Created for every triggered task and every PnL change, so it holds no
+   * strings: the request ID and the user are resolved through the
+   * task_registry_t, the symbol through the symbol_registry_t and the time
+   * formatted only when the result is serialized. */
   struct task_result_t {
-    /* this struct is created periodically, if there was a way to avoid copying
-     * strings every time, we should take it. */
-    std::string request_id{};
-    std::string token_name{};
-    std::string for_username{};
-    std::string current_time{};
+    task_handle_t task{};
+    user_id_t user_id{invalid_user_id};
+    std::uint64_t event_time{}; // of the tick, in milliseconds
     trade_direction_e direction{trade_direction_e::none};
     task_type_e task_type{task_type_e::unknown};
     std::size_t column_id{};
-    double order_price{};
-    double mkt_price{};
-    double money{};
-    double quantity{};
-    double pnl{};
+    symbol_id_t symbol_id{invalid_symbol_id};
+    decimal_t order_price{};
+    decimal_t mkt_price{};
+    decimal_t money{};
+    decimal_t quantity{};
+    decimal_t pnl{};
   };
 };
 
@@ -73,16 +118,18 @@ struct user_task_t {
   std::size_t monitor_time_secs{};
   task_state_e status{task_state_e::unknown};
   task_type_e task_type{task_type_e::unknown};
-  double money{};
-  double order_price{};
-  double quantity{};
+  decimal_t money{};
+  decimal_t order_price{};
+  decimal_t quantity{};
 };
 
-using subscription_data_map_t =
-    std::unordered_map<std::string, pushed_subscription_data_t>;
 using scheduled_task_result_t =
     std::variant<scheduled_task_t, scheduled_task_t::task_result_t>;
 
+// called on a task engine's thread for every result, it must not block
+using task_result_subscriber_t =
+    std::function<void(scheduled_task_t::task_result_t const &)>;
+
 std::string task_state_to_string(task_state_e const);
 std::string direction_to_string(trade_direction_e const);
 trade_direction_e string_to_direction(std::string const &);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace binance {
+
+using symbol_id_t = std::uint32_t;
+constexpr symbol_id_t invalid_symbol_id =
+    std::numeric_limits<symbol_id_t>::max();
+
+/* Maps every instrument symbol (BTCUSDT, DOGEBTC, ...) to a dense ID in
+ * [0, size()), so that ticks, tasks and results carry a 4-byte integer
+ * instead of a heap string, and per-symbol state can live in plain arrays
+ * indexed by that ID.
+ *
+ * IDs are never reused or removed. Resolving an ID back to its name is
+ * lock-free and safe from any thread; name -> ID lookups take a shared lock
+ * and new symbols are inserted under an exclusive one.
+ */
+class symbol_registry_t {
+public:
+  // Binance lists a little over 2,000 spot symbols at the time of writing
+  static constexpr std::size_t max_symbols = 16'384;
+  // the longest on Binance today is 12 characters
+  static constexpr std::size_t max_symbol_length = 32;
+
+private:
+  std::unique_ptr<std::string[]> names_;
+  std::unordered_map<std::string_view, symbol_id_t> ids_;
+  std::atomic<std::uint32_t> size_{};
+  mutable std::shared_mutex mutex_;
+
+public:
+  symbol_registry_t();
+  symbol_registry_t(symbol_registry_t const &) = delete;
+  symbol_registry_t &operator=(symbol_registry_t const &) = delete;
+
+  // upper-cases `symbol` and registers it if it wasn't known before. Returns
+  // invalid_symbol_id if the registry is full or `symbol` is empty.
+  symbol_id_t get_or_insert(std::string_view const symbol);
+  // returns invalid_symbol_id for unknown symbols; case-insensitive
+  symbol_id_t find(std::string_view const symbol) const;
+
+  // `id` must have been returned by this registry
+  std::string const &name(symbol_id_t const id) const { return names_[id]; }
+  bool contains(symbol_id_t const id) const { return id < size(); }
+  std::size_t size() const { return size_.load(std::memory_order_acquire); }
+};
+
+} // namespace binance
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/timer_wheel.hpp"
+#include "pnl_engine.hpp"
+#include "price_thresholds.hpp"
+#include "task_registry.hpp"
+
+namespace binance {
+
+namespace net = boost::asio;
+
+// called on the monitor's thread when tasks stop or are removed
+using task_state_subscriber_t = std::function<void(
+    std::vector<std::string> const &request_ids, task_state_e const state)>;
+
+/* The front door of the task engines: hands every task to the engine of its
+ * task_type and, if it has a monitor_time_secs, takes it out again once that
+ * time is up, from running to stopped. A price_changes task that triggered
+ * first is already gone from the registry: it completed, so nobody is told
+ * it stopped.
+ *
+ * The monitoring windows are timers of a single timer_wheel_t, with a tick
+ * of 100ms, driven by one steady_timer on the monitor's own thread instead
+ * of a timer per task, so starting and cancelling a window is O(1) whatever
+ * the task count. The timer only runs while there are windows open, and the
+ * tasks whose windows close on the same tick are removed from the engines
+ * as one batch.
+ */
+class task_monitor_t {
+public:
+  static constexpr std::chrono::milliseconds tick_length{100};
+
+private:
+  struct window_t {
+    std::string request_id{};
+    task_type_e task_type{task_type_e::unknown};
+  };
+
+  price_thresholds_t &price_thresholds_;
+  pnl_engine_t &pnl_engine_;
+  task_registry_t const &registry_;
+  net::io_context io_context_{1};
+  net::executor_work_guard<net::io_context::executor_type> work_guard_;
+  std::thread thread_;
+  std::atomic<std::size_t> size_{};
+
+  // monitor thread only
+  net::steady_timer timer_;
+  std::chrono::steady_clock::time_point const started_at_;
+  timer_wheel_t<window_t> windows_{};
+  std::unordered_map<std::string, timer_id_t> window_ids_{};
+  std::vector<std::string> stopped_[2]{}; // per engine
+  std::vector<task_state_subscriber_t> subscribers_{};
+  bool ticking_{false};
+
+  void open_window(std::string request_id, task_type_e const task_type,
+                   std::size_t const monitor_time_secs);
+  void close_window(std::string const &request_id);
+  void wait_for_tick();
+  void on_tick();
+  void notify(std::vector<std::string> const &request_ids,
+              task_state_e const state);
+
+public:
+  task_monitor_t(price_thresholds_t &price_thresholds,
+                 pnl_engine_t &pnl_engine, task_registry_t const &registry);
+  task_monitor_t(task_monitor_t const &) = delete;
+  task_monitor_t &operator=(task_monitor_t const &) = delete;
+
+  // not thread-safe, must be called before run()
+  void subscribe(task_state_subscriber_t subscriber);
+  // starts the monitor thread
+  void run();
+
+  // any thread. Returns false, after logging why, if the task is not valid
+  // for its engine; a task with the same request_id is replaced
+  bool add(scheduled_task_t task);
+  void remove(std::string request_id);
+
+  // the number of open monitoring windows, for monitoring
+  std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+};
+
+} // namespace binance
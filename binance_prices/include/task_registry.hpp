@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace binance {
+
+using user_id_t = std::uint32_t;
+constexpr user_id_t invalid_user_id = std::numeric_limits<user_id_t>::max();
+
+// refers to a task's request_id. The index is dense and recycled once the
+// task is gone; the generation tells the tasks that used it apart
+struct task_handle_t {
+  std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+  std::uint32_t generation{};
+};
+
+/* Interns the request IDs of the running tasks and the names of their users,
+ * so that task results carry small integer handles and the strings are only
+ * looked up when a result is serialized.
+ *
+ * A request ID is held as long as it was acquired more often than it was
+ * released; its index then goes to the back of a FIFO, so that results
+ * still in flight resolve it for as long as possible. User IDs are never
+ * released. Every call is thread-safe; lookups take a shared lock.
+ */
+class task_registry_t {
+  struct entry_t {
+    std::string request_id{};
+    std::uint32_t generation{};
+    std::uint32_t references{};
+  };
+
+  mutable std::shared_mutex mutex_{};
+  std::vector<entry_t> tasks_{};
+  std::deque<std::uint32_t> free_indices_{};
+  std::unordered_map<std::string, std::uint32_t> task_indices_{};
+  std::vector<std::string> users_{};
+  std::unordered_map<std::string, user_id_t> user_ids_{};
+
+public:
+  task_registry_t() = default;
+  task_registry_t(task_registry_t const &) = delete;
+  task_registry_t &operator=(task_registry_t const &) = delete;
+
+  task_handle_t acquire(std::string const &request_id);
+  void release(task_handle_t const handle);
+  // the handle of a task that is currently held
+  std::optional<task_handle_t> find(std::string const &request_id) const;
+  user_id_t get_or_insert_user(std::string const &username);
+
+  // empty if the task is gone and its index was reused since
+  std::string request_id(task_handle_t const handle) const;
+  std::string username(user_id_t const id) const;
+  // the number of request IDs held
+  std::size_t size() const;
+};
+
+} // namespace binance
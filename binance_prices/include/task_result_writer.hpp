@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "common/containers.hpp"
+#include "pnl_engine.hpp"
+#include "price_thresholds.hpp"
+
+namespace binance {
+
+/* The serialization boundary of the task results: the engines push the
+ * handle-only results into a preallocated ring, whose slots are recycled
+ * from one result to the next, and the writer's own thread resolves the
+ * request IDs, users and symbols and writes one JSON object per line. With
+ * no filename the results are logged instead, the PnL changes at debug
+ * level.
+ *
+ * The engines' thread never allocates nor waits for the writer: results
+ * are dropped (and counted) if the writer can't keep up.
+ */
+class task_result_writer_t {
+  std::string const filename_;
+  spsc_ring_t<scheduled_task_t::task_result_t> results_;
+  std::atomic<std::uint64_t> dropped_results_{};
+  std::thread thread_;
+
+  void write_results();
+
+public:
+  explicit task_result_writer_t(std::string filename);
+  task_result_writer_t(task_result_writer_t const &) = delete;
+  task_result_writer_t &operator=(task_result_writer_t const &) = delete;
+
+  // subscribes to both engines, which must share a thread, and starts the
+  // writer thread
+  void run(price_thresholds_t &price_thresholds, pnl_engine_t &pnl_engine);
+  std::uint64_t dropped_results() const {
+    return dropped_results_.load(std::memory_order_relaxed);
+  }
+};
+
+} // namespace binance
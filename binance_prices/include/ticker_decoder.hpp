@@ -0,0 +1,66 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "order_book.hpp"
+#include "subscription_data.hpp"
+#include "symbol_registry.hpp"
+
+namespace binance {
+
+/* An on-demand decoder for the `!miniTicker@arr` frames. Instead of building
+ * a DOM for ~2,000 tickers every second, it walks the frame buffer once and
+ * only materializes the "s", "c", "o" and "E" fields of each ticker; every
+ * other value is skipped over with SIMD-accelerated scans.
+ *
+ * Symbols are resolved to their IDs through `registry`, registering the ones
+ * that were listed after we bootstrapped.
+ *
+ * Throws std::runtime_error if the frame is malformed or a ticker misses one
+ * of the required fields, just like the json::parse path it replaces.
+ */
+void decode_mini_ticker_array(std::string_view const frame,
+                              symbol_registry_t &registry,
+                              std::vector<pushed_subscription_data_t> &result);
+
+/* Decodes a combined-stream frame, {"stream":"<name>","data":<payload>},
+ * whose payload is a miniTicker, bookTicker or aggTrade event (or a
+ * `!miniTicker@arr` array). Payloads of any other stream are skipped.
+ */
+void decode_combined_stream_frame(
+    std::string_view const frame, symbol_registry_t &registry,
+    std::vector<pushed_subscription_data_t> &result);
+
+/* Decodes a combined-stream frame of a `<symbol>@depth@100ms` stream into
+ * `update`, reusing its level vectors. Returns false, leaving `update`
+ * untouched, if the frame came from another stream.
+ */
+bool decode_depth_update(std::string_view const frame,
+                         symbol_registry_t &registry, depth_update_t &update);
+// decodes the body of a GET /api/v3/depth response
+void decode_depth_snapshot(std::string_view const body,
+                           symbol_registry_t &registry,
+                           depth_snapshot_t &snapshot);
+
+// "miniTicker", "bookTicker" and "aggTrade", as used in stream names
+std::string_view stream_type_to_string(stream_type_e const);
+std::optional<stream_type_e> string_to_stream_type(std::string_view const);
+// e.g. ("BTCUSDT", "bookTicker") => "btcusdt@bookTicker"
+std::string make_stream_name(std::string_view const symbol,
+                             std::string_view const stream);
+
+namespace detail {
+
+// returns the address of the first '"' or '\\' in [first, last), or `last`
+char const *find_quote_or_escape(char const *first,
+                                 char const *last) noexcept;
+
+// returns the address of the first ',', '}' or ']' in [first, last), or
+// `last`. Used to skip over scalar values (numbers, true, false, null).
+char const *find_value_end(char const *first, char const *last) noexcept;
+
+} // namespace detail
+} // namespace binance
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/frame_log.hpp"
 #include "market_data_stream.hpp"
 
 namespace net = boost::asio;
@@ -7,8 +8,19 @@ namespace ssl = net::ssl;
 
 namespace binance {
 
-void launch_price_watcher(std::unique_ptr<market_data_stream_t> &,
-                          net::io_context &, ssl::context &ssl_context);
+// `redundancy` identical feeds are opened and arbitrated when it is above 1
+void launch_price_watcher(
+    std::vector<std::unique_ptr<market_data_stream_t>> &websocks,
+    net::io_context &, ssl::context &ssl_context,
+    std::size_t const redundancy = 1);
 void background_price_saver();
+// returns once the price saver applied every tick queued so far. The
+// streams must not queue any more meanwhile, as after a replay
+void wait_for_price_saver();
+// feeds the recorded frames through the streams' usual decoding path, see
+// frame_replayer_t::replay for `speed`. Returns the number of frames.
+std::size_t replay_recorded_frames(frame_replayer_t const &replayer,
+                                   double const speed, net::io_context &,
+                                   ssl::context &ssl_context);
 
 } // namespace binance
@@ -1,14 +1,295 @@
+#include <CLI/CLI.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ssl/context.hpp>
+#include <chrono>
+#include <optional>
 #include <spdlog/spdlog.h>
 #include <thread>
 
+#include "common/exchange_endpoints.hpp"
+#include "kline_writer.hpp"
+#include "market_data_shards.hpp"
+#include "order_book_engine.hpp"
+#include "query_server.hpp"
+#include "request_handler.hpp"
+#include "task_result_writer.hpp"
+#include "ticker_decoder.hpp"
 #include "websock_launcher.hpp"
 
 int main(int argc, char *argv[]) {
+  CLI::App cli_parser{
+      "binance_prices: a system for monitoring crypto prices on Binance"};
+  std::size_t shard_count{};
+  std::size_t redundancy{1};
+  binance::order_book_config_t book_config{};
+  std::vector<std::string> stream_names{"miniTicker"};
+  binance::kline_config_t kline_config{};
+  std::string kline_source{"miniTicker"};
+  std::string kline_directory{};
+  binance::rolling_stats_config_t rolling_config{};
+  std::vector<std::string> rolling_windows{};
+  std::string rolling_source{"miniTicker"};
+  binance::cross_rates_config_t cross_rates_config{};
+  std::string cross_rates_source{"miniTicker"};
+  binance::arbitrage_config_t arbitrage_config{};
+  std::string arbitrage_source{"miniTicker"};
+  binance::price_history_config_t history_config{};
+  std::string history_source{"miniTicker"};
+  std::string query_address{"127.0.0.1"};
+  std::uint16_t query_port{};
+  binance::state_snapshot_config_t snapshot_config{};
+  std::size_t snapshot_interval{10};
+  std::string record_directory{};
+  std::string replay_directory{};
+  double replay_speed{1.0};
+  bool track_latency{false};
+  bool conflate_ticks{false};
+  std::string task_results_filename{};
+  std::string task_source{"miniTicker"};
+
+  cli_parser.add_option(
+      "-s,--shards", shard_count,
+      "number of combined-stream connections, 0 for one !miniTicker@arr "
+      "stream",
+      true);
+  cli_parser.add_option(
+      "--streams", stream_names,
+      "per-symbol streams used with --shards(miniTicker, bookTicker, "
+      "aggTrade)",
+      true);
+  cli_parser.add_option(
+      "-r,--redundancy", redundancy,
+      "number of identical feeds per connection, the first copy of every "
+      "update wins",
+      true);
+  cli_parser.add_option("-b,--books", book_config.symbols,
+                        "symbols to keep a local order book for");
+  cli_parser.add_option("--book-depth", book_config.snapshot_depth,
+                        "levels fetched in order book snapshots", true);
+  cli_parser.add_option(
+      "--klines", kline_config.history_size,
+      "closed 1s/1m/5m/1h candles kept per symbol and interval, 0 to not "
+      "build candles",
+      true);
+  cli_parser.add_option("--kline-source", kline_source,
+                        "stream the candles are built from, aggTrade for "
+                        "volumes",
+                        true);
+  cli_parser.add_option("--kline-dir", kline_directory,
+                        "directory the closed candles are appended to");
+  cli_parser.add_option("--rolling-windows", rolling_windows,
+                        "windows the rolling high, low, VWAP and realized "
+                        "range of every symbol are kept over, e.g. 5m 1h "
+                        "24h");
+  cli_parser.add_option("--rolling-buckets", rolling_config.bucket_count,
+                        "time buckets per rolling window, the precision of "
+                        "its start",
+                        true);
+  cli_parser.add_option("--rolling-source", rolling_source,
+                        "stream the rolling statistics are computed from, "
+                        "aggTrade for volumes",
+                        true);
+  cli_parser.add_option("--home-currencies", cross_rates_config.home_currencies,
+                        "currencies every asset gets an implied price in "
+                        "through the listed pairs, e.g. EUR USDT");
+  cli_parser.add_option("--cross-rate-source", cross_rates_source,
+                        "stream the implied prices are derived from, "
+                        "bookTicker for mid prices",
+                        true);
+  cli_parser.add_option("--arbitrage-from", arbitrage_config.anchors,
+                        "assets the 3- and 4-leg arbitrage cycles start "
+                        "and end in, e.g. USDT");
+  cli_parser.add_option("--arbitrage-fee", arbitrage_config.fee,
+                        "fee paid on every leg of a cycle", true);
+  cli_parser.add_option("--arbitrage-min-profit", arbitrage_config.min_profit,
+                        "profit after fees a cycle is reported from, e.g. "
+                        "0.001 for 0.1%",
+                        true);
+  cli_parser.add_option("--arbitrage-source", arbitrage_source,
+                        "stream the arbitrage cycles are evaluated with",
+                        true);
+  cli_parser.add_option("--history", history_config.directory,
+                        "directory the compressed price history of every "
+                        "symbol is kept in");
+  cli_parser.add_option("--history-source", history_source,
+                        "stream whose prices are kept in the history", true);
+  cli_parser.add_option("--query-port", query_port,
+                        "port the price history is served on over HTTP, 0 "
+                        "to not serve it",
+                        true);
+  cli_parser.add_option("--query-address", query_address,
+                        "address the price history is served on", true);
+  cli_parser.add_option("--snapshot", snapshot_config.filename,
+                        "file the symbols, prices and open candles are "
+                        "snapshotted to, and restored from on start");
+  cli_parser.add_option("--snapshot-interval", snapshot_interval,
+                        "seconds between two state snapshots", true);
+  cli_parser.add_option("--record", record_directory,
+                        "directory the raw market data frames are captured "
+                        "to");
+  cli_parser.add_option("--replay", replay_directory,
+                        "replay the frames captured in this directory "
+                        "instead of connecting to Binance");
+  cli_parser.add_option(
+      "--replay-speed", replay_speed,
+      "1 replays at the recorded pace, N N times faster, 0 as fast as "
+      "possible",
+      true);
+  cli_parser.add_flag("--latency", track_latency,
+                      "time every stage of the price pipeline, SIGUSR1 "
+                      "dumps the histograms and SIGUSR2 resets them");
+  cli_parser.add_option("--task-results", task_results_filename,
+                        "file the task results are appended to as JSON "
+                        "lines, they are logged otherwise");
+  cli_parser.add_option("--task-source", task_source,
+                        "stream the price_changes and profit_and_loss tasks "
+                        "are evaluated against",
+                        true);
+  cli_parser.add_flag("--conflate", conflate_ticks,
+                      "only apply the latest tick of every symbol and "
+                      "stream when the price saver falls behind; candles "
+                      "then miss the intermediate highs and lows");
+  auto &endpoints = binance::exchange_endpoints();
+  cli_parser.add_option("--rest-host", endpoints.rest_api_host,
+                        "host of the REST API, e.g. a local binance_mock",
+                        true);
+  cli_parser.add_option("--rest-port", endpoints.rest_api_port,
+                        "port of the REST API", true);
+  cli_parser.add_option("--ws-host", endpoints.ws_host,
+                        "host of the websocket streams", true);
+  cli_parser.add_option("--ws-port", endpoints.ws_port,
+                        "port of the websocket streams", true);
+  CLI11_PARSE(cli_parser, argc, argv);
+
   spdlog::info(
       "binance_prices: a system for monitoring crypto prices on Binance");
 
+  // a replay must leave the files of the live instance alone: it would
+  // restore and overwrite its state, and append old ticks and candles
+  bool const replaying = !replay_directory.empty();
+  if (replaying && (!kline_directory.empty() ||
+                    !snapshot_config.filename.empty() ||
+                    !history_config.directory.empty())) {
+    spdlog::warn("--kline-dir, --snapshot and --history are ignored when "
+                 "replaying");
+    kline_directory.clear();
+    snapshot_config.filename.clear();
+    history_config.directory.clear();
+  }
+
+  if (auto const type = binance::string_to_stream_type(kline_source); !type) {
+    spdlog::error("unknown stream type '{}'", kline_source);
+    return EXIT_FAILURE;
+  } else {
+    kline_config.source = *type;
+  }
+  auto &kline_builder = binance::request_handler_t::get_kline_builder();
+  kline_builder.configure(kline_config);
+  std::optional<binance::kline_writer_t> kline_writer{};
+  if (kline_builder.enabled() && !kline_directory.empty()) {
+    kline_writer.emplace(kline_directory).run(kline_builder);
+  }
+
+  for (auto const &window : rolling_windows) {
+    auto const window_ms = binance::string_to_window_ms(window);
+    if (!window_ms) {
+      spdlog::error("invalid rolling window '{}'", window);
+      return EXIT_FAILURE;
+    }
+    rolling_config.windows_ms.push_back(*window_ms);
+  }
+  if (auto const type = binance::string_to_stream_type(rolling_source);
+      !type) {
+    spdlog::error("unknown stream type '{}'", rolling_source);
+    return EXIT_FAILURE;
+  } else {
+    rolling_config.source = *type;
+  }
+  binance::request_handler_t::get_rolling_stats().configure(
+      std::move(rolling_config));
+
+  if (auto const type = binance::string_to_stream_type(cross_rates_source);
+      !type) {
+    spdlog::error("unknown stream type '{}'", cross_rates_source);
+    return EXIT_FAILURE;
+  } else {
+    cross_rates_config.source = *type;
+  }
+  if (!binance::request_handler_t::get_cross_rates().configure(
+          std::move(cross_rates_config))) {
+    return EXIT_FAILURE;
+  }
+
+  if (auto const type = binance::string_to_stream_type(arbitrage_source);
+      !type) {
+    spdlog::error("unknown stream type '{}'", arbitrage_source);
+    return EXIT_FAILURE;
+  } else {
+    arbitrage_config.source = *type;
+  }
+  auto &arbitrage_detector =
+      binance::request_handler_t::get_arbitrage_detector();
+  arbitrage_detector.configure(std::move(arbitrage_config));
+  arbitrage_detector.subscribe(
+      [](binance::arbitrage_opportunity_t const &opportunity) {
+        spdlog::info("arbitrage: {}",
+                     binance::arbitrage_to_string(
+                         binance::request_handler_t::get_symbol_registry(),
+                         opportunity));
+      });
+
+  // restores the open candles too, so the kline builder is configured first
+  auto &state_snapshot = binance::request_handler_t::get_state_snapshot();
+  snapshot_config.interval = std::chrono::seconds(snapshot_interval);
+  state_snapshot.configure(std::move(snapshot_config));
+  if (state_snapshot.enabled()) {
+    state_snapshot.load();
+    state_snapshot.run();
+  }
+
+  if (auto const type = binance::string_to_stream_type(history_source);
+      !type) {
+    spdlog::error("unknown stream type '{}'", history_source);
+    return EXIT_FAILURE;
+  } else {
+    history_config.source = *type;
+  }
+  auto &price_history = binance::request_handler_t::get_price_history();
+  price_history.configure(std::move(history_config));
+  if (price_history.enabled() && !price_history.run()) {
+    return EXIT_FAILURE;
+  }
+  binance::query_server_t query_server{};
+  if (query_port != 0 && !query_server.run(query_address, query_port)) {
+    return EXIT_FAILURE;
+  }
+
+  binance::request_handler_t::set_conflating_ticks(conflate_ticks);
+
+  if (auto const type = binance::string_to_stream_type(task_source); !type) {
+    spdlog::error("unknown stream type '{}'", task_source);
+    return EXIT_FAILURE;
+  } else {
+    binance::price_thresholds_config_t thresholds_config{};
+    thresholds_config.source = *type;
+    binance::request_handler_t::get_price_thresholds().configure(
+        thresholds_config);
+    binance::pnl_engine_config_t pnl_config{};
+    pnl_config.source = *type;
+    binance::request_handler_t::get_pnl_engine().configure(pnl_config);
+  }
+  binance::task_result_writer_t task_result_writer{task_results_filename};
+  task_result_writer.run(binance::request_handler_t::get_price_thresholds(),
+                         binance::request_handler_t::get_pnl_engine());
+  spdlog::info("PnL kernel: {}", binance::pnl_kernel_name());
+  binance::request_handler_t::get_task_monitor().run();
+
+  auto &latency = binance::request_handler_t::get_pipeline_latency();
+  if (track_latency) {
+    latency.enable(true);
+    binance::watch_latency_signals(latency);
+  }
+
   std::thread price_monitorer{binance::background_price_saver};
   price_monitorer.detach();
 
@@ -18,8 +299,62 @@ int main(int argc, char *argv[]) {
   ssl_context.set_default_verify_paths();
   ssl_context.set_verify_mode(net::ssl::verify_none);
 
-  std::unique_ptr<binance::market_data_stream_t> websock;
-  binance::launch_price_watcher(websock, io_context, ssl_context);
+  if (replaying) {
+    binance::frame_replayer_t replayer{replay_directory, "market_data"};
+    auto const started_at = std::chrono::steady_clock::now();
+    auto const frame_count = binance::replay_recorded_frames(
+        replayer, replay_speed, io_context, ssl_context);
+    auto const elapsed = std::chrono::steady_clock::now() - started_at;
+    spdlog::info(
+        "replayed {} frames in {} ms", frame_count,
+        std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    binance::wait_for_price_saver();
+    if (latency.enabled()) {
+      latency.dump();
+    }
+    return EXIT_SUCCESS;
+  }
+
+  if (!record_directory.empty()) {
+    auto recorder = std::make_unique<binance::frame_recorder_t>(
+        record_directory, "market_data");
+    if (!recorder->open()) {
+      return EXIT_FAILURE;
+    }
+    binance::request_handler_t::set_frame_recorder(std::move(recorder));
+  }
+
+  binance::order_book_engine_t book_engine{ssl_context,
+                                           std::move(book_config)};
+  if (!book_engine.run()) {
+    return EXIT_FAILURE;
+  }
+
+  if (shard_count != 0) {
+    binance::shard_config_t config{};
+    config.shard_count = shard_count;
+    config.redundancy = redundancy;
+    config.stream_types.clear();
+    for (auto const &name : stream_names) {
+      auto const type = binance::string_to_stream_type(name);
+      if (!type) {
+        spdlog::error("unknown stream type '{}'", name);
+        return EXIT_FAILURE;
+      }
+      config.stream_types.push_back(*type);
+    }
+
+    binance::market_data_shards_t shards{ssl_context, std::move(config)};
+    if (!shards.run()) {
+      return EXIT_FAILURE;
+    }
+    shards.join();
+    return EXIT_SUCCESS;
+  }
+
+  std::vector<std::unique_ptr<binance::market_data_stream_t>> websocks{};
+  binance::launch_price_watcher(websocks, io_context, ssl_context,
+                                redundancy);
 
   io_context.run();
   return EXIT_SUCCESS;
@@ -0,0 +1,258 @@
+#include "arbitrage_detector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <spdlog/spdlog.h>
+#include <string_view>
+#include <unordered_map>
+
+namespace binance {
+
+namespace {
+
+// a symbol seen from one of its assets
+struct edge_t {
+  std::uint32_t asset{};
+  symbol_id_t symbol_id{invalid_symbol_id};
+  bool sell{}; // going to `asset` sells the symbol's base
+};
+
+std::uint64_t pair_key(std::uint32_t const from, std::uint32_t const to) {
+  return (std::uint64_t{from} << 32) | to;
+}
+
+} // namespace
+
+arbitrage_detector_t::arbitrage_detector_t(symbol_registry_t const &symbols)
+    : symbols_{symbols},
+      rates_{std::make_unique<double[]>(symbol_registry_t::max_symbols)} {}
+
+void arbitrage_detector_t::configure(arbitrage_config_t config) {
+  config_ = std::move(config);
+}
+
+void arbitrage_detector_t::subscribe(arbitrage_subscriber_t subscriber) {
+  subscribers_.push_back(std::move(subscriber));
+}
+
+void arbitrage_detector_t::load_symbols() {
+  if (!enabled() || symbols_.size() == loaded_symbol_count_) {
+    return;
+  }
+  loaded_symbol_count_ = symbols_.size();
+  enumerate_cycles();
+}
+
+void arbitrage_detector_t::enumerate_cycles() {
+  auto const started_at = std::chrono::steady_clock::now();
+  auto const symbol_count = loaded_symbol_count_;
+
+  // the asset graph, with the assets numbered in the order they are met
+  std::unordered_map<std::string_view, std::uint32_t> asset_ids{};
+  std::vector<std::vector<edge_t>> adjacency{};
+  std::unordered_map<std::uint64_t, edge_t> pairs{};
+  auto intern = [&](std::string_view const asset) {
+    auto const [iter, inserted] = asset_ids.emplace(
+        asset, static_cast<std::uint32_t>(asset_ids.size()));
+    if (inserted) {
+      adjacency.emplace_back();
+    }
+    return iter->second;
+  };
+  for (std::size_t i = 0; i != symbol_count; ++i) {
+    auto const id = static_cast<symbol_id_t>(i);
+    auto const pair = split_symbol(symbols_.name(id), config_.quote_assets);
+    if (!pair) {
+      continue;
+    }
+    auto const base = intern(pair->base);
+    auto const quote = intern(pair->quote);
+    adjacency[base].push_back({quote, id, true});
+    adjacency[quote].push_back({base, id, false});
+    pairs.emplace(pair_key(base, quote), edge_t{quote, id, true});
+    pairs.emplace(pair_key(quote, base), edge_t{base, id, false});
+  }
+
+  std::vector<std::uint32_t> anchors{};
+  for (auto const &anchor : config_.anchors) {
+    if (auto const iter = asset_ids.find(anchor); iter != asset_ids.end()) {
+      anchors.push_back(iter->second);
+    } else {
+      spdlog::warn("no listed symbol has '{}' as an asset", anchor);
+    }
+  }
+
+  // every cycle is found once: it starts at its first anchor and goes to
+  // its lower-numbered neighbour of that anchor first
+  cycles_.clear();
+  std::size_t three_leg_count{};
+  bool truncated = false;
+  auto add_cycle = [&](std::initializer_list<edge_t> const legs) {
+    if (cycles_.size() == config_.max_cycles) {
+      truncated = true;
+      return;
+    }
+    cycle_t cycle{};
+    for (auto const &leg : legs) {
+      cycle.symbols[cycle.leg_count] = leg.symbol_id;
+      cycle.sells |= static_cast<std::uint8_t>(leg.sell << cycle.leg_count);
+      ++cycle.leg_count;
+    }
+    cycle.threshold = (1.0 + config_.min_profit) /
+                      std::pow(1.0 - config_.fee, cycle.leg_count);
+    cycles_.push_back(cycle);
+  };
+  for (std::size_t k = 0; k != anchors.size() && !truncated; ++k) {
+    auto const anchor = anchors[k];
+    auto const is_earlier_anchor = [&](std::uint32_t const asset) {
+      return std::find(anchors.cbegin(), anchors.cbegin() + k, asset) !=
+             anchors.cbegin() + k;
+    };
+    auto const closing_leg = [&](std::uint32_t const from) -> edge_t const * {
+      auto const iter = pairs.find(pair_key(from, anchor));
+      return iter == pairs.end() ? nullptr : &iter->second;
+    };
+
+    for (auto const &first : adjacency[anchor]) {
+      auto const x = first.asset;
+      if (is_earlier_anchor(x)) {
+        continue;
+      }
+      for (auto const &second : adjacency[x]) {
+        auto const y = second.asset;
+        if (y == anchor || is_earlier_anchor(y)) {
+          continue;
+        }
+        if (auto const last = closing_leg(y); last != nullptr && x < y) {
+          add_cycle({first, second, *last});
+          ++three_leg_count;
+        }
+        for (auto const &third : adjacency[y]) {
+          auto const z = third.asset;
+          if (z == anchor || z <= x || is_earlier_anchor(z)) {
+            continue;
+          }
+          if (auto const last = closing_leg(z); last != nullptr) {
+            add_cycle({first, second, third, *last});
+          }
+        }
+      }
+    }
+  }
+  if (truncated) {
+    spdlog::warn("stopped enumerating the arbitrage cycles at {}",
+                 config_.max_cycles);
+  }
+
+  // the symbol -> cycles index
+  cycle_offsets_.assign(symbol_count + 1, 0);
+  for (auto const &cycle : cycles_) {
+    for (std::uint8_t i = 0; i != cycle.leg_count; ++i) {
+      ++cycle_offsets_[cycle.symbols[i] + 1];
+    }
+  }
+  for (std::size_t i = 0; i != symbol_count; ++i) {
+    cycle_offsets_[i + 1] += cycle_offsets_[i];
+  }
+  cycle_ids_.resize(cycle_offsets_.back());
+  std::vector<std::uint32_t> next{cycle_offsets_.cbegin(),
+                                  cycle_offsets_.cend() - 1};
+  for (std::size_t c = 0; c != cycles_.size(); ++c) {
+    auto &cycle = cycles_[c];
+    for (std::uint8_t i = 0; i != cycle.leg_count; ++i) {
+      cycle_ids_[next[cycle.symbols[i]]++] = static_cast<std::uint32_t>(c);
+    }
+    evaluate(cycle, 0, false);
+  }
+
+  auto const elapsed = std::chrono::steady_clock::now() - started_at;
+  spdlog::info(
+      "{} 3-leg and {} 4-leg arbitrage cycles among {} symbols, enumerated "
+      "in {} ms",
+      three_leg_count, cycles_.size() - three_leg_count, symbol_count,
+      std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+void arbitrage_detector_t::evaluate(cycle_t &cycle,
+                                    std::uint64_t const event_time,
+                                    bool const publish) {
+  double product = 1.0;
+  for (std::uint8_t i = 0; i != cycle.leg_count; ++i) {
+    auto const rate = rates_[cycle.symbols[i]];
+    if (rate == 0) {
+      cycle.product = 0;
+      cycle.open = false;
+      return;
+    }
+    product *= (cycle.sells >> i) & 1 ? rate : 1.0 / rate;
+  }
+  cycle.product = product;
+
+  bool const forward = product > cycle.threshold;
+  bool const backward = product * cycle.threshold < 1.0;
+  bool const was_open = cycle.open;
+  cycle.open = forward || backward;
+  if (!cycle.open || was_open || !publish) {
+    return;
+  }
+
+  arbitrage_opportunity_t opportunity{};
+  opportunity.leg_count = cycle.leg_count;
+  opportunity.event_time = event_time;
+  opportunity.gross_product = forward ? product : 1.0 / product;
+  opportunity.net_product = opportunity.gross_product *
+                            std::pow(1.0 - config_.fee, cycle.leg_count);
+  for (std::uint8_t i = 0; i != cycle.leg_count; ++i) {
+    // the other way round, the legs are traded in reverse and each trade
+    // is reversed
+    auto const leg = forward ? i : cycle.leg_count - 1 - i;
+    bool const sell = ((cycle.sells >> leg) & 1) == forward;
+    opportunity.legs[i] = {cycle.symbols[leg], sell ? trade_direction_e::sell
+                                                    : trade_direction_e::buy};
+  }
+  ++published_count_;
+  for (auto const &subscriber : subscribers_) {
+    subscriber(opportunity);
+  }
+}
+
+void arbitrage_detector_t::on_tick(pushed_subscription_data_t const &tick) {
+  if (!enabled() || tick.stream_type != config_.source ||
+      tick.symbol_id >= symbol_registry_t::max_symbols ||
+      tick.current_price <= decimal_t{}) {
+    return;
+  }
+  auto const price = tick.current_price.to_double();
+  auto &rate = rates_[tick.symbol_id];
+  if (rate == price) {
+    return;
+  }
+  rate = price;
+  // symbols registered since the enumeration are in no cycle yet
+  if (tick.symbol_id + std::size_t{1} >= cycle_offsets_.size()) {
+    return;
+  }
+  auto const first = cycle_offsets_[tick.symbol_id];
+  auto const last = cycle_offsets_[tick.symbol_id + 1];
+  for (auto i = first; i != last; ++i) {
+    evaluate(cycles_[cycle_ids_[i]], tick.event_time, true);
+  }
+}
+
+std::string arbitrage_to_string(symbol_registry_t const &symbols,
+                                arbitrage_opportunity_t const &opportunity) {
+  std::string result{};
+  for (std::uint32_t i = 0; i != opportunity.leg_count; ++i) {
+    auto const &leg = opportunity.legs[i];
+    fmt::format_to(std::back_inserter(result), "{}{} {}", i == 0 ? "" : ", ",
+                   symbols.name(leg.symbol_id),
+                   direction_to_string(leg.direction));
+  }
+  fmt::format_to(std::back_inserter(result), ": {:+.3f}%",
+                 (opportunity.net_product - 1.0) * 100.0);
+  return result;
+}
+
+} // namespace binance
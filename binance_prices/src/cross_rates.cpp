@@ -0,0 +1,211 @@
+#include "cross_rates.hpp"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+std::vector<std::string> default_quote_assets() {
+  return {"USDT", "BUSD", "USDC", "FDUSD", "TUSD", "USDP", "DAI",  "BTC",
+          "ETH",  "BNB",  "XRP",  "TRX",   "DOGE", "DOT",  "EUR",  "GBP",
+          "AUD",  "BRL",  "TRY",  "RUB",   "UAH",  "NGN",  "ZAR",  "PLN",
+          "RON",  "ARS",  "JPY",  "MXN",   "COP",  "CZK",  "BIDR", "IDRT"};
+}
+
+std::optional<asset_pair_t>
+split_symbol(std::string_view const symbol,
+             std::vector<std::string> const &quote_assets) {
+  // DOGEFDUSD is DOGE in FDUSD, not DOGEF in DUSD
+  std::optional<asset_pair_t> pair{};
+  for (std::string_view const quote : quote_assets) {
+    if (symbol.size() > quote.size() &&
+        (!pair || quote.size() > pair->quote.size()) &&
+        symbol.compare(symbol.size() - quote.size(), quote.size(), quote) ==
+            0) {
+      pair = asset_pair_t{symbol.substr(0, symbol.size() - quote.size()),
+                          symbol.substr(symbol.size() - quote.size())};
+    }
+  }
+  return pair;
+}
+
+cross_rates_t::cross_rates_t(symbol_registry_t const &symbols)
+    : symbols_{symbols},
+      listings_{std::make_unique<listing_t[]>(symbol_registry_t::max_symbols)},
+      rates_{std::make_unique<double[]>(symbol_registry_t::max_symbols)} {}
+
+bool cross_rates_t::configure(cross_rates_config_t config) {
+  config_ = std::move(config);
+  adjacency_.resize(max_assets);
+
+  for (auto const &currency : config_.home_currencies) {
+    auto const root = assets_.get_or_insert(currency);
+    if (root == invalid_asset_id || root >= max_assets) {
+      spdlog::error("unable to register the home currency '{}'", currency);
+      return false;
+    }
+    if (std::any_of(trees_.cbegin(), trees_.cend(),
+                    [root](auto const &tree) { return tree.root == root; })) {
+      continue;
+    }
+    auto &tree = trees_.emplace_back();
+    tree.root = root;
+    tree.nodes = std::make_unique<node_t[]>(max_assets);
+    tree.child_by_symbol =
+        std::make_unique<asset_id_t[]>(symbol_registry_t::max_symbols);
+    std::fill_n(tree.child_by_symbol.get(), symbol_registry_t::max_symbols,
+                invalid_asset_id);
+    tree.prices = std::make_unique<std::atomic<double>[]>(max_assets);
+    tree.nodes[root].depth = 0;
+    tree.prices[root].store(1.0, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+bool cross_rates_t::list(symbol_id_t const id) {
+  auto &listing = listings_[id];
+  listing.state = listing_e::ignored;
+  auto const &name = symbols_.name(id);
+  auto const pair = split_symbol(name, config_.quote_assets);
+  if (!pair) {
+    return false;
+  }
+  auto const base_id = assets_.get_or_insert(pair->base);
+  auto const quote_id = assets_.get_or_insert(pair->quote);
+  if (base_id >= max_assets || quote_id >= max_assets) {
+    spdlog::error("unable to register the assets of '{}'", name);
+    return false;
+  }
+  listing.state = listing_e::listed;
+  listing.base = base_id;
+  listing.quote = quote_id;
+  adjacency_[base_id].push_back({quote_id, id, true});
+  adjacency_[quote_id].push_back({base_id, id, false});
+  return true;
+}
+
+double cross_rates_t::rate(symbol_id_t const id, bool const is_base) const {
+  return is_base ? rates_[id] : 1.0 / rates_[id];
+}
+
+void cross_rates_t::reparent(tree_t &tree, asset_id_t const asset,
+                             asset_id_t const parent,
+                             adjacent_t const &edge) {
+  auto &node = tree.nodes[asset];
+  if (node.parent != invalid_asset_id) {
+    auto &siblings = tree.nodes[node.parent].children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), asset));
+    tree.child_by_symbol[node.symbol_id] = invalid_asset_id;
+  }
+  node.parent = parent;
+  node.symbol_id = edge.symbol_id;
+  node.is_base = !edge.is_quote;
+  node.depth = tree.nodes[parent].depth + 1;
+  tree.nodes[parent].children.push_back(asset);
+  tree.child_by_symbol[edge.symbol_id] = asset;
+}
+
+bool cross_rates_t::add_edge(tree_t &tree, symbol_id_t const id) {
+  auto const &listing = listings_[id];
+  auto const &nodes = tree.nodes;
+  // a breadth-first search from the assets the edge brings closer to the
+  // root, which stops where the tree already had a path as short
+  scratch_.clear();
+  auto const relax = [&](asset_id_t const from, adjacent_t const &edge) {
+    if (nodes[from].depth != unreached &&
+        nodes[from].depth + 1 < nodes[edge.asset].depth) {
+      reparent(tree, edge.asset, from, edge);
+      scratch_.push_back(edge.asset);
+    }
+  };
+  relax(listing.base, {listing.quote, id, true});
+  relax(listing.quote, {listing.base, id, false});
+  for (std::size_t i = 0; i != scratch_.size(); ++i) {
+    auto const asset = scratch_[i];
+    for (auto const &edge : adjacency_[asset]) {
+      relax(asset, edge);
+    }
+  }
+  return !scratch_.empty();
+}
+
+void cross_rates_t::reprice(tree_t &tree, asset_id_t const asset) {
+  scratch_.clear();
+  scratch_.push_back(asset);
+  while (!scratch_.empty()) {
+    auto const current = scratch_.back();
+    scratch_.pop_back();
+    auto const &node = tree.nodes[current];
+    if (current != tree.root) {
+      tree.prices[current].store(
+          tree.prices[node.parent].load(std::memory_order_relaxed) *
+              rate(node.symbol_id, node.is_base),
+          std::memory_order_relaxed);
+    }
+    scratch_.insert(scratch_.end(), node.children.cbegin(),
+                    node.children.cend());
+  }
+}
+
+void cross_rates_t::on_tick(pushed_subscription_data_t const &tick) {
+  if (!enabled() || tick.stream_type != config_.source ||
+      tick.symbol_id >= symbol_registry_t::max_symbols ||
+      tick.current_price <= decimal_t{}) {
+    return;
+  }
+
+  auto const id = tick.symbol_id;
+  auto const price = tick.current_price.to_double();
+  auto const state = listings_[id].state;
+  if (state == listing_e::unseen) {
+    rates_[id] = price;
+    if (list(id)) {
+      for (auto &tree : trees_) {
+        // a new edge changes the paths, so the whole tree is re-derived
+        if (add_edge(tree, id)) {
+          reprice(tree, tree.root);
+        }
+      }
+    }
+    return;
+  }
+  if (state == listing_e::ignored || rates_[id] == price) {
+    return;
+  }
+
+  rates_[id] = price;
+  for (auto &tree : trees_) {
+    if (auto const asset = tree.child_by_symbol[id];
+        asset != invalid_asset_id) {
+      reprice(tree, asset);
+    }
+  }
+}
+
+std::optional<double>
+cross_rates_t::implied_price(asset_id_t const base,
+                             asset_id_t const quote) const {
+  if (base >= max_assets || quote >= max_assets) {
+    return std::nullopt;
+  }
+  if (base == quote) {
+    return 1.0;
+  }
+  for (auto const &tree : trees_) {
+    auto const base_price = tree.prices[base].load(std::memory_order_relaxed);
+    auto const quote_price =
+        tree.prices[quote].load(std::memory_order_relaxed);
+    if (base_price > 0 && quote_price > 0) {
+      return base_price / quote_price;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<double>
+cross_rates_t::implied_price(std::string_view const base,
+                             std::string_view const quote) const {
+  return implied_price(find_asset(base), find_asset(quote));
+}
+
+} // namespace binance
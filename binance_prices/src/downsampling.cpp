@@ -0,0 +1,163 @@
+#include "downsampling.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace binance {
+
+namespace {
+
+struct average_t {
+  double x{};
+  double y{};
+};
+
+average_t average(std::vector<price_point_t> const &points,
+                  std::uint64_t const origin) {
+  average_t result{};
+  for (auto const &point : points) {
+    result.x += static_cast<double>(point.time - origin);
+    result.y += point.price.to_double();
+  }
+  result.x /= static_cast<double>(points.size());
+  result.y /= static_cast<double>(points.size());
+  return result;
+}
+
+} // namespace
+
+std::optional<downsampling_e>
+string_to_downsampling(std::string_view const name) {
+  if (name == "none") {
+    return downsampling_e::none;
+  }
+  if (name == "minmax") {
+    return downsampling_e::min_max;
+  }
+  if (name == "lttb") {
+    return downsampling_e::lttb;
+  }
+  return std::nullopt;
+}
+
+char const *downsampling_to_string(downsampling_e const method) {
+  switch (method) {
+  case downsampling_e::none:
+    return "none";
+  case downsampling_e::min_max:
+    return "minmax";
+  case downsampling_e::lttb:
+    return "lttb";
+  }
+  return "none";
+}
+
+downsampler_t::downsampler_t(downsampling_e const method,
+                             std::uint64_t const origin,
+                             std::uint64_t const bucket_width)
+    : method_{method}, origin_{origin},
+      bucket_width_{std::max<std::uint64_t>(bucket_width, 1)} {}
+
+void downsampler_t::add(price_point_t const &point,
+                        std::vector<price_point_t> &out) {
+  if (method_ == downsampling_e::none) {
+    out.push_back(point);
+    return;
+  }
+  auto const bucket =
+      (std::max(point.time, origin_) - origin_) / bucket_width_;
+  if (!has_points_) {
+    has_points_ = true;
+    bucket_ = bucket;
+    min_ = max_ = point;
+    if (method_ == downsampling_e::lttb) {
+      // the first point is always kept
+      out.push_back(point);
+      selected_ = point;
+    }
+    return;
+  }
+  if (bucket != bucket_) {
+    close_bucket(out);
+    bucket_ = bucket;
+    min_ = max_ = point;
+  } else if (point.price < min_.price) {
+    min_ = point;
+  } else if (point.price > max_.price) {
+    max_ = point;
+  }
+  if (method_ == downsampling_e::lttb) {
+    current_.push_back(point);
+  }
+}
+
+void downsampler_t::close_bucket(std::vector<price_point_t> &out) {
+  if (method_ == downsampling_e::min_max) {
+    if (min_.time == max_.time) {
+      out.push_back(min_);
+    } else {
+      out.push_back(min_.time < max_.time ? min_ : max_);
+      out.push_back(min_.time < max_.time ? max_ : min_);
+    }
+    return;
+  }
+  if (!previous_.empty() && !current_.empty()) {
+    auto const next = average(current_, origin_);
+    select(previous_, next.x, next.y, out);
+  }
+  previous_.swap(current_);
+  current_.clear();
+}
+
+void downsampler_t::select(std::vector<price_point_t> const &bucket,
+                           double const next_x, double const next_y,
+                           std::vector<price_point_t> &out) {
+  auto const x = static_cast<double>(selected_.time - origin_);
+  auto const y = selected_.price.to_double();
+  auto best = bucket.cbegin();
+  double best_area = -1.0;
+  for (auto iter = bucket.cbegin(); iter != bucket.cend(); ++iter) {
+    // twice the area of the triangle, which ranks them all the same
+    auto const area = std::abs(
+        (x - next_x) * (iter->price.to_double() - y) -
+        (x - static_cast<double>(iter->time - origin_)) * (next_y - y));
+    if (area > best_area) {
+      best_area = area;
+      best = iter;
+    }
+  }
+  out.push_back(*best);
+  selected_ = *best;
+}
+
+void downsampler_t::finish(std::vector<price_point_t> &out) {
+  if (!has_points_ || method_ == downsampling_e::none) {
+    return;
+  }
+  has_points_ = false;
+  if (method_ == downsampling_e::min_max) {
+    close_bucket(out);
+    return;
+  }
+  if (current_.empty()) {
+    // only the first point, which was kept
+    return;
+  }
+  // the last point is always kept, and is the third vertex of the last
+  // bucket's triangles
+  if (!previous_.empty()) {
+    auto const next = average(current_, origin_);
+    select(previous_, next.x, next.y, out);
+    previous_.clear();
+  }
+  auto const last = current_.back();
+  current_.pop_back();
+  if (!current_.empty()) {
+    select(current_, static_cast<double>(last.time - origin_),
+           last.price.to_double(), out);
+    current_.clear();
+  }
+  out.push_back(last);
+}
+
+} // namespace binance
@@ -0,0 +1,37 @@
+#include "feed_arbiter.hpp"
+
+#include <algorithm>
+
+namespace binance {
+
+feed_arbiter_t::feed_arbiter_t()
+    : last_sequences_{std::make_unique<std::atomic<std::uint64_t>[]>(
+          symbol_registry_t::max_symbols * stream_type_count)} {}
+
+bool feed_arbiter_t::accept(pushed_subscription_data_t const &data) noexcept {
+  if (data.symbol_id >= symbol_registry_t::max_symbols) {
+    return false;
+  }
+  auto const index = data.symbol_id * stream_type_count +
+                     static_cast<std::size_t>(data.stream_type);
+  auto &last_sequence = last_sequences_[index];
+  auto current = last_sequence.load(std::memory_order_relaxed);
+  while (data.sequence > current) {
+    if (last_sequence.compare_exchange_weak(current, data.sequence,
+                                            std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void feed_arbiter_t::filter(
+    std::vector<pushed_subscription_data_t> &pushed_list) noexcept {
+  pushed_list.erase(std::remove_if(pushed_list.begin(), pushed_list.end(),
+                                   [this](auto const &data) {
+                                     return !accept(data);
+                                   }),
+                    pushed_list.end());
+}
+
+} // namespace binance
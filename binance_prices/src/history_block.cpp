@@ -0,0 +1,215 @@
+#include "history_block.hpp"
+#include "common/containers.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace binance {
+
+namespace {
+
+constexpr std::uint32_t stream_capacity =
+    static_cast<std::uint32_t>(sizeof(history_block_t::stream) * 8);
+// the worst case of a point after the first one: a 32-bit time difference
+// and a price with new leading and trailing zeros
+constexpr std::uint32_t max_point_bits = (4 + 32) + (2 + 5 + 6 + 64);
+// no previous leading zeros, so the first XOR always stores its own
+constexpr unsigned no_leading_zeros = 64;
+
+// the number of bits a delta-of-delta is stored in, after its prefix
+struct time_bucket_t {
+  std::uint64_t prefix;
+  unsigned prefix_bits;
+  unsigned value_bits;
+};
+
+constexpr time_bucket_t time_buckets[] = {
+    {0b10, 2, 7}, {0b110, 3, 9}, {0b1110, 4, 12}, {0b1111, 4, 32}};
+
+bool fits(std::int64_t const value, unsigned const bits) {
+  auto const limit = std::int64_t(1) << (bits - 1);
+  return value >= -limit && value < limit;
+}
+
+std::uint64_t low_bits(std::uint64_t const value, unsigned const count) {
+  return count == 64 ? value : value & ((std::uint64_t(1) << count) - 1);
+}
+
+std::int64_t sign_extend(std::uint64_t const value, unsigned const bits) {
+  auto const sign = std::uint64_t(1) << (bits - 1);
+  return static_cast<std::int64_t>((value ^ sign) - sign);
+}
+
+} // namespace
+
+void history_block_encoder_t::reset() {
+  std::memset(&block_, 0, sizeof(block_));
+  std::memcpy(block_.header.magic, history_block_magic,
+              sizeof(history_block_magic));
+  block_.header.version = history_block_version;
+  last_delta_ = 0;
+  last_price_ = 0;
+  leading_zeros_ = no_leading_zeros;
+  trailing_zeros_ = 0;
+}
+
+void history_block_encoder_t::write_bits(std::uint64_t const value,
+                                         unsigned count) {
+  auto &bit_length = block_.header.bit_length;
+  while (count != 0) {
+    auto const used = bit_length % 8;
+    auto const n = std::min(8 - used, count);
+    auto const bits =
+        static_cast<unsigned>((value >> (count - n)) & ((1u << n) - 1));
+    block_.stream[bit_length / 8] |=
+        static_cast<std::uint8_t>(bits << (8 - used - n));
+    bit_length += n;
+    count -= n;
+  }
+}
+
+bool history_block_encoder_t::write_time(std::uint64_t const time) {
+  auto const delta = time - block_.header.last_time;
+  auto const delta_of_delta = static_cast<std::int64_t>(delta - last_delta_);
+  if (delta_of_delta == 0) {
+    write_bits(0, 1);
+  } else {
+    auto const bucket = std::find_if(
+        std::begin(time_buckets), std::end(time_buckets),
+        [delta_of_delta](time_bucket_t const &bucket) {
+          return fits(delta_of_delta, bucket.value_bits);
+        });
+    if (bucket == std::end(time_buckets)) {
+      return false;
+    }
+    write_bits(bucket->prefix, bucket->prefix_bits);
+    write_bits(low_bits(static_cast<std::uint64_t>(delta_of_delta),
+                        bucket->value_bits),
+               bucket->value_bits);
+  }
+  last_delta_ = delta;
+  return true;
+}
+
+void history_block_encoder_t::write_price(std::uint64_t const price) {
+  auto const xored = price ^ last_price_;
+  last_price_ = price;
+  if (xored == 0) {
+    write_bits(0, 1);
+    return;
+  }
+  auto const leading_zeros =
+      std::min(detail::count_leading_zeros(xored), 31u);
+  auto const trailing_zeros = detail::count_trailing_zeros(xored);
+  if (leading_zeros >= leading_zeros_ && trailing_zeros >= trailing_zeros_) {
+    write_bits(0b10, 2);
+    write_bits(xored >> trailing_zeros_,
+               64 - leading_zeros_ - trailing_zeros_);
+    return;
+  }
+  auto const length = 64 - leading_zeros - trailing_zeros;
+  write_bits(0b11, 2);
+  write_bits(leading_zeros, 5);
+  write_bits(length - 1, 6);
+  write_bits(xored >> trailing_zeros, length);
+  leading_zeros_ = leading_zeros;
+  trailing_zeros_ = trailing_zeros;
+}
+
+bool history_block_encoder_t::append(std::uint64_t time,
+                                     decimal_t const price) {
+  auto &header = block_.header;
+  auto const units = price.units();
+  if (header.count == 0) {
+    write_bits(time, 64);
+    write_bits(static_cast<std::uint64_t>(units), 64);
+    last_price_ = static_cast<std::uint64_t>(units);
+    header.first_time = time;
+    header.last_time = time;
+    header.min_price = units;
+    header.max_price = units;
+    header.count = 1;
+    return true;
+  }
+
+  if (stream_capacity - header.bit_length < max_point_bits) {
+    return false;
+  }
+  time = std::max(time, header.last_time);
+  if (!write_time(time)) {
+    return false;
+  }
+  write_price(static_cast<std::uint64_t>(units));
+  header.last_time = time;
+  header.min_price = std::min(header.min_price, units);
+  header.max_price = std::max(header.max_price, units);
+  ++header.count;
+  return true;
+}
+
+std::uint64_t history_block_decoder_t::read_bits(unsigned count) {
+  std::uint64_t value{};
+  while (count != 0) {
+    auto const used = bit_position_ % 8;
+    auto const n = std::min(8 - used, count);
+    auto const byte = bit_position_ < stream_capacity
+                          ? block_.stream[bit_position_ / 8]
+                          : std::uint8_t{};
+    value = (value << n) | ((byte >> (8 - used - n)) & ((1u << n) - 1));
+    bit_position_ += n;
+    count -= n;
+  }
+  return value;
+}
+
+bool history_block_decoder_t::next(price_point_t &point) {
+  if (index_ == block_.header.count) {
+    return false;
+  }
+  if (index_ == 0) {
+    last_time_ = read_bits(64);
+    last_price_ = read_bits(64);
+    leading_zeros_ = no_leading_zeros;
+  } else {
+    std::int64_t delta_of_delta{};
+    if (read_bits(1) != 0) {
+      auto bucket = std::begin(time_buckets);
+      while (bucket + 1 != std::end(time_buckets) && read_bits(1) != 0) {
+        ++bucket;
+      }
+      delta_of_delta =
+          sign_extend(read_bits(bucket->value_bits), bucket->value_bits);
+    }
+    last_delta_ += static_cast<std::uint64_t>(delta_of_delta);
+    last_time_ += last_delta_;
+
+    if (read_bits(1) != 0) {
+      if (read_bits(1) != 0) {
+        leading_zeros_ = static_cast<unsigned>(read_bits(5));
+        auto const length = std::min(static_cast<unsigned>(read_bits(6)) + 1,
+                                     64 - leading_zeros_);
+        trailing_zeros_ = 64 - leading_zeros_ - length;
+      }
+      last_price_ ^= read_bits(64 - leading_zeros_ - trailing_zeros_)
+                     << trailing_zeros_;
+    }
+  }
+  if (bit_position_ > block_.header.bit_length) {
+    // a corrupted block
+    index_ = block_.header.count;
+    return false;
+  }
+  ++index_;
+  point.time = last_time_;
+  point.price = decimal_t::from_units(static_cast<std::int64_t>(last_price_));
+  return true;
+}
+
+bool is_valid_history_block(history_block_t const &block) {
+  return std::memcmp(block.header.magic, history_block_magic,
+                     sizeof(history_block_magic)) == 0 &&
+         block.header.version == history_block_version &&
+         block.header.count != 0 && block.header.bit_length <= stream_capacity;
+}
+
+} // namespace binance
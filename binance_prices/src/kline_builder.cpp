@@ -0,0 +1,220 @@
+#include "kline_builder.hpp"
+#include "symbol_registry.hpp"
+
+#include <algorithm>
+
+namespace binance {
+
+std::uint64_t interval_to_milliseconds(kline_interval_e const interval) {
+  switch (interval) {
+  case kline_interval_e::one_second:
+    return 1'000;
+  case kline_interval_e::one_minute:
+    return 60'000;
+  case kline_interval_e::five_minutes:
+    return 300'000;
+  case kline_interval_e::one_hour:
+    return 3'600'000;
+  }
+  return 60'000;
+}
+
+char const *kline_interval_to_string(kline_interval_e const interval) {
+  switch (interval) {
+  case kline_interval_e::one_second:
+    return "1s";
+  case kline_interval_e::one_minute:
+    return "1m";
+  case kline_interval_e::five_minutes:
+    return "5m";
+  case kline_interval_e::one_hour:
+    return "1h";
+  }
+  return "unknown";
+}
+
+std::optional<kline_interval_e> string_to_kline_interval(std::string_view str) {
+  for (std::size_t i = 0; i != kline_interval_count; ++i) {
+    auto const interval = static_cast<kline_interval_e>(i);
+    if (str == kline_interval_to_string(interval)) {
+      return interval;
+    }
+  }
+  return std::nullopt;
+}
+
+kline_builder_t::kline_builder_t()
+    : series_{std::make_unique<std::atomic<symbol_series_t *>[]>(
+          symbol_registry_t::max_symbols)} {}
+
+void kline_builder_t::configure(kline_config_t const &config) {
+  config_ = config;
+}
+
+void kline_builder_t::subscribe(kline_subscriber_t subscriber) {
+  subscribers_.push_back(std::move(subscriber));
+}
+
+kline_builder_t::symbol_series_t *
+kline_builder_t::get_or_create(symbol_id_t const id) {
+  auto *series = series_[id].load(std::memory_order_relaxed);
+  if (series != nullptr) {
+    return series;
+  }
+  auto &created = allocated_series_.emplace_back(
+      std::make_unique<symbol_series_t>());
+  // one spare slot for the bar being written while the others are read
+  for (auto &interval_series : *created) {
+    interval_series.closed_bars =
+        std::make_unique<seqlocked_t<kline_t>[]>(config_.history_size + 1);
+  }
+  series_[id].store(created.get(), std::memory_order_release);
+  return created.get();
+}
+
+kline_builder_t::symbol_series_t const *
+kline_builder_t::find(symbol_id_t const id) const {
+  if (id >= symbol_registry_t::max_symbols) {
+    return nullptr;
+  }
+  return series_[id].load(std::memory_order_acquire);
+}
+
+void kline_builder_t::close_bar(series_t &series) {
+  auto const &bar = series.open_bar;
+  auto const index = series.closed_count.load(std::memory_order_relaxed);
+  series.closed_bars[index % (config_.history_size + 1)].store(bar);
+  series.closed_count.store(index + 1, std::memory_order_release);
+  series.last_closed_open_time = bar.open_time;
+
+  for (auto const &subscriber : subscribers_) {
+    subscriber(bar);
+  }
+  series.open_bar.tick_count = 0;
+  series.published_open_bar.store(series.open_bar);
+}
+
+void kline_builder_t::restore_open_bar(kline_t const &bar) {
+  if (!enabled() || bar.symbol_id >= symbol_registry_t::max_symbols ||
+      bar.tick_count == 0 ||
+      static_cast<std::size_t>(bar.interval) >= kline_interval_count) {
+    return;
+  }
+  auto &series = (*get_or_create(bar.symbol_id))[static_cast<std::size_t>(
+      bar.interval)];
+  series.open_bar = bar;
+  series.published_open_bar.store(bar);
+}
+
+void kline_builder_t::on_tick(pushed_subscription_data_t const &tick) {
+  if (!enabled() || tick.stream_type != config_.source ||
+      tick.symbol_id >= symbol_registry_t::max_symbols ||
+      tick.event_time == 0) {
+    return;
+  }
+
+  auto &symbol_series = *get_or_create(tick.symbol_id);
+  for (std::size_t i = 0; i != kline_interval_count; ++i) {
+    auto &series = symbol_series[i];
+    auto &bar = series.open_bar;
+    auto const interval = static_cast<kline_interval_e>(i);
+    auto const open_time =
+        tick.event_time - tick.event_time % interval_to_milliseconds(interval);
+
+    if (bar.tick_count != 0 && open_time > bar.open_time) {
+      close_bar(series);
+    }
+    if ((bar.tick_count != 0 && open_time < bar.open_time) ||
+        (series.closed_count.load(std::memory_order_relaxed) != 0 &&
+         open_time <= series.last_closed_open_time)) {
+      // a tick that is late for an interval is late for 1s too
+      late_ticks_ += i == 0;
+      continue;
+    }
+
+    if (bar.tick_count == 0) {
+      bar.symbol_id = tick.symbol_id;
+      bar.interval = interval;
+      bar.open_time = open_time;
+      bar.last_event_time = tick.event_time;
+      bar.open = bar.high = bar.low = bar.close = tick.current_price;
+      bar.volume = decimal_sum_t{};
+    } else {
+      bar.high = std::max(bar.high, tick.current_price);
+      bar.low = std::min(bar.low, tick.current_price);
+      // a tick older than the last one moves the extremes but not the close
+      if (tick.event_time >= bar.last_event_time) {
+        bar.close = tick.current_price;
+        bar.last_event_time = tick.event_time;
+      }
+    }
+    bar.volume += tick.quantity;
+    ++bar.tick_count;
+    series.published_open_bar.store(bar);
+  }
+}
+
+void kline_builder_t::close_expired_bars(std::uint64_t const now_ms) {
+  if (!enabled()) {
+    return;
+  }
+  for (auto &symbol_series : allocated_series_) {
+    for (auto &series : *symbol_series) {
+      auto const &bar = series.open_bar;
+      if (bar.tick_count != 0 &&
+          bar.close_time() + config_.close_delay_ms < now_ms) {
+        close_bar(series);
+      }
+    }
+  }
+}
+
+std::optional<kline_t>
+kline_builder_t::open_bar(symbol_id_t const id,
+                          kline_interval_e const interval) const {
+  auto const *symbol_series = find(id);
+  if (symbol_series == nullptr) {
+    return std::nullopt;
+  }
+  auto bar = (*symbol_series)[static_cast<std::size_t>(interval)]
+                 .published_open_bar.load();
+  if (bar.tick_count == 0) {
+    return std::nullopt;
+  }
+  return bar;
+}
+
+std::size_t kline_builder_t::closed_bars(symbol_id_t const id,
+                                         kline_interval_e const interval,
+                                         std::size_t const count,
+                                         std::vector<kline_t> &result) const {
+  auto const *symbol_series = find(id);
+  if (symbol_series == nullptr || count == 0) {
+    return 0;
+  }
+  auto const &series = (*symbol_series)[static_cast<std::size_t>(interval)];
+  auto const slot_count = config_.history_size + 1;
+
+  auto const end = series.closed_count.load(std::memory_order_acquire);
+  auto begin =
+      end - std::min<std::uint64_t>({end, count, config_.history_size});
+  auto const first_index = result.size();
+  for (auto index = begin; index != end; ++index) {
+    result.push_back(series.closed_bars[index % slot_count].load());
+  }
+
+  // the writer may have wrapped around while we were copying, and may be
+  // writing bar `new_end` right now, over the slot of bar
+  // `new_end - slot_count`
+  auto const new_end = series.closed_count.load(std::memory_order_acquire);
+  if (new_end - begin >= slot_count) {
+    auto const overwritten = std::min<std::uint64_t>(
+        new_end - begin - slot_count + 1, end - begin);
+    result.erase(result.begin() + first_index,
+                 result.begin() + first_index + overwritten);
+    begin += overwritten;
+  }
+  return end - begin;
+}
+
+} // namespace binance
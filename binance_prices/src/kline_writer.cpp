@@ -0,0 +1,63 @@
+#include "kline_writer.hpp"
+#include "request_handler.hpp"
+
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+using namespace fmt::v7::literals;
+
+kline_writer_t::kline_writer_t(std::string directory)
+    : directory_{std::move(directory)}, bars_{16'384} {}
+
+void kline_writer_t::run(kline_builder_t &builder) {
+  builder.subscribe([this](kline_t const &bar) {
+    if (bars_.try_push_n(&bar, 1) == 0) {
+      dropped_bars_.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  thread_ = std::thread([this] { write_bars(); });
+  thread_.detach();
+}
+
+void kline_writer_t::write_bars() {
+  std::array<std::ofstream, kline_interval_count> files{};
+  for (std::size_t i = 0; i != kline_interval_count; ++i) {
+    auto const filename = "{}/klines_{}.csv"_format(
+        directory_, kline_interval_to_string(static_cast<kline_interval_e>(i)));
+    files[i].open(filename, std::ios::app);
+    if (!files[i]) {
+      spdlog::error("unable to open '{}', the closed bars won't be saved",
+                    filename);
+      return;
+    }
+  }
+
+  auto &symbols = request_handler_t::get_symbol_registry();
+  std::size_t const max_batch_size = 1'024;
+  std::vector<kline_t> bars{};
+  bars.reserve(max_batch_size);
+  fmt::memory_buffer line{};
+
+  while (true) {
+    bars.clear();
+    bars_.drain_up_to(bars, max_batch_size);
+    for (auto const &bar : bars) {
+      line.clear();
+      fmt::format_to(std::back_inserter(line), "{},{},{},{},{},{},{},{},{}\n",
+                     symbols.name(bar.symbol_id), bar.open_time,
+                     bar.close_time(), bar.open, bar.high, bar.low, bar.close,
+                     bar.volume, bar.tick_count);
+      files[static_cast<std::size_t>(bar.interval)].write(line.data(),
+                                                          line.size());
+    }
+    for (auto &file : files) {
+      file.flush();
+    }
+  }
+}
+
+} // namespace binance
@@ -0,0 +1,127 @@
+#include "market_data_shards.hpp"
+#include "request_handler.hpp"
+#include "ticker_decoder.hpp"
+
+#include <algorithm>
+
+namespace binance {
+
+std::vector<std::string>
+make_combined_stream_paths(symbol_registry_t const &symbols,
+                           std::vector<stream_type_e> const &stream_types,
+                           std::size_t shard_count) {
+  std::size_t const symbol_count = symbols.size();
+  if (symbol_count == 0 || stream_types.empty()) {
+    return {};
+  }
+
+  std::size_t const max_symbols_per_shard = std::max<std::size_t>(
+      1, market_data_shards_t::max_streams_per_connection /
+             stream_types.size());
+  shard_count = std::max(
+      {shard_count, std::size_t(1),
+       (symbol_count + max_symbols_per_shard - 1) / max_symbols_per_shard});
+  shard_count = std::min(shard_count, symbol_count);
+
+  std::vector<std::string> paths(shard_count, "/stream?streams=");
+  for (symbol_id_t id = 0; id != symbol_count; ++id) {
+    auto &path = paths[id % shard_count];
+    for (auto const type : stream_types) {
+      if (path.back() != '=') {
+        path += '/';
+      }
+      path += make_stream_name(symbols.name(id), stream_type_to_string(type));
+    }
+  }
+  return paths;
+}
+
+market_data_shards_t::market_data_shards_t(net::ssl::context &ssl_ctx,
+                                           shard_config_t config)
+    : ssl_ctx_{ssl_ctx}, config_{std::move(config)} {}
+
+market_data_shards_t::~market_data_shards_t() {
+  for (auto &shard : shards_) {
+    shard->io_context.stop();
+  }
+  if (bootstrap_) {
+    bootstrap_->io_context.stop();
+  }
+  join();
+}
+
+bool market_data_shards_t::fetch_instruments() {
+  stream_options_t options{};
+  options.ws_path.clear();
+  options.fetch_instruments = true;
+
+  net::io_context io_context{1};
+  market_data_stream_t bootstrap{io_context, ssl_ctx_, std::move(options)};
+  bootstrap.run();
+  io_context.run();
+  return request_handler_t::get_symbol_registry().size() != 0;
+}
+
+void market_data_shards_t::reconcile_instruments() {
+  stream_options_t options{};
+  options.ws_path.clear();
+  options.fetch_instruments = true;
+
+  bootstrap_ = std::make_unique<shard_t>();
+  bootstrap_->stream = std::make_unique<market_data_stream_t>(
+      bootstrap_->io_context, ssl_ctx_, std::move(options));
+  bootstrap_->stream->run();
+  bootstrap_->thread = std::thread(
+      [io_context = &bootstrap_->io_context] { io_context->run(); });
+}
+
+bool market_data_shards_t::run() {
+  if (request_handler_t::get_state_snapshot().restored()) {
+    reconcile_instruments();
+  } else if (!fetch_instruments()) {
+    spdlog::error("unable to fetch the listed instruments");
+    return false;
+  }
+
+  auto const paths =
+      make_combined_stream_paths(request_handler_t::get_symbol_registry(),
+                                 config_.stream_types, config_.shard_count);
+  auto const redundancy = std::max<std::size_t>(config_.redundancy, 1);
+  spdlog::info("splitting the market data streams over {} connections({} "
+               "feeds each)",
+               paths.size(), redundancy);
+
+  shards_.reserve(paths.size() * redundancy);
+  for (std::size_t shard_id = 0; shard_id != paths.size(); ++shard_id) {
+    for (std::size_t feed_id = 0; feed_id != redundancy; ++feed_id) {
+      stream_options_t options{};
+      options.ws_path = paths[shard_id];
+      options.fetch_instruments = false;
+      options.shard_id = shard_id;
+      options.feed_id = feed_id;
+      options.arbitrate = redundancy > 1;
+
+      auto &shard = shards_.emplace_back(std::make_unique<shard_t>());
+      shard->stream = std::make_unique<market_data_stream_t>(
+          shard->io_context, ssl_ctx_, std::move(options));
+      shard->stream->run();
+      shard->thread = std::thread([io_context = &shard->io_context] {
+        io_context->run();
+      });
+    }
+  }
+  return true;
+}
+
+void market_data_shards_t::join() {
+  for (auto &shard : shards_) {
+    if (shard->thread.joinable()) {
+      shard->thread.join();
+    }
+  }
+  if (bootstrap_ && bootstrap_->thread.joinable()) {
+    bootstrap_->thread.join();
+  }
+}
+
+} // namespace binance
@@ -1,30 +1,65 @@
 #include "market_data_stream.hpp"
 #include "common/crypto.hpp"
 #include "request_handler.hpp"
+#include "ticker_decoder.hpp"
 
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/write.hpp>
 
-namespace binance {
+#include <algorithm>
 
-char const *const market_data_stream_t::rest_api_host_ = "api.binance.com";
-char const *const market_data_stream_t::ws_host_ = "stream.binance.com";
-char const *const market_data_stream_t::ws_port_number_ = "9443";
+namespace binance {
 
 using namespace fmt::v7::literals;
 
+namespace {
+
+// "E" against the local receive time, for the ticks that carry an "E"
+void record_exchange_latency(
+    pipeline_latency_t &latency,
+    std::vector<pushed_subscription_data_t> const &pushed_list,
+    std::uint64_t receive_time_ms) {
+  using namespace std::chrono;
+
+  if (receive_time_ms == 0) {
+    receive_time_ms = static_cast<std::uint64_t>(
+        duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+            .count());
+  }
+  for (auto const &data : pushed_list) {
+    if (data.event_time != 0) {
+      latency.record(latency_stage_e::exchange_to_receive,
+                     data.event_time * 1'000'000, receive_time_ms * 1'000'000);
+    }
+  }
+}
+
+} // namespace
+
 market_data_stream_t::market_data_stream_t(net::io_context &io_context,
-                                           net::ssl::context &ssl_ctx)
-    : io_context_{io_context}, ssl_ctx_{ssl_ctx},
-      ssl_web_stream_{}, resolver_{} {}
+                                           net::ssl::context &ssl_ctx,
+                                           stream_options_t options)
+    : io_context_{io_context}, ssl_ctx_{ssl_ctx}, options_{std::move(options)},
+      is_combined_stream_{options_.ws_path.rfind("/stream", 0) == 0},
+      ssl_web_stream_{}, resolver_{} {
+  if (auto recorder = request_handler_t::get_frame_recorder();
+      recorder != nullptr && !options_.ws_path.empty()) {
+    recorded_stream_id_ = recorder->add_stream(options_.ws_path);
+  }
+}
 
-void market_data_stream_t::run() { rest_api_initiate_connection(); }
+void market_data_stream_t::run() {
+  if (options_.fetch_instruments) {
+    return rest_api_initiate_connection();
+  }
+  initiate_websocket_connection();
+}
 
 void market_data_stream_t::rest_api_initiate_connection() {
   resolver_.emplace(io_context_);
 
   resolver_->async_resolve(
-      rest_api_host_, "https",
+      endpoints_.rest_api_host, endpoints_.rest_api_port,
       [this](auto const error_code,
              net::ip::tcp::resolver::results_type const &results) {
         if (error_code) {
@@ -61,7 +96,7 @@ void market_data_stream_t::rest_api_perform_ssl_handshake(
       .expires_after(std::chrono::seconds(15));
   // Set SNI Hostname (many hosts need this to handshake successfully)
   if (!SSL_set_tlsext_host_name(ssl_web_stream_->next_layer().native_handle(),
-                                rest_api_host_)) {
+                                endpoints_.rest_api_host.c_str())) {
     auto const ec = beast::error_code(static_cast<int>(::ERR_get_error()),
                                       net::error::get_ssl_category());
     return spdlog::error(ec.message());
@@ -89,7 +124,7 @@ void market_data_stream_t::rest_api_prepare_request() {
   request.method(verb::get);
   request.version(11);
   request.target("/api/v3/ticker/price");
-  request.set(field::host, rest_api_host_);
+  request.set(field::host, endpoints_.rest_api_host);
   request.set(field::user_agent, "PostmanRuntime/7.28.1");
   request.set(field::accept, "*/*");
   request.set(field::accept_language, "en-US,en;q=0.5 --compressed");
@@ -130,6 +165,10 @@ void market_data_stream_t::rest_api_on_data_received(
     auto const token_list =
         json::parse(http_response_->body()).get<json::array_t>();
     process_pushed_instruments_data(token_list);
+    if (options_.ws_path.empty()) {
+      // we were only asked for the instruments, let the io_context finish
+      return ssl_web_stream_.reset();
+    }
     return initiate_websocket_connection();
   } catch (std::exception const &e) {
     spdlog::error(e.what());
@@ -140,7 +179,7 @@ void market_data_stream_t::initiate_websocket_connection() {
   resolver_.emplace(io_context_);
 
   resolver_->async_resolve(
-      ws_host_, ws_port_number_,
+      endpoints_.ws_host, endpoints_.ws_port,
       [this](auto const error_code,
              net::ip::tcp::resolver::results_type const &results) {
         if (error_code) {
@@ -157,9 +196,18 @@ void market_data_stream_t::websock_connect_to_resolved_names(
   beast::get_lowest_layer(*ssl_web_stream_)
       .expires_after(std::chrono::seconds(30));
 
+  // the other addresses are still tried if the preferred one fails
+  std::vector<results_type::endpoint_type> endpoints(resolved_names.begin(),
+                                                     resolved_names.end());
+  if (!endpoints.empty()) {
+    std::rotate(endpoints.begin(),
+                endpoints.begin() + (options_.feed_id % endpoints.size()),
+                endpoints.end());
+  }
+
   beast::get_lowest_layer(*ssl_web_stream_)
       .async_connect(
-          resolved_names,
+          endpoints,
           [this](auto const error_code,
                  net::ip::tcp::resolver::results_type::endpoint_type const
                      &connected_name) {
@@ -172,7 +220,7 @@ void market_data_stream_t::websock_connect_to_resolved_names(
 
 void market_data_stream_t::websock_perform_ssl_handshake(
     results_type::endpoint_type const &ep) {
-  auto const host = "{}:{}"_format(ws_host_, ep.port());
+  auto const host = "{}:{}"_format(endpoints_.ws_host, ep.port());
 
   // Set a timeout on the operation
   beast::get_lowest_layer(*ssl_web_stream_)
@@ -203,8 +251,6 @@ void market_data_stream_t::negotiate_websocket_connection() {
 }
 
 void market_data_stream_t::perform_websocket_handshake() {
-  static auto const binance_handshake_path = "/ws/!miniTicker@arr";
-
   auto opt = websock::stream_base::timeout();
   opt.idle_timeout = std::chrono::seconds(20);
   opt.handshake_timeout = std::chrono::seconds(5);
@@ -219,14 +265,15 @@ void market_data_stream_t::perform_websocket_handshake() {
         }
       });
 
-  ssl_web_stream_->async_handshake(ws_host_, binance_handshake_path,
-                                   [this](beast::error_code const ec) {
-                                     if (ec) {
-                                       return spdlog::error(ec.message());
-                                     }
+  ssl_web_stream_->async_handshake(
+      endpoints_.ws_host, options_.ws_path, [this](beast::error_code const ec) {
+        if (ec) {
+          return spdlog::error("[shard {}/feed {}] {}", options_.shard_id,
+                               options_.feed_id, ec.message());
+        }
 
-                                     wait_for_messages();
-                                   });
+        wait_for_messages();
+      });
 }
 
 void market_data_stream_t::wait_for_messages() {
@@ -236,61 +283,134 @@ void market_data_stream_t::wait_for_messages() {
         if (error_code == net::error::operation_aborted) {
           return spdlog::error(error_code.message());
         } else if (error_code) {
-          spdlog::error(error_code.message());
+          spdlog::error("[shard {}/feed {}] {}", options_.shard_id,
+                        options_.feed_id, error_code.message());
           ssl_web_stream_.reset();
           return initiate_websocket_connection();
         }
-        interpret_generic_messages();
+
+        auto const received_at_ns =
+            request_handler_t::get_pipeline_latency().enabled()
+                ? steady_clock_ns()
+                : 0;
+        char const *buffer_cstr =
+            static_cast<char const *>(buffer_->cdata().data());
+        std::string_view const buffer(buffer_cstr, buffer_->size());
+        if (auto recorder = request_handler_t::get_frame_recorder();
+            recorder != nullptr) {
+          recorder->record(recorded_stream_id_, buffer);
+        }
+        interpret_generic_messages(buffer, received_at_ns);
+        wait_for_messages();
       });
 }
 
-void market_data_stream_t::interpret_generic_messages() {
-  char const *buffer_cstr = static_cast<char const *>(buffer_->cdata().data());
-  std::string_view const buffer(buffer_cstr, buffer_->size());
+void market_data_stream_t::replay_frame(std::string_view const frame,
+                                        std::uint64_t const receive_time_ms) {
+  auto const received_at_ns =
+      request_handler_t::get_pipeline_latency().enabled() ? steady_clock_ns()
+                                                          : 0;
+  interpret_generic_messages(frame, received_at_ns, receive_time_ms);
+}
 
+void market_data_stream_t::interpret_generic_messages(
+    std::string_view const buffer, std::uint64_t const received_at_ns,
+    std::uint64_t const receive_time_ms) {
   try {
-    auto object_list = json::parse(buffer).get<json::array_t>();
-    process_pushed_tickers_data(std::move(object_list));
+    std::vector<pushed_subscription_data_t> pushed_list{};
+    pushed_list.reserve(last_frame_size_);
+    auto &symbols = request_handler_t::get_symbol_registry();
+    if (is_combined_stream_) {
+      decode_combined_stream_frame(buffer, symbols, pushed_list);
+    } else {
+      decode_mini_ticker_array(buffer, symbols, pushed_list);
+    }
+    last_frame_size_ = pushed_list.size();
+
+    auto &latency = request_handler_t::get_pipeline_latency();
+    std::uint64_t const parsed_at_ns = received_at_ns ? steady_clock_ns() : 0;
+    if (received_at_ns != 0) {
+      record_exchange_latency(latency, pushed_list, receive_time_ms);
+      latency.record(latency_stage_e::receive_to_parsed, received_at_ns,
+                     parsed_at_ns);
+    }
+    if (is_combined_stream_) {
+      stamp_receive_time(pushed_list, receive_time_ms);
+    }
+    if (options_.arbitrate) {
+      request_handler_t::get_feed_arbiter().filter(pushed_list);
+    }
+    if (received_at_ns != 0) {
+      auto const enqueued_at_ns = steady_clock_ns();
+      latency.record(latency_stage_e::parsed_to_enqueued, parsed_at_ns,
+                     enqueued_at_ns);
+      for (auto &data : pushed_list) {
+        data.received_at_ns = received_at_ns;
+        data.enqueued_at_ns = enqueued_at_ns;
+      }
+    }
+    process_pushed_tickers_data(std::move(pushed_list));
   } catch (std::exception const &e) {
     spdlog::error(e.what());
   }
+}
 
-  return wait_for_messages();
+// bookTicker events have no event time, so we use the time we got them
+void market_data_stream_t::stamp_receive_time(
+    std::vector<pushed_subscription_data_t> &pushed_list,
+    std::uint64_t now) {
+  using namespace std::chrono;
+
+  for (auto &data : pushed_list) {
+    if (data.event_time != 0) {
+      continue;
+    }
+    if (now == 0) {
+      now = duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+                .count();
+    }
+    data.event_time = now;
+  }
 }
 
 void market_data_stream_t::process_pushed_instruments_data(
     json::array_t const &data_list) {
-
-  std::vector<instrument_type_t> instruments{};
-  instruments.reserve(data_list.size());
+  auto &symbols = request_handler_t::get_symbol_registry();
+  auto &snapshot = request_handler_t::get_state_snapshot();
+  std::vector<pushed_subscription_data_t> listed{};
   for (auto const &data_json : data_list) {
-    auto const data_object = data_json.get<json::object_t>();
-    std::string instrument_id = data_object.at("symbol").get<json::string_t>();
-
-    instruments.push_back({instrument_id});
+    auto const &symbol =
+        data_json.at("symbol").get_ref<json::string_t const &>();
+    auto const symbol_id = symbols.get_or_insert(symbol);
+    if (symbol_id == invalid_symbol_id) {
+      spdlog::error("unable to register symbol '{}'", symbol);
+      continue;
+    }
+    if (snapshot.restored()) {
+      auto const &price =
+          data_json.at("price").get_ref<json::string_t const &>();
+      pushed_subscription_data_t tick{};
+      tick.symbol_id = symbol_id;
+      if (from_chars(price.data(), price.data() + price.size(),
+                     tick.current_price)
+              .ec == std::errc{}) {
+        listed.push_back(tick);
+      }
+    }
+  }
+  if (snapshot.restored()) {
+    snapshot.reconcile(std::move(listed));
   }
-  request_handler_t::get_all_listed_instruments().insert_list(
-      std::move(instruments));
 }
 
 void market_data_stream_t::process_pushed_tickers_data(
-    json::array_t const &data_list) {
-
-  std::vector<pushed_subscription_data_t> pushed_list{};
-  pushed_list.reserve(data_list.size());
-
-  for (auto const &data_json : data_list) {
-    pushed_subscription_data_t data{};
-    auto const data_object = data_json.get<json::object_t>();
-    // symbol => BTCDOGE, DOGEUSDT etc
-    data.instrument_id = data_object.at("s").get<json::string_t>();
-    data.current_price = std::stod(data_object.at("c").get<json::string_t>());
-    data.open_24h = std::stod(data_object.at("o").get<json::string_t>());
-    pushed_list.push_back(std::move(data));
+    std::vector<pushed_subscription_data_t> &&pushed_list) {
+  if (request_handler_t::conflating_ticks()) {
+    request_handler_t::get_latest_ticks().append_list(std::move(pushed_list));
+  } else {
+    request_handler_t::get_tokens_container().append_list(
+        std::move(pushed_list));
   }
-
-  auto &market_stream = request_handler_t::get_tokens_container();
-  market_stream.append_list(std::move(pushed_list));
 }
 
 } // namespace binance
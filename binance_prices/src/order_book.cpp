@@ -0,0 +1,196 @@
+#include "order_book.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace binance {
+
+namespace {
+
+decimal_t sum_quantities(price_level_t const *levels, std::size_t const count) {
+  decimal_t total{};
+  for (std::size_t i = 0; i != count; ++i) {
+    total += levels[i].quantity;
+  }
+  return total;
+}
+
+// `levels` is sorted so that the best price is at the back, `Better(a, b)` is
+// true if price `a` is better than price `b`
+template <typename Better>
+void apply_level(std::vector<price_level_t> &levels,
+                 price_level_t const &level, Better &&better) {
+  auto iter = std::lower_bound(levels.begin(), levels.end(), level.price,
+                               [&](price_level_t const &a, decimal_t const b) {
+                                 return better(b, a.price);
+                               });
+  bool const exists = iter != levels.end() && iter->price == level.price;
+  if (level.quantity.is_zero()) {
+    if (exists) {
+      levels.erase(iter);
+    }
+  } else if (exists) {
+    iter->quantity = level.quantity;
+  } else {
+    levels.insert(iter, level);
+  }
+}
+
+void apply_bid(std::vector<price_level_t> &bids, price_level_t const &level) {
+  apply_level(bids, level, std::greater<decimal_t>{});
+}
+
+void apply_ask(std::vector<price_level_t> &asks, price_level_t const &level) {
+  apply_level(asks, level, std::less<decimal_t>{});
+}
+
+} // namespace
+
+std::optional<decimal_t> book_top_t::mid_price() const {
+  if (empty()) {
+    return std::nullopt;
+  }
+  return decimal_t::from_units((bids[0].price.units() + asks[0].price.units()) /
+                               2);
+}
+
+std::optional<decimal_t> book_top_t::micro_price() const {
+  if (empty()) {
+    return std::nullopt;
+  }
+  auto const &bid = bids[0];
+  auto const &ask = asks[0];
+  auto const total_quantity = bid.quantity + ask.quantity;
+  if (total_quantity.is_zero()) {
+    return mid_price();
+  }
+  // (bid * ask_qty + ask * bid_qty) / (bid_qty + ask_qty)
+  long double const weighted =
+      static_cast<long double>(bid.price.units()) * ask.quantity.units() +
+      static_cast<long double>(ask.price.units()) * bid.quantity.units();
+  return decimal_t::from_units(static_cast<std::int64_t>(
+      weighted / static_cast<long double>(total_quantity.units()) + 0.5L));
+}
+
+decimal_t book_top_t::bid_depth(std::size_t const levels) const {
+  return sum_quantities(bids, std::min<std::size_t>(levels, bid_count));
+}
+
+decimal_t book_top_t::ask_depth(std::size_t const levels) const {
+  return sum_quantities(asks, std::min<std::size_t>(levels, ask_count));
+}
+
+order_book_t::order_book_t(symbol_id_t const symbol_id)
+    : symbol_id_{symbol_id} {}
+
+void order_book_t::reset() {
+  bids_.clear();
+  asks_.clear();
+  pending_updates_.clear();
+  last_update_id_ = 0;
+  awaiting_first_update_ = true;
+  state_ = book_state_e::awaiting_snapshot;
+  top_.store(book_top_t{});
+}
+
+void order_book_t::apply_levels(depth_update_t const &update) {
+  for (auto const &level : update.bids) {
+    apply_bid(bids_, level);
+  }
+  for (auto const &level : update.asks) {
+    apply_ask(asks_, level);
+  }
+  last_update_id_ = update.final_update_id;
+}
+
+book_update_result_e order_book_t::on_update(depth_update_t const &update) {
+  if (state_ == book_state_e::awaiting_snapshot) {
+    if (pending_updates_.size() == max_pending_updates) {
+      pending_updates_.erase(pending_updates_.begin());
+    }
+    pending_updates_.push_back(update);
+    return book_update_result_e::buffered;
+  }
+
+  if (update.final_update_id <= last_update_id_) {
+    return book_update_result_e::stale;
+  }
+  // the first update after the snapshot only has to straddle it
+  bool const lines_up = awaiting_first_update_
+                            ? update.first_update_id <= last_update_id_ + 1
+                            : update.first_update_id == last_update_id_ + 1;
+  if (!lines_up) {
+    reset();
+    return book_update_result_e::gap;
+  }
+  apply_levels(update);
+  awaiting_first_update_ = false;
+  publish(update.event_time);
+  return book_update_result_e::applied;
+}
+
+bool order_book_t::on_snapshot(depth_snapshot_t const &snapshot) {
+  // the snapshot lists the best levels first
+  bids_.assign(snapshot.bids.rbegin(), snapshot.bids.rend());
+  asks_.assign(snapshot.asks.rbegin(), snapshot.asks.rend());
+  last_update_id_ = snapshot.last_update_id;
+
+  std::uint64_t event_time{};
+  awaiting_first_update_ = true;
+  for (auto const &update : pending_updates_) {
+    if (update.final_update_id <= last_update_id_) {
+      continue;
+    }
+    // the first update must straddle the snapshot, the next ones must follow
+    // each other without a gap
+    bool const lines_up =
+        awaiting_first_update_
+            ? update.first_update_id <= last_update_id_ + 1
+            : update.first_update_id == last_update_id_ + 1;
+    if (!lines_up) {
+      reset();
+      return false;
+    }
+    apply_levels(update);
+    event_time = update.event_time;
+    awaiting_first_update_ = false;
+  }
+  pending_updates_.clear();
+  state_ = book_state_e::synced;
+  publish(event_time);
+  return true;
+}
+
+void order_book_t::publish(std::uint64_t const event_time) {
+  book_top_t top{};
+  top.update_id = last_update_id_;
+  top.event_time = event_time;
+  top.bid_count = static_cast<std::uint32_t>(
+      std::min<std::size_t>(bids_.size(), book_top_t::max_levels));
+  top.ask_count = static_cast<std::uint32_t>(
+      std::min<std::size_t>(asks_.size(), book_top_t::max_levels));
+  std::copy_n(bids_.rbegin(), top.bid_count, top.bids);
+  std::copy_n(asks_.rbegin(), top.ask_count, top.asks);
+  top_.store(top);
+}
+
+order_books_t::order_books_t()
+    : books_{std::make_unique<std::unique_ptr<order_book_t>[]>(
+          symbol_registry_t::max_symbols)} {}
+
+order_book_t &order_books_t::get_or_create(symbol_id_t const id) {
+  auto &book = books_[id];
+  if (!book) {
+    book = std::make_unique<order_book_t>(id);
+  }
+  return *book;
+}
+
+order_book_t *order_books_t::find(symbol_id_t const id) const {
+  if (id >= symbol_registry_t::max_symbols) {
+    return nullptr;
+  }
+  return books_[id].get();
+}
+
+} // namespace binance
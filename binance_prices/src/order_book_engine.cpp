@@ -0,0 +1,73 @@
+#include "order_book_engine.hpp"
+#include "request_handler.hpp"
+
+#include <algorithm>
+
+namespace binance {
+
+order_book_engine_t::order_book_engine_t(net::ssl::context &ssl_ctx,
+                                         order_book_config_t config)
+    : ssl_ctx_{ssl_ctx}, config_{std::move(config)} {}
+
+order_book_engine_t::~order_book_engine_t() {
+  for (auto &connection : connections_) {
+    connection->io_context.stop();
+  }
+  join();
+}
+
+bool order_book_engine_t::run() {
+  auto &symbols = request_handler_t::get_symbol_registry();
+  auto &books = request_handler_t::get_order_books();
+
+  std::vector<symbol_id_t> symbol_ids{};
+  symbol_ids.reserve(config_.symbols.size());
+  for (auto const &symbol : config_.symbols) {
+    auto const id = symbols.get_or_insert(symbol);
+    if (id == invalid_symbol_id) {
+      spdlog::error("unable to register symbol '{}'", symbol);
+      return false;
+    }
+    // the books must all exist before any connection starts
+    books.get_or_create(id);
+    symbol_ids.push_back(id);
+  }
+  std::sort(symbol_ids.begin(), symbol_ids.end());
+  symbol_ids.erase(std::unique(symbol_ids.begin(), symbol_ids.end()),
+                   symbol_ids.end());
+
+  auto const books_per_connection =
+      std::max<std::size_t>(config_.books_per_connection, 1);
+  auto const snapshot_depth =
+      std::clamp<std::size_t>(config_.snapshot_depth, 1, 5'000);
+  for (std::size_t first = 0; first < symbol_ids.size();
+       first += books_per_connection) {
+    auto const last =
+        std::min(first + books_per_connection, symbol_ids.size());
+    auto &connection =
+        connections_.emplace_back(std::make_unique<connection_t>());
+    connection->stream = std::make_unique<order_book_stream_t>(
+        connection->io_context, ssl_ctx_, books,
+        std::vector<symbol_id_t>(symbol_ids.begin() + first,
+                                 symbol_ids.begin() + last),
+        snapshot_depth, connections_.size() - 1);
+    connection->stream->run();
+    connection->thread = std::thread(
+        [io_context = &connection->io_context] { io_context->run(); });
+  }
+  if (!connections_.empty()) {
+    spdlog::info("keeping {} order books over {} connections",
+                 symbol_ids.size(), connections_.size());
+  }
+  return true;
+}
+
+void order_book_engine_t::join() {
+  for (auto &connection : connections_) {
+    if (connection->thread.joinable()) {
+      connection->thread.join();
+    }
+  }
+}
+
+} // namespace binance
@@ -0,0 +1,333 @@
+#include "order_book_stream.hpp"
+#include "request_handler.hpp"
+#include "ticker_decoder.hpp"
+
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/write.hpp>
+
+#include <algorithm>
+
+namespace binance {
+
+using namespace fmt::v7::literals;
+
+order_book_stream_t::order_book_stream_t(net::io_context &io_context,
+                                         net::ssl::context &ssl_ctx,
+                                         order_books_t &books,
+                                         std::vector<symbol_id_t> symbol_ids,
+                                         std::size_t const snapshot_depth,
+                                         std::size_t const connection_id)
+    : io_context_{io_context}, ssl_ctx_{ssl_ctx}, books_{books},
+      symbol_ids_{std::move(symbol_ids)}, snapshot_depth_{snapshot_depth},
+      connection_id_{connection_id}, retry_timer_{io_context} {}
+
+void order_book_stream_t::run() { ws_initiate_connection(); }
+
+void order_book_stream_t::ws_initiate_connection() {
+  ws_resolver_.emplace(io_context_);
+
+  ws_resolver_->async_resolve(
+      endpoints_.ws_host, endpoints_.ws_port,
+      [this](auto const error_code, results_type const &results) {
+        if (error_code) {
+          return spdlog::error(error_code.message());
+        }
+        ws_connect_to_resolved_names(results);
+      });
+}
+
+void order_book_stream_t::ws_connect_to_resolved_names(
+    results_type const &resolved_names) {
+  ws_resolver_.reset();
+  ws_stream_.emplace(io_context_, ssl_ctx_);
+  beast::get_lowest_layer(*ws_stream_).expires_after(std::chrono::seconds(30));
+
+  beast::get_lowest_layer(*ws_stream_)
+      .async_connect(resolved_names,
+                     [this](auto const error_code,
+                            results_type::endpoint_type const &) {
+                       if (error_code) {
+                         return spdlog::error(error_code.message());
+                       }
+                       ws_perform_ssl_handshake();
+                     });
+}
+
+void order_book_stream_t::ws_perform_ssl_handshake() {
+  beast::get_lowest_layer(*ws_stream_).expires_after(std::chrono::seconds(30));
+
+  // Set SNI Hostname (many hosts need this to handshake successfully)
+  if (!SSL_set_tlsext_host_name(ws_stream_->next_layer().native_handle(),
+                                endpoints_.ws_host.c_str())) {
+    auto const ec = beast::error_code(static_cast<int>(::ERR_get_error()),
+                                      net::error::get_ssl_category());
+    return spdlog::error(ec.message());
+  }
+
+  ws_stream_->next_layer().async_handshake(
+      net::ssl::stream_base::client, [this](beast::error_code const ec) {
+        if (ec) {
+          return spdlog::error(ec.message());
+        }
+        beast::get_lowest_layer(*ws_stream_).expires_never();
+        return ws_perform_websocket_handshake();
+      });
+}
+
+void order_book_stream_t::ws_perform_websocket_handshake() {
+  std::string path = "/stream?streams=";
+  auto &symbols = request_handler_t::get_symbol_registry();
+  for (auto const id : symbol_ids_) {
+    if (path.back() != '=') {
+      path += '/';
+    }
+    path += make_stream_name(symbols.name(id), "depth@100ms");
+  }
+
+  auto opt = websock::stream_base::timeout();
+  opt.idle_timeout = std::chrono::seconds(20);
+  opt.handshake_timeout = std::chrono::seconds(5);
+  opt.keep_alive_pings = true;
+  ws_stream_->set_option(opt);
+
+  ws_stream_->control_callback([this](auto const frame_type, auto const &) {
+    if (frame_type == websock::frame_type::close) {
+      return ws_reconnect();
+    }
+  });
+
+  ws_stream_->async_handshake(
+      endpoints_.ws_host, path, [this](beast::error_code const ec) {
+        if (ec) {
+          return spdlog::error("[books {}] {}", connection_id_, ec.message());
+        }
+        // the diffs are buffered from now on, so the snapshots line up
+        for (auto const id : symbol_ids_) {
+          request_snapshot(id);
+        }
+        ws_wait_for_messages();
+      });
+}
+
+void order_book_stream_t::ws_wait_for_messages() {
+  ws_buffer_.emplace();
+  ws_stream_->async_read(
+      *ws_buffer_,
+      [this](beast::error_code const error_code, std::size_t const) {
+        if (error_code == net::error::operation_aborted) {
+          return spdlog::error(error_code.message());
+        } else if (error_code) {
+          spdlog::error("[books {}] {}", connection_id_, error_code.message());
+          return ws_reconnect();
+        }
+        ws_interpret_message();
+      });
+}
+
+void order_book_stream_t::ws_interpret_message() {
+  char const *buffer_cstr =
+      static_cast<char const *>(ws_buffer_->cdata().data());
+  std::string_view const buffer(buffer_cstr, ws_buffer_->size());
+
+  try {
+    if (decode_depth_update(buffer, request_handler_t::get_symbol_registry(),
+                            update_)) {
+      if (auto book = books_.find(update_.symbol_id); book != nullptr) {
+        if (book->on_update(update_) == book_update_result_e::gap) {
+          spdlog::info("[books {}] gap in the {} diffs, resyncing",
+                       connection_id_,
+                       request_handler_t::get_symbol_registry().name(
+                           update_.symbol_id));
+          request_snapshot(update_.symbol_id);
+        }
+      }
+    }
+  } catch (std::exception const &e) {
+    spdlog::error(e.what());
+  }
+
+  return ws_wait_for_messages();
+}
+
+void order_book_stream_t::ws_reconnect() {
+  // the diffs we missed while reconnecting make every book stale
+  for (auto const id : symbol_ids_) {
+    if (auto book = books_.find(id); book != nullptr) {
+      book->reset();
+    }
+  }
+  ws_stream_.reset();
+  ws_initiate_connection();
+}
+
+void order_book_stream_t::request_snapshot(symbol_id_t const id) {
+  if (std::find(snapshot_queue_.cbegin(), snapshot_queue_.cend(), id) ==
+      snapshot_queue_.cend()) {
+    snapshot_queue_.push_back(id);
+  }
+  if (!is_fetching_snapshot_) {
+    rest_fetch_next_snapshot();
+  }
+}
+
+void order_book_stream_t::rest_fetch_next_snapshot() {
+  if (snapshot_queue_.empty()) {
+    is_fetching_snapshot_ = false;
+    return;
+  }
+  is_fetching_snapshot_ = true;
+  if (rest_stream_) {
+    return rest_send_request();
+  }
+  rest_initiate_connection();
+}
+
+void order_book_stream_t::rest_retry_later(std::chrono::seconds const delay) {
+  rest_stream_.reset();
+  retry_timer_.expires_after(delay);
+  retry_timer_.async_wait([this](beast::error_code const ec) {
+    if (ec) {
+      return;
+    }
+    rest_fetch_next_snapshot();
+  });
+}
+
+void order_book_stream_t::rest_initiate_connection() {
+  rest_resolver_.emplace(io_context_);
+
+  rest_resolver_->async_resolve(
+      endpoints_.rest_api_host, endpoints_.rest_api_port,
+      [this](auto const error_code, results_type const &results) {
+        if (error_code) {
+          spdlog::error(error_code.message());
+          return rest_retry_later(std::chrono::seconds(5));
+        }
+        rest_connect_to_resolved_names(results);
+      });
+}
+
+void order_book_stream_t::rest_connect_to_resolved_names(
+    results_type const &resolved_names) {
+  rest_resolver_.reset();
+  rest_stream_.emplace(io_context_, ssl_ctx_);
+  beast::get_lowest_layer(*rest_stream_)
+      .expires_after(std::chrono::seconds(30));
+
+  beast::get_lowest_layer(*rest_stream_)
+      .async_connect(resolved_names,
+                     [this](auto const error_code,
+                            results_type::endpoint_type const &) {
+                       if (error_code) {
+                         spdlog::error(error_code.message());
+                         return rest_retry_later(std::chrono::seconds(5));
+                       }
+                       rest_perform_ssl_handshake();
+                     });
+}
+
+void order_book_stream_t::rest_perform_ssl_handshake() {
+  beast::get_lowest_layer(*rest_stream_)
+      .expires_after(std::chrono::seconds(15));
+  // Set SNI Hostname (many hosts need this to handshake successfully)
+  if (!SSL_set_tlsext_host_name(rest_stream_->native_handle(),
+                                endpoints_.rest_api_host.c_str())) {
+    auto const ec = beast::error_code(static_cast<int>(::ERR_get_error()),
+                                      net::error::get_ssl_category());
+    spdlog::error(ec.message());
+    return rest_retry_later(std::chrono::seconds(5));
+  }
+
+  rest_stream_->async_handshake(
+      net::ssl::stream_base::client, [this](beast::error_code const ec) {
+        if (ec) {
+          spdlog::error(ec.message());
+          return rest_retry_later(std::chrono::seconds(5));
+        }
+        rest_send_request();
+      });
+}
+
+void order_book_stream_t::rest_send_request() {
+  using http::field;
+  using http::verb;
+
+  auto const &symbol = request_handler_t::get_symbol_registry().name(
+      snapshot_queue_.front());
+  auto &request = http_request_.emplace();
+  request.method(verb::get);
+  request.version(11);
+  request.target(
+      "/api/v3/depth?symbol={}&limit={}"_format(symbol, snapshot_depth_));
+  request.set(field::host, endpoints_.rest_api_host);
+  request.set(field::user_agent, "PostmanRuntime/7.28.1");
+  request.set(field::accept, "*/*");
+  request.keep_alive(true);
+
+  beast::get_lowest_layer(*rest_stream_)
+      .expires_after(std::chrono::seconds(20));
+  http::async_write(*rest_stream_, *http_request_,
+                    [this](beast::error_code const ec, std::size_t const) {
+                      if (ec) {
+                        spdlog::error(ec.message());
+                        return rest_retry_later(std::chrono::seconds(1));
+                      }
+                      rest_receive_response();
+                    });
+}
+
+void order_book_stream_t::rest_receive_response() {
+  http_request_.reset();
+  rest_buffer_.emplace();
+  http_response_.emplace();
+  // a 5,000-level snapshot is a few hundred kilobytes
+  http_response_->body().reserve(512 * 1'024);
+
+  beast::get_lowest_layer(*rest_stream_)
+      .expires_after(std::chrono::seconds(20));
+  http::async_read(*rest_stream_, *rest_buffer_, *http_response_,
+                   [this](beast::error_code const ec, std::size_t const) {
+                     rest_on_response_received(ec);
+                   });
+}
+
+void order_book_stream_t::rest_on_response_received(
+    beast::error_code const ec) {
+  if (ec) {
+    spdlog::error(ec.message());
+    return rest_retry_later(std::chrono::seconds(1));
+  }
+
+  auto const result_int = http_response_->result_int();
+  if (result_int != 200) {
+    // 429 and 418 mean we are over the request weight limit
+    spdlog::error("[books {}] GET /api/v3/depth returned {}", connection_id_,
+                  result_int);
+    return rest_retry_later(std::chrono::seconds(
+        result_int == 429 || result_int == 418 ? 60 : 5));
+  }
+
+  auto const id = snapshot_queue_.front();
+  snapshot_queue_.pop_front();
+  try {
+    decode_depth_snapshot(http_response_->body(),
+                          request_handler_t::get_symbol_registry(), snapshot_);
+    if (auto book = books_.find(id); book != nullptr) {
+      if (!book->on_snapshot(snapshot_)) {
+        // the diffs moved past the snapshot while we were fetching it
+        snapshot_queue_.push_back(id);
+      }
+    }
+  } catch (std::exception const &e) {
+    spdlog::error(e.what());
+    snapshot_queue_.push_back(id);
+  }
+
+  if (!http_response_->keep_alive()) {
+    rest_stream_.reset();
+  }
+  http_response_.reset();
+  rest_fetch_next_snapshot();
+}
+
+} // namespace binance
@@ -0,0 +1,94 @@
+#include "pipeline_latency.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <chrono>
+#include <csignal>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+namespace binance {
+
+namespace {
+
+double to_microseconds(std::uint64_t const nanoseconds) {
+  return static_cast<double>(nanoseconds) / 1'000.0;
+}
+
+#if defined(SIGUSR1) && defined(SIGUSR2)
+void wait_for_latency_signal(boost::asio::signal_set &signals,
+                             pipeline_latency_t &latency) {
+  signals.async_wait([&signals, &latency](boost::system::error_code const ec,
+                                          int const signal_number) {
+    if (ec) {
+      return spdlog::error(ec.message());
+    }
+    if (signal_number == SIGUSR1) {
+      latency.dump();
+    } else {
+      latency.reset();
+      spdlog::info("latency histograms reset");
+    }
+    wait_for_latency_signal(signals, latency);
+  });
+}
+#endif
+
+} // namespace
+
+std::string latency_stage_to_string(latency_stage_e const stage) {
+  switch (stage) {
+  case latency_stage_e::exchange_to_receive:
+    return "exchange->receive";
+  case latency_stage_e::receive_to_parsed:
+    return "receive->parsed";
+  case latency_stage_e::parsed_to_enqueued:
+    return "parsed->enqueued";
+  case latency_stage_e::enqueued_to_applied:
+    return "enqueued->applied";
+  case latency_stage_e::receive_to_applied:
+    return "receive->applied";
+  }
+  return "unknown";
+}
+
+std::uint64_t steady_clock_ns() {
+  using namespace std::chrono;
+  return static_cast<std::uint64_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+          .count());
+}
+
+void pipeline_latency_t::reset() {
+  for (auto &histogram : histograms_) {
+    histogram.reset();
+  }
+}
+
+void pipeline_latency_t::dump() const {
+  spdlog::info("{:<18} {:>12} {:>12} {:>12} {:>12} {:>12}", "stage (us)",
+               "count", "p50", "p99", "p99.9", "max");
+  for (std::size_t i = 0; i != latency_stage_count; ++i) {
+    auto const stage = static_cast<latency_stage_e>(i);
+    auto const summary = histograms_[i].summary();
+    spdlog::info("{:<18} {:>12} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f}",
+                 latency_stage_to_string(stage), summary.count,
+                 to_microseconds(summary.p50), to_microseconds(summary.p99),
+                 to_microseconds(summary.p999), to_microseconds(summary.max));
+  }
+}
+
+void watch_latency_signals(pipeline_latency_t &latency) {
+#if defined(SIGUSR1) && defined(SIGUSR2)
+  std::thread{[&latency] {
+    boost::asio::io_context io_context{1};
+    boost::asio::signal_set signals{io_context, SIGUSR1, SIGUSR2};
+    wait_for_latency_signal(signals, latency);
+    io_context.run();
+  }}.detach();
+#else
+  (void)latency;
+#endif
+}
+
+} // namespace binance
@@ -0,0 +1,172 @@
+#include "pnl_engine.hpp"
+
+#include <cmath>
+#include <limits>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+namespace {
+
+constexpr double not_computed = std::numeric_limits<double>::quiet_NaN();
+
+} // namespace
+
+pnl_engine_t::pnl_engine_t(task_registry_t &registry)
+    : registry_{registry}, symbols_{std::make_unique<symbol_tasks_t[]>(
+                               symbol_registry_t::max_symbols)},
+      kernel_{pnl_kernel()} {}
+
+void pnl_engine_t::configure(pnl_engine_config_t const &config) {
+  config_ = config;
+}
+
+void pnl_engine_t::subscribe(task_result_subscriber_t subscriber) {
+  subscribers_.push_back(std::move(subscriber));
+}
+
+bool pnl_engine_t::add(scheduled_task_t task) {
+  if (task.task_type != task_type_e::profit_and_loss) {
+    spdlog::error("task '{}' is not a profit_and_loss task", task.request_id);
+    return false;
+  }
+  if (task.symbol_id >= symbol_registry_t::max_symbols) {
+    spdlog::error("task '{}' has no valid symbol", task.request_id);
+    return false;
+  }
+  if (string_to_direction(task.direction) == trade_direction_e::none) {
+    spdlog::error("task '{}' has an invalid direction: '{}'", task.request_id,
+                  task.direction);
+    return false;
+  }
+  if (task.order_price <= decimal_t{}) {
+    spdlog::error("task '{}' has an invalid price: {}", task.request_id,
+                  task.order_price);
+    return false;
+  }
+  if (task.quantity.is_zero()) {
+    task.quantity = decimal_t::from_double(task.money.to_double() /
+                                           task.order_price.to_double());
+  }
+  if (task.quantity <= decimal_t{}) {
+    spdlog::error("task '{}' has no quantity", task.request_id);
+    return false;
+  }
+  task.status = task_state_e::running;
+  pending_.add(std::move(task));
+  return true;
+}
+
+void pnl_engine_t::remove(std::string request_id) {
+  pending_.remove(std::move(request_id));
+}
+
+void pnl_engine_t::remove(std::vector<std::string> const &request_ids) {
+  pending_.remove(request_ids);
+}
+
+void pnl_engine_t::insert(scheduled_task_t &&task) {
+  erase(task.request_id);
+
+  auto const handle = registry_.acquire(task.request_id);
+  if (handle.index >= results_.size()) {
+    results_.resize(handle.index + 1);
+    positions_.resize(handle.index + 1);
+  }
+  auto &result = results_[handle.index];
+  result.task = handle;
+  result.user_id = registry_.get_or_insert_user(task.for_username);
+  result.direction = string_to_direction(task.direction);
+  result.task_type = task.task_type;
+  result.column_id = task.column_id;
+  result.symbol_id = task.symbol_id;
+  result.order_price = task.order_price;
+  result.money = task.money;
+  result.quantity = task.quantity;
+
+  auto quantity = task.quantity.to_double();
+  if (result.direction == trade_direction_e::sell) {
+    quantity = -quantity;
+  }
+  auto &symbol = symbols_[task.symbol_id];
+  positions_[handle.index] = static_cast<std::uint32_t>(symbol.tasks.size());
+  symbol.quantities.push_back(quantity);
+  symbol.costs.push_back(quantity *
+                         static_cast<double>(task.order_price.units()));
+  symbol.pnls.push_back(not_computed);
+  symbol.tasks.push_back(handle.index);
+  // the new task gets its PnL with the next tick, even at the same price
+  symbol.last_price = not_computed;
+  size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void pnl_engine_t::erase(std::string const &request_id) {
+  auto const handle = registry_.find(request_id);
+  if (!handle || handle->index >= results_.size() ||
+      results_[handle->index].symbol_id == invalid_symbol_id) {
+    return;
+  }
+  auto &result = results_[handle->index];
+  auto &symbol = symbols_[result.symbol_id];
+  // the last task of the symbol takes the place of the erased one
+  auto const position = positions_[handle->index];
+  auto const last = symbol.tasks.size() - 1;
+  symbol.quantities[position] = symbol.quantities[last];
+  symbol.costs[position] = symbol.costs[last];
+  symbol.pnls[position] = symbol.pnls[last];
+  symbol.tasks[position] = symbol.tasks[last];
+  positions_[symbol.tasks[position]] = position;
+  symbol.quantities.pop_back();
+  symbol.costs.pop_back();
+  symbol.pnls.pop_back();
+  symbol.tasks.pop_back();
+
+  registry_.release(result.task);
+  result = scheduled_task_t::task_result_t{};
+  size_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void pnl_engine_t::on_tick(pushed_subscription_data_t const &tick) {
+  pending_.apply([this](scheduled_task_t &task) {
+    if (task.status == task_state_e::remove) {
+      erase(task.request_id);
+    } else {
+      insert(std::move(task));
+    }
+  });
+  if (tick.stream_type != config_.source ||
+      tick.symbol_id >= symbol_registry_t::max_symbols) {
+    return;
+  }
+  auto &symbol = symbols_[tick.symbol_id];
+  auto const price = static_cast<double>(tick.current_price.units());
+  if (symbol.tasks.empty() || price == symbol.last_price) {
+    return;
+  }
+  symbol.last_price = price;
+
+  auto const count = symbol.tasks.size();
+  if (changed_.size() < count) {
+    changed_.resize(count);
+  }
+  auto const changed_count =
+      kernel_(symbol.quantities.data(), symbol.costs.data(),
+              symbol.pnls.data(), count, price, changed_.data());
+  if (changed_count == 0 || subscribers_.empty()) {
+    return;
+  }
+
+  for (std::size_t i = 0; i != changed_count; ++i) {
+    auto const position = changed_[i];
+    auto &result = results_[symbol.tasks[position]];
+    result.mkt_price = tick.current_price;
+    result.event_time = tick.event_time;
+    result.pnl = decimal_t::from_units(
+        static_cast<std::int64_t>(symbol.pnls[position]));
+    for (auto const &subscriber : subscribers_) {
+      subscriber(result);
+    }
+  }
+}
+
+} // namespace binance
@@ -0,0 +1,151 @@
+#include "pnl_kernels.hpp"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BINANCE_PNL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC lets any function use the AVX2 intrinsics
+#define BINANCE_TARGET_AVX2
+#else
+#define BINANCE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BINANCE_PNL_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace binance {
+
+namespace {
+
+// the scalar loop over [first, count), also used for the vector kernels' tail
+std::size_t update_pnl_range(double const *quantities, double const *costs,
+                             double *pnls, std::size_t const first,
+                             std::size_t const count, double const price,
+                             std::uint32_t *changed) {
+  std::size_t changed_count = 0;
+  for (std::size_t i = first; i != count; ++i) {
+    auto const pnl = std::nearbyint(quantities[i] * price - costs[i]);
+    // `!=` is also true when the previous PnL is NaN
+    if (pnl != pnls[i]) {
+      pnls[i] = pnl;
+      changed[changed_count++] = static_cast<std::uint32_t>(i);
+    }
+  }
+  return changed_count;
+}
+
+#if defined(BINANCE_PNL_X86)
+BINANCE_TARGET_AVX2
+std::size_t update_pnls_avx2(double const *quantities, double const *costs,
+                             double *pnls, std::size_t const count,
+                             double const price, std::uint32_t *changed) {
+  std::size_t changed_count = 0;
+  auto const prices = _mm256_set1_pd(price);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    // no FMA, so that the results match the scalar kernel to the bit
+    auto const products =
+        _mm256_mul_pd(_mm256_loadu_pd(quantities + i), prices);
+    auto const values = _mm256_round_pd(
+        _mm256_sub_pd(products, _mm256_loadu_pd(costs + i)),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    auto const previous = _mm256_loadu_pd(pnls + i);
+    auto const mask = static_cast<unsigned>(
+        _mm256_movemask_pd(_mm256_cmp_pd(values, previous, _CMP_NEQ_UQ)));
+    if (mask == 0) {
+      continue;
+    }
+    _mm256_storeu_pd(pnls + i, values);
+    for (unsigned lane = 0; lane != 4; ++lane) {
+      if ((mask & (1u << lane)) != 0) {
+        changed[changed_count++] = static_cast<std::uint32_t>(i + lane);
+      }
+    }
+  }
+  return changed_count + update_pnl_range(quantities, costs, pnls, i, count,
+                                          price, changed + changed_count);
+}
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+  int info[4]{};
+  __cpuid(info, 1);
+  bool const os_saves_ymm = (info[2] & (1 << 27)) != 0 && // OSXSAVE
+                            (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return os_saves_ymm && (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#if defined(BINANCE_PNL_NEON)
+std::size_t update_pnls_neon(double const *quantities, double const *costs,
+                             double *pnls, std::size_t const count,
+                             double const price, std::uint32_t *changed) {
+  std::size_t changed_count = 0;
+  auto const prices = vdupq_n_f64(price);
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    auto const values = vrndnq_f64(vsubq_f64(
+        vmulq_f64(vld1q_f64(quantities + i), prices), vld1q_f64(costs + i)));
+    auto const previous = vld1q_f64(pnls + i);
+    auto const equal = vceqq_f64(values, previous);
+    if ((vgetq_lane_u64(equal, 0) & vgetq_lane_u64(equal, 1)) != 0) {
+      continue;
+    }
+    vst1q_f64(pnls + i, values);
+    if (vgetq_lane_u64(equal, 0) == 0) {
+      changed[changed_count++] = static_cast<std::uint32_t>(i);
+    }
+    if (vgetq_lane_u64(equal, 1) == 0) {
+      changed[changed_count++] = static_cast<std::uint32_t>(i + 1);
+    }
+  }
+  return changed_count + update_pnl_range(quantities, costs, pnls, i, count,
+                                          price, changed + changed_count);
+}
+#endif
+
+struct kernel_choice_t {
+  pnl_kernel_t kernel{};
+  char const *name{};
+};
+
+kernel_choice_t choose_kernel() {
+#if defined(BINANCE_PNL_X86)
+  if (cpu_has_avx2()) {
+    return {update_pnls_avx2, "avx2"};
+  }
+#elif defined(BINANCE_PNL_NEON)
+  // NEON is part of every AArch64 CPU
+  return {update_pnls_neon, "neon"};
+#endif
+  return {detail::update_pnls_scalar, "scalar"};
+}
+
+kernel_choice_t const &chosen_kernel() {
+  static kernel_choice_t const choice = choose_kernel();
+  return choice;
+}
+
+} // namespace
+
+namespace detail {
+std::size_t update_pnls_scalar(double const *quantities, double const *costs,
+                               double *pnls, std::size_t const count,
+                               double const price, std::uint32_t *changed) {
+  return update_pnl_range(quantities, costs, pnls, 0, count, price, changed);
+}
+} // namespace detail
+
+pnl_kernel_t pnl_kernel() { return chosen_kernel().kernel; }
+
+char const *pnl_kernel_name() { return chosen_kernel().name; }
+
+} // namespace binance
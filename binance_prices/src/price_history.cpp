@@ -0,0 +1,223 @@
+#include "price_history.hpp"
+#include "common/mapped_file.hpp"
+#include "request_handler.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+namespace fs = std::filesystem;
+
+using namespace fmt::v7::literals;
+
+namespace {
+
+// visits the points of `block` in [from, to]. Returns false once past `to`
+bool scan_block(history_block_t const &block, std::uint64_t const from,
+                std::uint64_t const to, price_point_visitor_t const &visit,
+                std::size_t &count) {
+  if (!is_valid_history_block(block) || block.header.last_time < from) {
+    return true;
+  }
+  if (block.header.first_time > to) {
+    return false;
+  }
+  history_block_decoder_t decoder{block};
+  price_point_t point{};
+  while (decoder.next(point)) {
+    if (point.time > to) {
+      return false;
+    }
+    if (point.time >= from) {
+      visit(point);
+      ++count;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+price_history_t::price_history_t()
+    : ticks_{16'384},
+      symbols_{std::make_unique<std::atomic<symbol_history_t *>[]>(
+          symbol_registry_t::max_symbols)} {}
+
+price_history_t::~price_history_t() {
+  for (std::size_t i = 0; i != symbol_registry_t::max_symbols; ++i) {
+    delete symbols_[i].load(std::memory_order_relaxed);
+  }
+}
+
+void price_history_t::configure(price_history_config_t config) {
+  config_ = std::move(config);
+}
+
+bool price_history_t::run() {
+  std::error_code ec{};
+  fs::create_directories(config_.directory, ec);
+  if (ec) {
+    spdlog::error("unable to create '{}': {}", config_.directory,
+                  ec.message());
+    return false;
+  }
+  thread_ = std::thread([this] { write_ticks(); });
+  thread_.detach();
+  return true;
+}
+
+void price_history_t::on_tick(pushed_subscription_data_t const &tick) {
+  if (!enabled() || tick.stream_type != config_.source ||
+      tick.symbol_id >= symbol_registry_t::max_symbols) {
+    return;
+  }
+  tick_t const item{tick.symbol_id, tick.event_time, tick.current_price};
+  if (ticks_.try_push_n(&item, 1) == 0) {
+    dropped_ticks_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+std::string price_history_t::filename(symbol_id_t const symbol_id) const {
+  return "{}/{}.history"_format(
+      config_.directory,
+      request_handler_t::get_symbol_registry().name(symbol_id));
+}
+
+price_history_t::symbol_history_t &
+price_history_t::get_or_insert(symbol_id_t const symbol_id) {
+  auto &slot = symbols_[symbol_id];
+  if (auto const symbol = slot.load(std::memory_order_relaxed)) {
+    return *symbol;
+  }
+  auto symbol = std::make_unique<symbol_history_t>();
+  // the blocks of a previous run are kept as they are
+  std::error_code ec{};
+  auto const size = fs::file_size(filename(symbol_id), ec);
+  if (!ec) {
+    symbol->block_index =
+        (size + history_block_size - 1) / history_block_size;
+  }
+  slot.store(symbol.get(), std::memory_order_release);
+  return *symbol.release();
+}
+
+bool price_history_t::write_block(symbol_id_t const symbol_id,
+                                  symbol_history_t const &symbol) {
+  auto const name = filename(symbol_id);
+  if (!fs::exists(name)) {
+    std::ofstream{name, std::ios::binary};
+  }
+  std::fstream file{name, std::ios::in | std::ios::out | std::ios::binary};
+  file.seekp(static_cast<std::streamoff>(symbol.block_index *
+                                         history_block_size));
+  file.write(reinterpret_cast<char const *>(&symbol.encoder.block()),
+             history_block_size);
+  file.flush();
+  if (!file) {
+    spdlog::error("unable to write block {} of '{}'", symbol.block_index,
+                  name);
+    return false;
+  }
+  return true;
+}
+
+void price_history_t::append(tick_t const &tick) {
+  auto &symbol = get_or_insert(tick.symbol_id);
+  std::lock_guard<std::mutex> lock{symbol.mutex};
+  if (!symbol.encoder.append(tick.time, tick.price)) {
+    // sealed: the block is complete in the file before readers look for it
+    // there
+    write_block(tick.symbol_id, symbol);
+    ++symbol.block_index;
+    symbol.encoder.reset();
+    symbol.encoder.append(tick.time, tick.price);
+  }
+  symbol.dirty = true;
+}
+
+void price_history_t::flush() {
+  for (std::size_t i = 0; i != symbol_registry_t::max_symbols; ++i) {
+    auto const symbol = symbols_[i].load(std::memory_order_relaxed);
+    if (symbol == nullptr || !symbol->dirty) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock{symbol->mutex};
+    write_block(static_cast<symbol_id_t>(i), *symbol);
+    symbol->dirty = false;
+  }
+}
+
+void price_history_t::write_ticks() {
+  std::size_t const max_batch_size = 4'096;
+  std::vector<tick_t> ticks{};
+  ticks.reserve(max_batch_size);
+  auto last_flush = std::chrono::steady_clock::now();
+
+  while (true) {
+    ticks.clear();
+    ticks_.drain_up_to(ticks, max_batch_size);
+    for (auto const &tick : ticks) {
+      append(tick);
+    }
+    if (auto const now = std::chrono::steady_clock::now();
+        now - last_flush >= config_.flush_interval) {
+      last_flush = now;
+      flush();
+    }
+  }
+}
+
+std::size_t price_history_t::scan(symbol_id_t const symbol_id,
+                                  std::uint64_t const from,
+                                  std::uint64_t const to,
+                                  price_point_visitor_t const &visit) const {
+  if (!enabled() || from > to ||
+      !request_handler_t::get_symbol_registry().contains(symbol_id)) {
+    return 0;
+  }
+
+  // the block being filled is copied first: the ones before it are then
+  // sealed in the file
+  auto sealed_count = std::numeric_limits<std::uint64_t>::max();
+  std::unique_ptr<history_block_t> last_block{};
+  if (auto const symbol =
+          symbols_[symbol_id].load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock{symbol->mutex};
+    sealed_count = symbol->block_index;
+    if (!symbol->encoder.empty()) {
+      last_block =
+          std::make_unique<history_block_t>(symbol->encoder.block());
+    }
+  }
+
+  std::size_t count{};
+  mapped_file_t file{};
+  auto const name = filename(symbol_id);
+  if (std::error_code ec{}; fs::exists(name, ec) && file.open(name)) {
+    auto const blocks =
+        reinterpret_cast<history_block_t const *>(file.data());
+    auto const block_count = static_cast<std::size_t>(
+        std::min<std::uint64_t>(file.size() / history_block_size,
+                                sealed_count));
+    // the first block that may end at or after `from`
+    auto const first = std::partition_point(
+        blocks, blocks + block_count, [from](history_block_t const &block) {
+          return block.header.last_time < from;
+        });
+    for (auto block = first; block != blocks + block_count; ++block) {
+      if (!scan_block(*block, from, to, visit, count)) {
+        return count;
+      }
+    }
+  }
+  if (last_block) {
+    scan_block(*last_block, from, to, visit, count);
+  }
+  return count;
+}
+
+} // namespace binance
@@ -0,0 +1,74 @@
+#include "price_table.hpp"
+
+#include "common/seqlock.hpp"
+#include <algorithm>
+
+namespace binance {
+
+price_table_t::price_table_t()
+    : current_prices_{std::make_unique<std::atomic<std::int64_t>[]>(capacity)},
+      open_24h_{std::make_unique<std::atomic<std::int64_t>[]>(capacity)},
+      event_times_{std::make_unique<std::atomic<std::uint64_t>[]>(capacity)},
+      versions_{std::make_unique<std::atomic<std::uint64_t>[]>(capacity)} {}
+
+void price_table_t::update(pushed_subscription_data_t const &data) noexcept {
+  auto const id = data.symbol_id;
+  if (id >= capacity) {
+    return;
+  }
+
+  seqlock::write_begin(versions_[id]);
+  current_prices_[id].store(data.current_price.units(),
+                            std::memory_order_relaxed);
+  // only miniTicker events carry the 24h open price
+  if (data.stream_type == stream_type_e::mini_ticker) {
+    open_24h_[id].store(data.open_24h.units(), std::memory_order_relaxed);
+  }
+  event_times_[id].store(data.event_time, std::memory_order_relaxed);
+  seqlock::write_end(versions_[id]);
+}
+
+std::optional<pushed_subscription_data_t>
+price_table_t::get(symbol_id_t const id) const {
+  if (id >= capacity) {
+    return std::nullopt;
+  }
+
+  pushed_subscription_data_t data{};
+  std::uint64_t version{};
+  do {
+    version = seqlock::read_begin(versions_[id]);
+    data.current_price = decimal_t::from_units(
+        current_prices_[id].load(std::memory_order_relaxed));
+    data.open_24h =
+        decimal_t::from_units(open_24h_[id].load(std::memory_order_relaxed));
+    data.event_time = event_times_[id].load(std::memory_order_relaxed);
+  } while (seqlock::read_retry(versions_[id], version));
+
+  if (version == 0) {
+    return std::nullopt;
+  }
+  data.symbol_id = id;
+  return data;
+}
+
+std::uint64_t price_table_t::update_count(symbol_id_t const id) const noexcept {
+  if (id >= capacity) {
+    return 0;
+  }
+  return versions_[id].load(std::memory_order_acquire) / 2;
+}
+
+void price_table_t::snapshot(
+    std::size_t const symbol_count,
+    std::vector<pushed_subscription_data_t> &result) const {
+  auto const count = std::min(symbol_count, capacity);
+  result.reserve(result.size() + count);
+  for (std::size_t id = 0; id != count; ++id) {
+    if (auto data = get(static_cast<symbol_id_t>(id)); data) {
+      result.push_back(*data);
+    }
+  }
+}
+
+} // namespace binance
@@ -0,0 +1,181 @@
+#include "price_thresholds.hpp"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+namespace {
+
+bool is_crossed_upwards(std::int64_t const threshold,
+                        std::int64_t const price) {
+  return threshold <= price;
+}
+
+bool is_crossed_downwards(std::int64_t const threshold,
+                          std::int64_t const price) {
+  return threshold >= price;
+}
+
+} // namespace
+
+price_thresholds_t::price_thresholds_t(task_registry_t &registry)
+    : registry_{registry},
+      ladders_{std::make_unique<ladders_t[]>(symbol_registry_t::max_symbols)} {
+}
+
+void price_thresholds_t::configure(price_thresholds_config_t const &config) {
+  config_ = config;
+}
+
+void price_thresholds_t::subscribe(task_result_subscriber_t subscriber) {
+  subscribers_.push_back(std::move(subscriber));
+}
+
+bool price_thresholds_t::add(scheduled_task_t task) {
+  if (task.task_type != task_type_e::price_changes) {
+    spdlog::error("task '{}' is not a price_changes task", task.request_id);
+    return false;
+  }
+  if (task.symbol_id >= symbol_registry_t::max_symbols) {
+    spdlog::error("task '{}' has no valid symbol", task.request_id);
+    return false;
+  }
+  if (string_to_direction(task.direction) == trade_direction_e::none) {
+    spdlog::error("task '{}' has an invalid direction: '{}'", task.request_id,
+                  task.direction);
+    return false;
+  }
+  if (task.order_price <= decimal_t{}) {
+    spdlog::error("task '{}' has an invalid price: {}", task.request_id,
+                  task.order_price);
+    return false;
+  }
+  task.status = task_state_e::running;
+  pending_.add(std::move(task));
+  return true;
+}
+
+void price_thresholds_t::remove(std::string request_id) {
+  pending_.remove(std::move(request_id));
+}
+
+void price_thresholds_t::remove(std::vector<std::string> const &request_ids) {
+  pending_.remove(request_ids);
+}
+
+void price_thresholds_t::insert(scheduled_task_t &&task) {
+  erase(task.request_id);
+
+  auto const handle = registry_.acquire(task.request_id);
+  if (handle.index >= results_.size()) {
+    results_.resize(handle.index + 1);
+  }
+  auto &result = results_[handle.index];
+  result.task = handle;
+  result.user_id = registry_.get_or_insert_user(task.for_username);
+  result.direction = string_to_direction(task.direction);
+  result.task_type = task.task_type;
+  result.column_id = task.column_id;
+  result.symbol_id = task.symbol_id;
+  result.order_price = task.order_price;
+  result.money = task.money;
+  result.quantity = task.quantity;
+
+  rung_t const rung{task.order_price.units(), handle.index};
+  auto &ladders = ladders_[task.symbol_id];
+  if (result.direction == trade_direction_e::sell) {
+    auto &ladder = ladders.up;
+    auto const position = std::partition_point(
+        ladder.begin(), ladder.end(),
+        [&](rung_t const &r) { return r.threshold >= rung.threshold; });
+    ladder.insert(position, rung);
+  } else {
+    auto &ladder = ladders.down;
+    auto const position = std::partition_point(
+        ladder.begin(), ladder.end(),
+        [&](rung_t const &r) { return r.threshold <= rung.threshold; });
+    ladder.insert(position, rung);
+  }
+  size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void price_thresholds_t::erase(std::string const &request_id) {
+  auto const handle = registry_.find(request_id);
+  if (!handle || handle->index >= results_.size() ||
+      results_[handle->index].symbol_id == invalid_symbol_id) {
+    return;
+  }
+  auto const index = handle->index;
+  auto &result = results_[index];
+  auto &ladders = ladders_[result.symbol_id];
+  bool const is_up = result.direction == trade_direction_e::sell;
+  auto &ladder = is_up ? ladders.up : ladders.down;
+  // only the rungs with the task's threshold need to be looked at
+  auto const threshold = result.order_price.units();
+  auto const first = std::partition_point(
+      ladder.begin(), ladder.end(), [&](rung_t const &r) {
+        return is_up ? r.threshold > threshold : r.threshold < threshold;
+      });
+  auto const rung = std::find_if(first, ladder.end(), [&](rung_t const &r) {
+    return r.task == index || r.threshold != threshold;
+  });
+  if (rung != ladder.end() && rung->task == index) {
+    ladder.erase(rung);
+  }
+  registry_.release(result.task);
+  result = scheduled_task_t::task_result_t{};
+  size_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void price_thresholds_t::trigger(std::vector<rung_t> &ladder,
+                                 std::size_t const first,
+                                 pushed_subscription_data_t const &tick) {
+  for (auto i = first; i != ladder.size(); ++i) {
+    auto &result = results_[ladder[i].task];
+    result.mkt_price = tick.current_price;
+    result.event_time = tick.event_time;
+    for (auto const &subscriber : subscribers_) {
+      subscriber(result);
+    }
+    registry_.release(result.task);
+    result = scheduled_task_t::task_result_t{};
+  }
+  size_.fetch_sub(ladder.size() - first, std::memory_order_relaxed);
+  ladder.resize(first);
+}
+
+void price_thresholds_t::on_tick(pushed_subscription_data_t const &tick) {
+  pending_.apply([this](scheduled_task_t &task) {
+    if (task.status == task_state_e::remove) {
+      erase(task.request_id);
+    } else {
+      insert(std::move(task));
+    }
+  });
+  if (tick.stream_type != config_.source ||
+      tick.symbol_id >= symbol_registry_t::max_symbols) {
+    return;
+  }
+  auto &ladders = ladders_[tick.symbol_id];
+  auto const price = tick.current_price.units();
+
+  auto &up = ladders.up;
+  if (!up.empty() && is_crossed_upwards(up.back().threshold, price)) {
+    auto const first = std::partition_point(
+        up.begin(), up.end(), [price](rung_t const &r) {
+          return !is_crossed_upwards(r.threshold, price);
+        });
+    trigger(up, static_cast<std::size_t>(first - up.begin()), tick);
+  }
+  auto &down = ladders.down;
+  if (!down.empty() && is_crossed_downwards(down.back().threshold, price)) {
+    auto const first = std::partition_point(
+        down.begin(), down.end(), [price](rung_t const &r) {
+          return !is_crossed_downwards(r.threshold, price);
+        });
+    trigger(down, static_cast<std::size_t>(first - down.begin()), tick);
+  }
+}
+
+} // namespace binance
@@ -0,0 +1,65 @@
+#include "query_server.hpp"
+#include "query_session.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+query_server_t::query_server_t() : acceptor_{io_context_} {}
+
+bool query_server_t::run(std::string const &address,
+                         std::uint16_t const port) {
+  beast::error_code ec{};
+  auto const ip_address = net::ip::make_address(address, ec);
+  if (ec) {
+    spdlog::error("invalid query server address '{}': {}", address,
+                  ec.message());
+    return false;
+  }
+  net::ip::tcp::endpoint const endpoint{ip_address, port};
+  acceptor_.open(endpoint.protocol(), ec);
+  if (ec) {
+    spdlog::error("Could not open socket: {}", ec.message());
+    return false;
+  }
+  acceptor_.set_option(net::socket_base::reuse_address(true), ec);
+  if (ec) {
+    spdlog::error("set_option failed: {}", ec.message());
+    return false;
+  }
+  acceptor_.bind(endpoint, ec);
+  if (ec) {
+    spdlog::error("binding failed: {}", ec.message());
+    return false;
+  }
+  acceptor_.listen(net::socket_base::max_listen_connections, ec);
+  if (ec) {
+    spdlog::error("not able to listen: {}", ec.message());
+    return false;
+  }
+  spdlog::info("answering price history queries on {}:{}", address, port);
+
+  accept_connections();
+  thread_ = std::thread([this] { io_context_.run(); });
+  thread_.detach();
+  return true;
+}
+
+void query_server_t::accept_connections() {
+  acceptor_.async_accept(
+      [this](beast::error_code const &ec, net::ip::tcp::socket socket) {
+        on_connection_accepted(ec, std::move(socket));
+      });
+}
+
+void query_server_t::on_connection_accepted(beast::error_code const &ec,
+                                            net::ip::tcp::socket socket) {
+  if (ec) {
+    spdlog::error("error on connection: {}", ec.message());
+  } else {
+    std::make_shared<query_session_t>(std::move(socket))->run();
+  }
+  accept_connections();
+}
+
+} // namespace binance
@@ -0,0 +1,378 @@
+#include "query_session.hpp"
+#include "common/crypto.hpp"
+#include "request_handler.hpp"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/http/chunk_encode.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/write.hpp>
+#include <charconv>
+#include <chrono>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+namespace {
+
+constexpr std::uint64_t milliseconds_per_second = 1'000;
+constexpr std::uint64_t default_range = 24 * 60 * 60 * 1'000;
+constexpr std::uint64_t default_bucket_count = 1'000;
+constexpr std::uint64_t max_bucket_count = 100'000;
+// the buckets downsampled and sent in one chunk
+constexpr std::uint64_t buckets_per_chunk = 1'000;
+// the part of the range sent in one chunk when nothing is downsampled
+constexpr std::uint64_t raw_slice_width = 60 * 60 * 1'000;
+// every point is sent when nothing is downsampled, so the range is bounded
+constexpr std::uint64_t max_raw_range = 7 * 24 * 60 * 60 * 1'000;
+// the slices scanned before the io thread is handed back to the other
+// sessions, when they hold no point
+constexpr std::size_t max_slices_per_fill = 16;
+constexpr auto write_timeout = std::chrono::seconds(30);
+
+std::optional<std::uint64_t> to_integer(boost::string_view const text) {
+  std::uint64_t value{};
+  auto const end = text.data() + text.size();
+  auto const [ptr, ec] = std::from_chars(text.data(), end, value);
+  if (ec != std::errc{} || ptr != end || text.empty()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::uint64_t milliseconds_since_epoch() {
+  using namespace std::chrono;
+  return static_cast<std::uint64_t>(
+      duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+          .count());
+}
+
+} // namespace
+
+query_session_t::query_session_t(net::ip::tcp::socket &&socket)
+    : tcp_stream_{std::move(socket)} {
+  add_endpoint_interfaces();
+}
+
+void query_session_t::add_endpoint_interfaces() {
+  using http::verb;
+
+  endpoint_apis_.add_endpoint("/history", {verb::get},
+                              [this](auto const &request, auto const &query) {
+                                history_handler(request, query);
+                              });
+  endpoint_apis_.add_endpoint("/rate", {verb::get},
+                              [this](auto const &request, auto const &query) {
+                                rate_handler(request, query);
+                              });
+}
+
+void query_session_t::run() { http_read_data(); }
+
+void query_session_t::http_read_data() {
+  request_.emplace();
+  tcp_stream_.expires_after(std::chrono::minutes(5));
+  http::async_read(tcp_stream_, buffer_, *request_,
+                   [self = shared_from_this()](beast::error_code const ec,
+                                               std::size_t const) {
+                     self->on_data_read(ec);
+                   });
+}
+
+void query_session_t::on_data_read(beast::error_code const ec) {
+  if (ec == http::error::end_of_stream) {
+    return shutdown_socket();
+  }
+  if (ec) {
+    spdlog::debug("query session: {}", ec.message());
+    return shutdown_socket();
+  }
+  handle_requests(*request_);
+}
+
+void query_session_t::handle_requests(string_request_t const &request) {
+  std::string const request_target{utilities::decode_url(request.target())};
+  boost::string_view request_target_view = request_target;
+  auto split = utilities::split_string_view(request_target_view, "?");
+  auto const iter = endpoint_apis_.get_rules(split[0]);
+  if (!iter.has_value()) {
+    return send_response(
+        error_response(http::status::not_found, "url not found", request));
+  }
+  auto const &rule = iter.value()->second;
+  auto const verbs_end = rule.verbs_.cbegin() + rule.num_verbs_;
+  if (std::find(rule.verbs_.cbegin(), verbs_end, request.method()) ==
+      verbs_end) {
+    return send_response(error_response(http::status::method_not_allowed,
+                                        "method not allowed", request));
+  }
+  boost::string_view const query_string = split.size() > 1 ? split[1] : "";
+  rule.route_callback_(request, utilities::split_url_query(query_string));
+}
+
+void query_session_t::history_handler(string_request_t const &request,
+                                      url_query_t const &query) {
+  auto bad_request = [&](std::string const &message) {
+    send_response(
+        error_response(http::status::bad_request, message, request));
+  };
+  auto const &history = request_handler_t::get_price_history();
+  if (!history.enabled()) {
+    return send_response(error_response(http::status::service_unavailable,
+                                        "the price history is not kept",
+                                        request));
+  }
+
+  history_query_t history_query{};
+  auto const symbol = query.find("symbol");
+  if (symbol == query.end()) {
+    return bad_request("symbol is missing");
+  }
+  history_query.symbol_id = request_handler_t::get_symbol_registry().find(
+      std::string_view(symbol->second.data(), symbol->second.size()));
+  if (history_query.symbol_id == invalid_symbol_id) {
+    return send_response(
+        error_response(http::status::not_found, "unknown symbol", request));
+  }
+
+  // there is no history past now
+  history_query.to = milliseconds_since_epoch();
+  if (auto const iter = query.find("to"); iter != query.end()) {
+    auto const to = to_integer(iter->second);
+    if (!to) {
+      return bad_request("invalid 'to'");
+    }
+    history_query.to = std::min(history_query.to, *to);
+  }
+  history_query.from = history_query.to - std::min(history_query.to,
+                                                   default_range);
+  if (auto const iter = query.find("from"); iter != query.end()) {
+    auto const from = to_integer(iter->second);
+    if (!from || *from > history_query.to) {
+      return bad_request("invalid 'from'");
+    }
+    history_query.from = *from;
+  }
+
+  auto const range = history_query.to - history_query.from;
+  if (auto const iter = query.find("resolution"); iter != query.end()) {
+    auto const resolution = to_integer(iter->second);
+    if (!resolution || *resolution == 0) {
+      return bad_request("invalid 'resolution'");
+    }
+    // a single bucket at most
+    history_query.bucket_width =
+        std::min(*resolution, range / milliseconds_per_second + 1) *
+        milliseconds_per_second;
+  } else {
+    auto const bucket_count = default_bucket_count * milliseconds_per_second;
+    history_query.bucket_width =
+        (range / bucket_count + 1) * milliseconds_per_second;
+  }
+
+  if (auto const iter = query.find("downsampling"); iter != query.end()) {
+    auto const downsampling = string_to_downsampling(
+        std::string_view(iter->second.data(), iter->second.size()));
+    if (!downsampling) {
+      return bad_request("'downsampling' is one of minmax, lttb and none");
+    }
+    history_query.downsampling = *downsampling;
+  }
+  if (history_query.downsampling == downsampling_e::none) {
+    if (range > max_raw_range) {
+      return bad_request("'downsampling=none' covers 7 days at most");
+    }
+  } else if (range / history_query.bucket_width >= max_bucket_count) {
+    return bad_request("'resolution' is too fine for this range");
+  }
+
+  history_query.next_from = history_query.from;
+  history_query.downsampler.emplace(history_query.downsampling,
+                                    history_query.from,
+                                    history_query.bucket_width);
+  query_.emplace(std::move(history_query));
+
+  auto &response = chunked_response_.emplace(http::status::ok,
+                                             request.version());
+  response.set(http::field::content_type, "application/json");
+  response.keep_alive(request.keep_alive());
+  response.chunked(true);
+  serializer_.emplace(response);
+
+  chunk_.clear();
+  fmt::format_to(std::back_inserter(chunk_),
+                 "{{\"symbol\":\"{}\",\"from\":{},\"to\":{},"
+                 "\"resolution\":{},\"downsampling\":\"{}\",\"points\":[",
+                 request_handler_t::get_symbol_registry().name(
+                     query_->symbol_id),
+                 query_->from, query_->to,
+                 query_->bucket_width / milliseconds_per_second,
+                 downsampling_to_string(query_->downsampling));
+  first_point_ = true;
+
+  tcp_stream_.expires_after(write_timeout);
+  http::async_write_header(
+      tcp_stream_, *serializer_,
+      [self = shared_from_this()](beast::error_code const ec,
+                                  std::size_t const) {
+        if (ec) {
+          spdlog::debug("query session: {}", ec.message());
+          return self->shutdown_socket();
+        }
+        self->write_next_chunk();
+      });
+}
+
+void query_session_t::rate_handler(string_request_t const &request,
+                                   url_query_t const &query) {
+  auto const &cross_rates = request_handler_t::get_cross_rates();
+  if (!cross_rates.enabled()) {
+    return send_response(error_response(http::status::service_unavailable,
+                                        "no home currency is configured",
+                                        request));
+  }
+  auto const base = query.find("base");
+  auto const quote = query.find("quote");
+  if (base == query.end() || quote == query.end()) {
+    return send_response(error_response(
+        http::status::bad_request, "base or quote is missing", request));
+  }
+  std::string_view const base_asset(base->second.data(), base->second.size());
+  std::string_view const quote_asset(quote->second.data(),
+                                     quote->second.size());
+  auto const price = cross_rates.implied_price(base_asset, quote_asset);
+  if (!price) {
+    return send_response(error_response(http::status::not_found,
+                                        "no implied price for this pair",
+                                        request));
+  }
+
+  nlohmann::json::object_t body{};
+  body["base"] = base_asset;
+  body["quote"] = quote_asset;
+  body["price"] = *price;
+  string_response_t response{http::status::ok, request.version()};
+  response.set(http::field::content_type, "application/json");
+  response.keep_alive(request.keep_alive());
+  response.body() = nlohmann::json(body).dump();
+  response.prepare_payload();
+  send_response(std::move(response));
+}
+
+bool query_session_t::fill_next_chunk() {
+  auto &history_query = *query_;
+  auto const &history = request_handler_t::get_price_history();
+  auto const slice_width =
+      history_query.downsampling == downsampling_e::none
+          ? raw_slice_width
+          : history_query.bucket_width * buckets_per_chunk;
+
+  bool done = false;
+  for (std::size_t slice = 0;
+       !done && chunk_.empty() && slice != max_slices_per_fill; ++slice) {
+    auto const from = history_query.next_from;
+    done = history_query.to - from < slice_width;
+    auto const to = done ? history_query.to : from + slice_width - 1;
+    history.scan(history_query.symbol_id, from, to,
+                 [&](price_point_t const &point) {
+                   history_query.downsampler->add(point, points_);
+                 });
+    if (done) {
+      history_query.downsampler->finish(points_);
+    } else {
+      history_query.next_from = to + 1;
+    }
+    for (auto const &point : points_) {
+      fmt::format_to(std::back_inserter(chunk_), "{}[{},\"{}\"]",
+                     first_point_ ? "" : ",", point.time, point.price);
+      first_point_ = false;
+    }
+    points_.clear();
+  }
+  if (done) {
+    chunk_ += "]}";
+  }
+  return done;
+}
+
+void query_session_t::write_next_chunk() {
+  auto const done = fill_next_chunk();
+  if (!done && chunk_.empty()) {
+    // an empty chunk would end the response: the next slices are scanned
+    // once the other sessions had their turn
+    return net::post(tcp_stream_.get_executor(),
+                     [self = shared_from_this()] { self->write_next_chunk(); });
+  }
+  tcp_stream_.expires_after(write_timeout);
+  net::async_write(
+      tcp_stream_, http::make_chunk(net::buffer(chunk_)),
+      [self = shared_from_this(), done](beast::error_code const ec,
+                                        std::size_t const) {
+        if (ec) {
+          spdlog::debug("query session: {}", ec.message());
+          return self->shutdown_socket();
+        }
+        self->chunk_.clear();
+        if (!done) {
+          return self->write_next_chunk();
+        }
+        net::async_write(self->tcp_stream_, http::make_chunk_last(),
+                         [self](beast::error_code const ec,
+                                std::size_t const) {
+                           self->on_data_written(
+                               ec, self->chunked_response_->keep_alive());
+                         });
+      });
+}
+
+void query_session_t::send_response(string_response_t &&response) {
+  auto const keep_alive = response.keep_alive();
+  response_.emplace(std::move(response));
+  tcp_stream_.expires_after(write_timeout);
+  http::async_write(tcp_stream_, *response_,
+                    [self = shared_from_this(),
+                     keep_alive](beast::error_code const ec,
+                                 std::size_t const) {
+                      self->on_data_written(ec, keep_alive);
+                    });
+}
+
+void query_session_t::on_data_written(beast::error_code const ec,
+                                      bool const keep_alive) {
+  response_.reset();
+  serializer_.reset();
+  chunked_response_.reset();
+  query_.reset();
+  if (ec) {
+    spdlog::debug("query session: {}", ec.message());
+    return shutdown_socket();
+  }
+  if (!keep_alive) {
+    return shutdown_socket();
+  }
+  http_read_data();
+}
+
+void query_session_t::shutdown_socket() {
+  beast::error_code ec{};
+  tcp_stream_.socket().shutdown(net::socket_base::shutdown_send, ec);
+  tcp_stream_.close();
+}
+
+string_response_t
+query_session_t::error_response(http::status const status,
+                                std::string const &message,
+                                string_request_t const &request) {
+  nlohmann::json::object_t body{};
+  body["message"] = message;
+  string_response_t response{status, request.version()};
+  response.set(http::field::content_type, "application/json");
+  response.keep_alive(request.keep_alive());
+  response.body() = nlohmann::json(body).dump();
+  response.prepare_payload();
+  return response;
+}
+
+} // namespace binance
@@ -2,11 +2,50 @@
 
 namespace binance {
 
-waitable_container_t<pushed_subscription_data_t>
-    request_handler_t::tokens_container_{};
+// ~30 full-market miniTicker frames. Every market data connection pushes
+// into it, so it has to support several producers
+mpsc_ring_t<pushed_subscription_data_t> request_handler_t::tokens_container_{
+    65'536};
 
-locked_set_t<instrument_type_t> request_handler_t::all_listed_instruments_{};
+// holds at most one pending tick per symbol and stream type
+conflating_container_t<pushed_subscription_data_t, tick_conflation_t>
+    request_handler_t::latest_ticks_{tick_conflation_t::slot_count};
 
-subscription_data_map_t request_handler_t::all_pushed_sub_data_{};
+bool request_handler_t::conflating_ticks_{false};
+
+symbol_registry_t request_handler_t::symbol_registry_{};
+
+price_table_t request_handler_t::price_table_{};
+
+feed_arbiter_t request_handler_t::feed_arbiter_{};
+
+order_books_t request_handler_t::order_books_{};
+
+kline_builder_t request_handler_t::kline_builder_{};
+
+rolling_stats_t request_handler_t::rolling_stats_{};
+
+cross_rates_t request_handler_t::cross_rates_{symbol_registry_};
+
+arbitrage_detector_t request_handler_t::arbitrage_detector_{
+    symbol_registry_};
+
+price_history_t request_handler_t::price_history_{};
+
+// defined before the task engines, which are constructed with it
+task_registry_t request_handler_t::task_registry_{};
+
+price_thresholds_t request_handler_t::price_thresholds_{task_registry_};
+
+pnl_engine_t request_handler_t::pnl_engine_{task_registry_};
+
+task_monitor_t request_handler_t::task_monitor_{
+    price_thresholds_, pnl_engine_, task_registry_};
+
+state_snapshot_t request_handler_t::state_snapshot_{};
+
+std::unique_ptr<frame_recorder_t> request_handler_t::frame_recorder_{};
+
+pipeline_latency_t request_handler_t::pipeline_latency_{};
 
 } // namespace binance
@@ -0,0 +1,290 @@
+#include "rolling_stats.hpp"
+#include "symbol_registry.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace binance {
+
+namespace {
+
+double squared_log_range(decimal_t const high, decimal_t const low) {
+  auto const log_range = std::log(high.to_double() / low.to_double());
+  return log_range * log_range;
+}
+
+} // namespace
+
+std::optional<std::uint64_t> string_to_window_ms(std::string_view str) {
+  std::uint64_t count{};
+  auto const [end, ec] =
+      std::from_chars(str.data(), str.data() + str.size(), count);
+  if (ec != std::errc{} || count == 0 ||
+      end + 1 != str.data() + str.size()) {
+    return std::nullopt;
+  }
+  switch (*end) {
+  case 's':
+    return count * 1'000;
+  case 'm':
+    return count * 60'000;
+  case 'h':
+    return count * 3'600'000;
+  case 'd':
+    return count * 86'400'000;
+  }
+  return std::nullopt;
+}
+
+rolling_stats_t::rolling_stats_t()
+    : series_{std::make_unique<std::atomic<series_t *>[]>(
+          symbol_registry_t::max_symbols)} {}
+
+void rolling_stats_t::configure(rolling_stats_config_t config) {
+  config_ = std::move(config);
+  config_.bucket_count = std::max<std::size_t>(config_.bucket_count, 1);
+}
+
+std::optional<std::uint32_t>
+rolling_stats_t::window_index(std::uint64_t const window_ms) const {
+  auto const iter = std::find(config_.windows_ms.cbegin(),
+                              config_.windows_ms.cend(), window_ms);
+  if (iter == config_.windows_ms.cend()) {
+    return std::nullopt;
+  }
+  return static_cast<std::uint32_t>(iter - config_.windows_ms.cbegin());
+}
+
+rolling_stats_t::series_t *
+rolling_stats_t::get_or_create(symbol_id_t const id) {
+  auto *series = series_[id].load(std::memory_order_relaxed);
+  if (series != nullptr) {
+    return series;
+  }
+  auto const bucket_count = config_.bucket_count;
+  auto &created = allocated_series_.emplace_back(
+      std::make_unique<series_t[]>(window_count()));
+  for (std::size_t i = 0; i != window_count(); ++i) {
+    auto &window_series = created[i];
+    window_series.symbol_id = id;
+    window_series.window_index = static_cast<std::uint32_t>(i);
+    window_series.bucket_ms =
+        std::max<std::uint64_t>(config_.windows_ms[i] / bucket_count, 1);
+    window_series.closed_buckets =
+        std::make_unique<bucket_t[]>(bucket_count);
+    window_series.highs.sequences =
+        std::make_unique<std::uint64_t[]>(bucket_count);
+    window_series.lows.sequences =
+        std::make_unique<std::uint64_t[]>(bucket_count);
+  }
+  series_[id].store(created.get(), std::memory_order_release);
+  return created.get();
+}
+
+rolling_stats_t::bucket_t const &
+rolling_stats_t::closed_bucket(series_t const &series,
+                               std::uint64_t const sequence) const {
+  return series.closed_buckets[sequence % config_.bucket_count];
+}
+
+void rolling_stats_t::close_bucket(series_t &series) {
+  auto const bucket_count = config_.bucket_count;
+  auto const &bucket = series.open_bucket;
+  auto const sequence = series.next++;
+  series.closed_buckets[sequence % bucket_count] = bucket;
+
+  // the buckets a new one outdoes can never be the high (or low) again
+  auto &highs = series.highs;
+  while (highs.back != highs.front &&
+         closed_bucket(series, highs.sequences[(highs.back - 1) %
+                                               bucket_count])
+                 .high <= bucket.high) {
+    --highs.back;
+  }
+  highs.sequences[highs.back++ % bucket_count] = sequence;
+  auto &lows = series.lows;
+  while (lows.back != lows.front &&
+         closed_bucket(series, lows.sequences[(lows.back - 1) % bucket_count])
+                 .low >= bucket.low) {
+    --lows.back;
+  }
+  lows.sequences[lows.back++ % bucket_count] = sequence;
+
+  series.tick_count += bucket.tick_count;
+  series.volume += bucket.volume;
+  series.weighted_prices += bucket.weighted_prices;
+  series.weights += bucket.weights;
+  series.realized_range += squared_log_range(bucket.high, bucket.low);
+  series.open_bucket.tick_count = 0;
+
+  // the floating point sums are rebuilt every time the ring wraps, so the
+  // rounding errors of the subtractions never add up
+  if (series.next % bucket_count == 0) {
+    resum(series);
+  }
+}
+
+void rolling_stats_t::resum(series_t &series) const {
+  series.weighted_prices = series.weights = series.realized_range = 0;
+  for (auto sequence = series.oldest; sequence != series.next; ++sequence) {
+    auto const &bucket = closed_bucket(series, sequence);
+    series.weighted_prices += bucket.weighted_prices;
+    series.weights += bucket.weights;
+    series.realized_range += squared_log_range(bucket.high, bucket.low);
+  }
+}
+
+bool rolling_stats_t::advance(series_t &series,
+                              std::uint64_t const bucket_index) {
+  bool changed = false;
+  if (series.open_bucket.tick_count != 0 &&
+      bucket_index > series.open_bucket.index) {
+    close_bucket(series);
+    changed = true;
+  }
+  series.current_index = std::max(series.current_index, bucket_index);
+
+  while (series.oldest != series.next) {
+    auto const &bucket = closed_bucket(series, series.oldest);
+    if (bucket.index + config_.bucket_count > series.current_index) {
+      break;
+    }
+    series.tick_count -= bucket.tick_count;
+    series.volume -= bucket.volume;
+    series.weighted_prices -= bucket.weighted_prices;
+    series.weights -= bucket.weights;
+    series.realized_range -= squared_log_range(bucket.high, bucket.low);
+    if (series.highs.sequences[series.highs.front % config_.bucket_count] ==
+        series.oldest) {
+      ++series.highs.front;
+    }
+    if (series.lows.sequences[series.lows.front % config_.bucket_count] ==
+        series.oldest) {
+      ++series.lows.front;
+    }
+    ++series.oldest;
+    changed = true;
+  }
+  if (series.oldest == series.next) {
+    series.weighted_prices = series.weights = series.realized_range = 0;
+  }
+  return changed;
+}
+
+void rolling_stats_t::publish(series_t &series) {
+  auto const &open_bucket = series.open_bucket;
+  bool const has_closed = series.oldest != series.next;
+  bool const has_open = open_bucket.tick_count != 0;
+
+  rolling_window_stats_t stats{};
+  stats.symbol_id = series.symbol_id;
+  stats.window_index = series.window_index;
+  stats.tick_count = series.tick_count + open_bucket.tick_count;
+  stats.last_event_time = series.last_event_time;
+  if (stats.tick_count == 0) {
+    return series.published.store(stats);
+  }
+
+  auto const bucket_count = config_.bucket_count;
+  stats.first_time = (has_closed ? closed_bucket(series, series.oldest).index
+                                 : open_bucket.index) *
+                     series.bucket_ms;
+  stats.volume = series.volume;
+  auto weighted_prices = series.weighted_prices;
+  auto weights = series.weights;
+  auto realized_range = series.realized_range;
+  if (has_closed) {
+    stats.high = closed_bucket(series, series.highs.sequences[
+                                           series.highs.front % bucket_count])
+                     .high;
+    stats.low = closed_bucket(series, series.lows.sequences[
+                                          series.lows.front % bucket_count])
+                    .low;
+  }
+  if (has_open) {
+    stats.high = has_closed ? std::max(stats.high, open_bucket.high)
+                            : open_bucket.high;
+    stats.low =
+        has_closed ? std::min(stats.low, open_bucket.low) : open_bucket.low;
+    stats.volume += open_bucket.volume;
+    weighted_prices += open_bucket.weighted_prices;
+    weights += open_bucket.weights;
+    realized_range += squared_log_range(open_bucket.high, open_bucket.low);
+  }
+  if (weights > 0) {
+    stats.vwap = decimal_t::from_double(weighted_prices / weights);
+  }
+  stats.realized_range = std::max(realized_range, 0.0);
+  series.published.store(stats);
+}
+
+void rolling_stats_t::on_tick(pushed_subscription_data_t const &tick) {
+  if (!enabled() || tick.stream_type != config_.source ||
+      tick.symbol_id >= symbol_registry_t::max_symbols ||
+      tick.event_time == 0 || tick.current_price <= decimal_t{}) {
+    return;
+  }
+
+  auto *symbol_series = get_or_create(tick.symbol_id);
+  auto const price = tick.current_price.to_double();
+  // streams without quantities weigh every tick the same
+  auto const weight =
+      tick.quantity.is_zero() ? 1.0 : tick.quantity.to_double();
+  for (std::size_t i = 0; i != window_count(); ++i) {
+    auto &series = symbol_series[i];
+    auto bucket_index = tick.event_time / series.bucket_ms;
+    if (bucket_index < series.current_index) {
+      // a tick that is late for a window is late for the shortest too
+      late_ticks_ += i == 0;
+      bucket_index = series.current_index;
+    }
+    advance(series, bucket_index);
+
+    auto &bucket = series.open_bucket;
+    if (bucket.tick_count == 0) {
+      bucket = bucket_t{};
+      bucket.index = bucket_index;
+      bucket.high = bucket.low = tick.current_price;
+    }
+    ++bucket.tick_count;
+    bucket.high = std::max(bucket.high, tick.current_price);
+    bucket.low = std::min(bucket.low, tick.current_price);
+    bucket.volume += tick.quantity;
+    bucket.weighted_prices += price * weight;
+    bucket.weights += weight;
+    series.last_event_time =
+        std::max(series.last_event_time, tick.event_time);
+    publish(series);
+  }
+}
+
+void rolling_stats_t::expire(std::uint64_t const now_ms) {
+  for (auto const &symbol_series : allocated_series_) {
+    for (std::size_t i = 0; i != window_count(); ++i) {
+      auto &series = symbol_series[i];
+      if (advance(series, now_ms / series.bucket_ms)) {
+        publish(series);
+      }
+    }
+  }
+}
+
+std::optional<rolling_window_stats_t>
+rolling_stats_t::stats(symbol_id_t const id,
+                       std::uint32_t const window_index) const {
+  if (id >= symbol_registry_t::max_symbols || window_index >= window_count()) {
+    return std::nullopt;
+  }
+  auto const *symbol_series = series_[id].load(std::memory_order_acquire);
+  if (symbol_series == nullptr) {
+    return std::nullopt;
+  }
+  auto const stats = symbol_series[window_index].published.load();
+  if (stats.tick_count == 0) {
+    return std::nullopt;
+  }
+  return stats;
+}
+
+} // namespace binance
@@ -0,0 +1,298 @@
+#include "state_snapshot.hpp"
+#include "common/mapped_file.hpp"
+#include "request_handler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <type_traits>
+
+namespace binance {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char snapshot_magic[4] = {'B', 'N', 'S', 'S'};
+// 2: kline_t keeps its volume in a decimal_sum_t
+constexpr std::uint32_t snapshot_version = 2;
+
+struct snapshot_header_t {
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t written_at; // in milliseconds
+  std::uint32_t symbol_count;
+  std::uint32_t price_count;
+  std::uint32_t bar_count;
+  std::uint32_t reserved;
+};
+
+// the name of the symbol whose ID is its index, NUL-padded
+struct snapshot_symbol_t {
+  char name[symbol_registry_t::max_symbol_length];
+};
+
+struct snapshot_price_t {
+  symbol_id_t symbol_id;
+  std::uint32_t reserved;
+  std::int64_t price;    // units of decimal_t
+  std::int64_t open_24h; // units of decimal_t
+  std::uint64_t event_time;
+};
+
+// every section starts 8-byte aligned, so the file is read in place
+static_assert(sizeof(snapshot_header_t) % 8 == 0);
+static_assert(sizeof(snapshot_symbol_t) % 8 == 0);
+static_assert(sizeof(snapshot_price_t) % 8 == 0);
+static_assert(std::is_trivially_copyable_v<kline_t> &&
+              alignof(kline_t) <= 8);
+
+std::uint64_t milliseconds_since_epoch() {
+  using namespace std::chrono;
+  return static_cast<std::uint64_t>(
+      duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+          .count());
+}
+
+template <typename T>
+void write_section(std::ofstream &file, std::vector<T> const &items) {
+  file.write(reinterpret_cast<char const *>(items.data()),
+             static_cast<std::streamsize>(items.size() * sizeof(T)));
+}
+
+} // namespace
+
+void state_snapshot_t::configure(state_snapshot_config_t config) {
+  config_ = std::move(config);
+}
+
+void state_snapshot_t::run() {
+  thread_ = std::thread([this] { take_snapshots(); });
+  thread_.detach();
+}
+
+void state_snapshot_t::take_snapshots() {
+  while (true) {
+    std::this_thread::sleep_for(config_.interval);
+    write();
+  }
+}
+
+bool state_snapshot_t::write() const {
+  auto const &symbols = request_handler_t::get_symbol_registry();
+  auto const &price_table = request_handler_t::get_price_table();
+  auto const &kline_builder = request_handler_t::get_kline_builder();
+
+  // only the slots of the IDs below `symbol_count` are read, so every price
+  // and bar has its symbol in the snapshot
+  auto const symbol_count = symbols.size();
+  std::vector<snapshot_symbol_t> names(symbol_count);
+  for (std::size_t id = 0; id != symbol_count; ++id) {
+    auto const &name = symbols.name(static_cast<symbol_id_t>(id));
+    std::memcpy(names[id].name, name.data(),
+                std::min(name.size(), sizeof(names[id].name)));
+  }
+
+  std::vector<pushed_subscription_data_t> ticks{};
+  price_table.snapshot(symbol_count, ticks);
+  std::vector<snapshot_price_t> prices{};
+  prices.reserve(ticks.size());
+  for (auto const &tick : ticks) {
+    prices.push_back({tick.symbol_id, 0, tick.current_price.units(),
+                      tick.open_24h.units(), tick.event_time});
+  }
+
+  std::vector<kline_t> bars{};
+  if (kline_builder.enabled()) {
+    for (std::size_t id = 0; id != symbol_count; ++id) {
+      for (std::size_t i = 0; i != kline_interval_count; ++i) {
+        if (auto const bar =
+                kline_builder.open_bar(static_cast<symbol_id_t>(id),
+                                       static_cast<kline_interval_e>(i))) {
+          bars.push_back(*bar);
+        }
+      }
+    }
+  }
+
+  snapshot_header_t header{};
+  std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+  header.version = snapshot_version;
+  header.written_at = milliseconds_since_epoch();
+  header.symbol_count = static_cast<std::uint32_t>(names.size());
+  header.price_count = static_cast<std::uint32_t>(prices.size());
+  header.bar_count = static_cast<std::uint32_t>(bars.size());
+
+  auto const temporary_name = config_.filename + ".tmp";
+  {
+    std::ofstream file{temporary_name, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    write_section(file, names);
+    write_section(file, prices);
+    write_section(file, bars);
+    file.flush();
+    if (!file) {
+      spdlog::error("unable to write the state snapshot to '{}'",
+                    temporary_name);
+      return false;
+    }
+  }
+  std::error_code ec{};
+  fs::rename(temporary_name, config_.filename, ec);
+  if (ec) {
+    spdlog::error("unable to rename '{}' to '{}': {}", temporary_name,
+                  config_.filename, ec.message());
+    return false;
+  }
+  return true;
+}
+
+bool state_snapshot_t::load() {
+  auto &symbols = request_handler_t::get_symbol_registry();
+  if (symbols.size() != 0) {
+    throw std::runtime_error(
+        "the state snapshot must be loaded before any symbol is registered");
+  }
+  if (std::error_code ec{}; !fs::exists(config_.filename, ec)) {
+    spdlog::info("no state snapshot to restore in '{}'", config_.filename);
+    return false;
+  }
+
+  auto const started_at = std::chrono::steady_clock::now();
+  mapped_file_t file{};
+  if (!file.open(config_.filename)) {
+    return false;
+  }
+  snapshot_header_t header{};
+  if (file.size() >= sizeof(header)) {
+    std::memcpy(&header, file.data(), sizeof(header));
+  }
+  auto const names_offset = sizeof(header);
+  auto const prices_offset =
+      names_offset + std::size_t{header.symbol_count} *
+                         sizeof(snapshot_symbol_t);
+  auto const bars_offset =
+      prices_offset + std::size_t{header.price_count} *
+                          sizeof(snapshot_price_t);
+  auto const file_size =
+      bars_offset + std::size_t{header.bar_count} * sizeof(kline_t);
+  if (std::memcmp(header.magic, snapshot_magic, sizeof(header.magic)) != 0 ||
+      header.version != snapshot_version ||
+      header.symbol_count > symbol_registry_t::max_symbols ||
+      file.size() != file_size) {
+    spdlog::error("'{}' is not a complete state snapshot", config_.filename);
+    return false;
+  }
+
+  auto const names = reinterpret_cast<snapshot_symbol_t const *>(
+      file.data() + names_offset);
+  for (std::uint32_t id = 0; id != header.symbol_count; ++id) {
+    auto const &name = names[id].name;
+    auto const length = static_cast<std::size_t>(
+        std::find(name, name + sizeof(name), '\0') - name);
+    // the registry was empty, so the IDs come out as they were numbered
+    if (symbols.get_or_insert(std::string_view(name, length)) != id) {
+      spdlog::error("the symbol table of '{}' is corrupt", config_.filename);
+      return false;
+    }
+  }
+
+  auto &price_table = request_handler_t::get_price_table();
+  auto const prices = reinterpret_cast<snapshot_price_t const *>(
+      file.data() + prices_offset);
+  for (std::uint32_t i = 0; i != header.price_count; ++i) {
+    auto const &price = prices[i];
+    if (price.symbol_id >= header.symbol_count) {
+      continue;
+    }
+    pushed_subscription_data_t tick{};
+    tick.symbol_id = price.symbol_id;
+    tick.stream_type = stream_type_e::mini_ticker;
+    tick.current_price = decimal_t::from_units(price.price);
+    tick.open_24h = decimal_t::from_units(price.open_24h);
+    tick.event_time = price.event_time;
+    price_table.update(tick);
+  }
+
+  auto &kline_builder = request_handler_t::get_kline_builder();
+  auto const bars =
+      reinterpret_cast<kline_t const *>(file.data() + bars_offset);
+  for (std::uint32_t i = 0; i != header.bar_count; ++i) {
+    if (bars[i].symbol_id < header.symbol_count) {
+      kline_builder.restore_open_bar(bars[i]);
+    }
+  }
+
+  restored_at_ = std::max<std::uint64_t>(header.written_at, 1);
+  restored_symbol_count_ = header.symbol_count;
+  auto const elapsed = std::chrono::steady_clock::now() - started_at;
+  auto const now = milliseconds_since_epoch();
+  auto const age = now > header.written_at ? now - header.written_at : 0;
+  spdlog::info(
+      "restored {} symbols, {} prices and {} candles from a snapshot taken "
+      "{} s ago in {} us",
+      header.symbol_count, header.price_count, header.bar_count, age / 1'000,
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  return true;
+}
+
+void state_snapshot_t::reconcile(
+    std::vector<pushed_subscription_data_t> &&listed) {
+  std::vector<bool> is_listed(restored_symbol_count_, false);
+  std::size_t new_symbol_count{};
+
+  std::size_t kept{};
+  for (auto &tick : listed) {
+    if (tick.symbol_id >= restored_symbol_count_) {
+      ++new_symbol_count;
+      continue;
+    }
+    is_listed[tick.symbol_id] = true;
+    listed[kept++] = tick;
+  }
+  listed.resize(kept);
+
+  spdlog::info("reconciled the snapshot with the listing: {} prices "
+               "fetched, {} new symbols, {} no longer listed",
+               listed.size(), new_symbol_count,
+               std::count(is_listed.cbegin(), is_listed.cend(), false));
+
+  std::lock_guard<std::mutex> lock_g{reconciled_mutex_};
+  reconciled_prices_ = std::move(listed);
+  has_reconciled_prices_.store(true, std::memory_order_release);
+}
+
+void state_snapshot_t::apply_reconciled_prices() {
+  if (!has_reconciled_prices_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::vector<pushed_subscription_data_t> listed{};
+  {
+    std::lock_guard<std::mutex> lock_g{reconciled_mutex_};
+    listed.swap(reconciled_prices_);
+    has_reconciled_prices_.store(false, std::memory_order_relaxed);
+  }
+
+  auto &price_table = request_handler_t::get_price_table();
+  std::size_t refreshed{};
+  for (auto const &tick : listed) {
+    // symbols without a price, and with a live tick since the snapshot, are
+    // left to the websockets. This runs on the table's writer, so no tick
+    // can land between the check and the write
+    auto current = price_table.get(tick.symbol_id);
+    if (!current || current->event_time > restored_at_) {
+      continue;
+    }
+    // the REST API has no 24h open and no event time: the restored ones
+    // stay, so the price still reads as older than any live tick
+    current->stream_type = stream_type_e::mini_ticker;
+    current->current_price = tick.current_price;
+    price_table.update(*current);
+    ++refreshed;
+  }
+  spdlog::info("refreshed {} restored prices from the listing", refreshed);
+}
+
+} // namespace binance
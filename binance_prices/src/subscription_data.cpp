@@ -0,0 +1,53 @@
+#include "subscription_data.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace binance {
+
+std::string task_state_to_string(task_state_e const state) {
+  switch (state) {
+  case task_state_e::initiated:
+    return "initiated";
+  case task_state_e::running:
+    return "running";
+  case task_state_e::stopped:
+    return "stopped";
+  case task_state_e::restarted:
+    return "restarted";
+  case task_state_e::remove:
+    return "remove";
+  case task_state_e::unknown:
+    break;
+  }
+  return "unknown";
+}
+
+std::string direction_to_string(trade_direction_e const direction) {
+  switch (direction) {
+  case trade_direction_e::sell:
+    return "sell";
+  case trade_direction_e::buy:
+    return "buy";
+  case trade_direction_e::none:
+    break;
+  }
+  return "none";
+}
+
+// Binance spells them "BUY" and "SELL"
+trade_direction_e string_to_direction(std::string const &str) {
+  std::string lower(str.size(), '\0');
+  std::transform(str.begin(), str.end(), lower.begin(), [](char const ch) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+  });
+  if (lower == "sell") {
+    return trade_direction_e::sell;
+  }
+  if (lower == "buy") {
+    return trade_direction_e::buy;
+  }
+  return trade_direction_e::none;
+}
+
+} // namespace binance
@@ -0,0 +1,79 @@
+#include "symbol_registry.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace binance {
+
+namespace {
+
+bool needs_upper_casing(std::string_view const symbol) {
+  return std::any_of(symbol.cbegin(), symbol.cend(),
+                     [](char const ch) { return ch >= 'a' && ch <= 'z'; });
+}
+
+std::string_view to_upper(std::string_view const symbol, char *buffer) {
+  std::transform(symbol.cbegin(), symbol.cend(), buffer, [](char const ch) {
+    return (ch >= 'a' && ch <= 'z') ? static_cast<char>(ch - 'a' + 'A') : ch;
+  });
+  return std::string_view(buffer, symbol.size());
+}
+
+} // namespace
+
+symbol_registry_t::symbol_registry_t()
+    : names_{std::make_unique<std::string[]>(max_symbols)} {
+  ids_.reserve(max_symbols);
+}
+
+symbol_id_t symbol_registry_t::find(std::string_view symbol) const {
+  // symbols are short, so the upper-cased copy used for lookups lives on
+  // the stack
+  char buffer[max_symbol_length];
+  if (symbol.size() > max_symbol_length) {
+    return invalid_symbol_id;
+  }
+  if (needs_upper_casing(symbol)) {
+    symbol = to_upper(symbol, buffer);
+  }
+
+  std::shared_lock<std::shared_mutex> lock_g{mutex_};
+  if (auto const iter = ids_.find(symbol); iter != ids_.cend()) {
+    return iter->second;
+  }
+  return invalid_symbol_id;
+}
+
+symbol_id_t symbol_registry_t::get_or_insert(std::string_view symbol) {
+  char buffer[max_symbol_length];
+  if (symbol.empty() || symbol.size() > max_symbol_length) {
+    return invalid_symbol_id;
+  }
+  if (needs_upper_casing(symbol)) {
+    symbol = to_upper(symbol, buffer);
+  }
+
+  {
+    std::shared_lock<std::shared_mutex> lock_g{mutex_};
+    if (auto const iter = ids_.find(symbol); iter != ids_.cend()) {
+      return iter->second;
+    }
+  }
+
+  std::lock_guard<std::shared_mutex> lock_g{mutex_};
+  // another thread may have inserted it while we were not holding the lock
+  if (auto const iter = ids_.find(symbol); iter != ids_.cend()) {
+    return iter->second;
+  }
+  auto const id = size_.load(std::memory_order_relaxed);
+  if (id == max_symbols) {
+    return invalid_symbol_id;
+  }
+  names_[id].assign(symbol.data(), symbol.size());
+  ids_.emplace(names_[id], id);
+  // publishes names_[id] to the lock-free readers of name()
+  size_.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+} // namespace binance
@@ -0,0 +1,167 @@
+#include "task_monitor.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <boost/asio/post.hpp>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+task_monitor_t::task_monitor_t(price_thresholds_t &price_thresholds,
+                               pnl_engine_t &pnl_engine,
+                               task_registry_t const &registry)
+    : price_thresholds_{price_thresholds}, pnl_engine_{pnl_engine},
+      registry_{registry}, work_guard_{net::make_work_guard(io_context_)}, timer_{io_context_},
+      started_at_{std::chrono::steady_clock::now()} {}
+
+void task_monitor_t::subscribe(task_state_subscriber_t subscriber) {
+  subscribers_.push_back(std::move(subscriber));
+}
+
+void task_monitor_t::run() {
+  thread_ = std::thread([this] { io_context_.run(); });
+  thread_.detach();
+}
+
+bool task_monitor_t::add(scheduled_task_t task) {
+  auto request_id = task.request_id;
+  auto const task_type = task.task_type;
+  auto const monitor_time_secs = task.monitor_time_secs;
+  bool added = false;
+  switch (task_type) {
+  case task_type_e::price_changes:
+    added = price_thresholds_.add(std::move(task));
+    break;
+  case task_type_e::profit_and_loss:
+    added = pnl_engine_.add(std::move(task));
+    break;
+  case task_type_e::unknown:
+    spdlog::error("task '{}' has an unknown task type", request_id);
+    break;
+  }
+  if (!added) {
+    return false;
+  }
+
+  // a replaced task gets a new window, or none
+  net::post(io_context_, [this, request_id = std::move(request_id), task_type,
+                          monitor_time_secs]() mutable {
+    close_window(request_id);
+    if (monitor_time_secs != 0) {
+      open_window(std::move(request_id), task_type, monitor_time_secs);
+    }
+  });
+  return true;
+}
+
+void task_monitor_t::remove(std::string request_id) {
+  price_thresholds_.remove(request_id);
+  pnl_engine_.remove(request_id);
+  net::post(io_context_, [this, request_id = std::move(request_id)] {
+    close_window(request_id);
+    notify({request_id}, task_state_e::remove);
+  });
+}
+
+void task_monitor_t::open_window(std::string request_id,
+                                 task_type_e const task_type,
+                                 std::size_t const monitor_time_secs) {
+  auto const now = std::chrono::steady_clock::now();
+  if (!ticking_) {
+    // the wheel is empty, it only has to catch up with the clock
+    windows_.advance(static_cast<std::uint64_t>((now - started_at_) /
+                                                tick_length),
+                     [](window_t &&) {});
+  }
+  auto const ticks = static_cast<std::uint64_t>(
+      std::chrono::seconds(monitor_time_secs) / tick_length);
+  auto const window_id =
+      windows_.schedule(ticks, window_t{request_id, task_type});
+  window_ids_[std::move(request_id)] = window_id;
+  size_.store(windows_.size(), std::memory_order_relaxed);
+  if (!ticking_) {
+    ticking_ = true;
+    wait_for_tick();
+  }
+}
+
+void task_monitor_t::close_window(std::string const &request_id) {
+  auto const iter = window_ids_.find(request_id);
+  if (iter == window_ids_.end()) {
+    return;
+  }
+  windows_.cancel(iter->second);
+  window_ids_.erase(iter);
+  size_.store(windows_.size(), std::memory_order_relaxed);
+}
+
+void task_monitor_t::wait_for_tick() {
+  timer_.expires_at(started_at_ + tick_length * (windows_.now() + 1));
+  timer_.async_wait([this](boost::system::error_code const &ec) {
+    if (ec) {
+      spdlog::error("task monitor timer: {}", ec.message());
+      ticking_ = false;
+      return;
+    }
+    on_tick();
+  });
+}
+
+void task_monitor_t::on_tick() {
+  auto const now = static_cast<std::uint64_t>(
+      (std::chrono::steady_clock::now() - started_at_) / tick_length);
+  windows_.advance(now, [this](window_t &&window) {
+    window_ids_.erase(window.request_id);
+    auto const engine =
+        window.task_type == task_type_e::price_changes ? 0 : 1;
+    stopped_[engine].push_back(std::move(window.request_id));
+  });
+  size_.store(windows_.size(), std::memory_order_relaxed);
+
+  // every task is removed, but only those still held are reported: a
+  // price_changes task that triggered released its request ID, it completed.
+  // They are looked up first, as the engines release the others on removal
+  std::vector<std::string> held{};
+  std::size_t count{};
+  for (std::size_t engine = 0; engine != 2; ++engine) {
+    auto &request_ids = stopped_[engine];
+    if (request_ids.empty()) {
+      continue;
+    }
+    held.clear();
+    std::copy_if(request_ids.cbegin(), request_ids.cend(),
+                 std::back_inserter(held),
+                 [this](std::string const &request_id) {
+                   return registry_.find(request_id).has_value();
+                 });
+    if (engine == 0) {
+      price_thresholds_.remove(request_ids);
+    } else {
+      pnl_engine_.remove(request_ids);
+    }
+    request_ids.clear();
+    if (!held.empty()) {
+      count += held.size();
+      notify(held, task_state_e::stopped);
+    }
+  }
+  if (count != 0) {
+    spdlog::info("{} tasks stopped at the end of their monitoring window",
+                 count);
+  }
+
+  if (windows_.empty()) {
+    ticking_ = false;
+  } else {
+    wait_for_tick();
+  }
+}
+
+void task_monitor_t::notify(std::vector<std::string> const &request_ids,
+                            task_state_e const state) {
+  for (auto const &subscriber : subscribers_) {
+    subscriber(request_ids, state);
+  }
+}
+
+} // namespace binance
@@ -0,0 +1,93 @@
+#include "task_registry.hpp"
+
+#include <mutex>
+
+namespace binance {
+
+task_handle_t task_registry_t::acquire(std::string const &request_id) {
+  std::unique_lock<std::shared_mutex> lock{mutex_};
+  if (auto const iter = task_indices_.find(request_id);
+      iter != task_indices_.end()) {
+    auto &entry = tasks_[iter->second];
+    ++entry.references;
+    return {iter->second, entry.generation};
+  }
+
+  std::uint32_t index{};
+  if (free_indices_.empty()) {
+    index = static_cast<std::uint32_t>(tasks_.size());
+    tasks_.emplace_back();
+  } else {
+    index = free_indices_.front();
+    free_indices_.pop_front();
+  }
+  auto &entry = tasks_[index];
+  entry.request_id = request_id;
+  ++entry.generation;
+  entry.references = 1;
+  task_indices_.emplace(request_id, index);
+  return {index, entry.generation};
+}
+
+void task_registry_t::release(task_handle_t const handle) {
+  std::unique_lock<std::shared_mutex> lock{mutex_};
+  if (handle.index >= tasks_.size()) {
+    return;
+  }
+  auto &entry = tasks_[handle.index];
+  if (entry.generation != handle.generation || entry.references == 0) {
+    return;
+  }
+  if (--entry.references == 0) {
+    // the name stays until the index is reused, for the results in flight
+    task_indices_.erase(entry.request_id);
+    free_indices_.push_back(handle.index);
+  }
+}
+
+std::optional<task_handle_t>
+task_registry_t::find(std::string const &request_id) const {
+  std::shared_lock<std::shared_mutex> lock{mutex_};
+  auto const iter = task_indices_.find(request_id);
+  if (iter == task_indices_.end()) {
+    return std::nullopt;
+  }
+  return task_handle_t{iter->second, tasks_[iter->second].generation};
+}
+
+user_id_t task_registry_t::get_or_insert_user(std::string const &username) {
+  {
+    std::shared_lock<std::shared_mutex> lock{mutex_};
+    if (auto const iter = user_ids_.find(username); iter != user_ids_.end()) {
+      return iter->second;
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock{mutex_};
+  auto const [iter, inserted] =
+      user_ids_.emplace(username, static_cast<user_id_t>(users_.size()));
+  if (inserted) {
+    users_.push_back(username);
+  }
+  return iter->second;
+}
+
+std::string task_registry_t::request_id(task_handle_t const handle) const {
+  std::shared_lock<std::shared_mutex> lock{mutex_};
+  if (handle.index >= tasks_.size() ||
+      tasks_[handle.index].generation != handle.generation) {
+    return {};
+  }
+  return tasks_[handle.index].request_id;
+}
+
+std::string task_registry_t::username(user_id_t const id) const {
+  std::shared_lock<std::shared_mutex> lock{mutex_};
+  return id < users_.size() ? users_[id] : std::string{};
+}
+
+std::size_t task_registry_t::size() const {
+  std::shared_lock<std::shared_mutex> lock{mutex_};
+  return task_indices_.size();
+}
+
+} // namespace binance
@@ -0,0 +1,98 @@
+#include "task_result_writer.hpp"
+#include "common/json_utils.hpp"
+#include "request_handler.hpp"
+
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+namespace {
+
+char const *task_type_to_string(task_type_e const type) {
+  switch (type) {
+  case task_type_e::profit_and_loss:
+    return "profit_and_loss";
+  case task_type_e::price_changes:
+    return "price_changes";
+  case task_type_e::unknown:
+    break;
+  }
+  return "unknown";
+}
+
+json::object_t to_json(scheduled_task_t::task_result_t const &result) {
+  auto const &tasks = request_handler_t::get_task_registry();
+  auto const &symbols = request_handler_t::get_symbol_registry();
+  json::object_t object{};
+  object["request_id"] = tasks.request_id(result.task);
+  object["username"] = tasks.username(result.user_id);
+  object["symbol"] = std::string(symbols.name(result.symbol_id));
+  object["time"] =
+      utilities::timet_to_string(result.event_time / 1'000).value_or("");
+  object["type"] = task_type_to_string(result.task_type);
+  object["direction"] = direction_to_string(result.direction);
+  object["column_id"] = result.column_id;
+  object["order_price"] = to_string(result.order_price);
+  object["mkt_price"] = to_string(result.mkt_price);
+  object["money"] = to_string(result.money);
+  object["quantity"] = to_string(result.quantity);
+  if (result.task_type == task_type_e::profit_and_loss) {
+    object["pnl"] = to_string(result.pnl);
+  }
+  return object;
+}
+
+} // namespace
+
+task_result_writer_t::task_result_writer_t(std::string filename)
+    : filename_{std::move(filename)}, results_{65'536} {}
+
+void task_result_writer_t::run(price_thresholds_t &price_thresholds,
+                               pnl_engine_t &pnl_engine) {
+  auto push = [this](scheduled_task_t::task_result_t const &result) {
+    if (results_.try_push_n(&result, 1) == 0) {
+      dropped_results_.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+  price_thresholds.subscribe(push);
+  pnl_engine.subscribe(push);
+  thread_ = std::thread([this] { write_results(); });
+  thread_.detach();
+}
+
+void task_result_writer_t::write_results() {
+  std::ofstream file{};
+  if (!filename_.empty()) {
+    file.open(filename_, std::ios::app);
+    if (!file) {
+      spdlog::error("unable to open '{}', the task results won't be saved",
+                    filename_);
+      return;
+    }
+  }
+
+  std::size_t const max_batch_size = 1'024;
+  std::vector<scheduled_task_t::task_result_t> results{};
+  results.reserve(max_batch_size);
+
+  while (true) {
+    results.clear();
+    results_.drain_up_to(results, max_batch_size);
+    for (auto const &result : results) {
+      auto const line = json(to_json(result)).dump();
+      if (file.is_open()) {
+        file << line << '\n';
+      } else if (result.task_type == task_type_e::price_changes) {
+        spdlog::info("task result: {}", line);
+      } else {
+        spdlog::debug("task result: {}", line);
+      }
+    }
+    if (file.is_open()) {
+      file.flush();
+    }
+  }
+}
+
+} // namespace binance
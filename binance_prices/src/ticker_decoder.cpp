@@ -0,0 +1,585 @@
+#include "ticker_decoder.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BINANCE_DECODER_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define BINANCE_DECODER_NEON
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace binance {
+
+namespace detail {
+
+namespace {
+
+#if defined(BINANCE_DECODER_SSE2) || defined(BINANCE_DECODER_NEON)
+inline unsigned count_trailing_zeros(std::uint32_t const mask) {
+#ifdef _MSC_VER
+  unsigned long index{};
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// bit `i` of the result is set if the i-th byte of the 16-byte block starting
+// at `p` is equal to either `a`, `b` or `c`
+inline std::uint32_t match_mask(char const *p, char const a, char const b,
+                                char const c) {
+#ifdef BINANCE_DECODER_SSE2
+  __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+  __m128i const matches =
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(a)),
+                                _mm_cmpeq_epi8(block, _mm_set1_epi8(b))),
+                   _mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(matches));
+#else
+  // NEON has no movemask, so give every lane its own bit and add them up
+  static std::uint8_t const lane_bits[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                             1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t const block = vld1q_u8(reinterpret_cast<std::uint8_t const *>(p));
+  uint8x16_t const matches = vorrq_u8(
+      vorrq_u8(vceqq_u8(block, vdupq_n_u8(static_cast<std::uint8_t>(a))),
+               vceqq_u8(block, vdupq_n_u8(static_cast<std::uint8_t>(b)))),
+      vceqq_u8(block, vdupq_n_u8(static_cast<std::uint8_t>(c))));
+  uint8x16_t const masked = vandq_u8(matches, vld1q_u8(lane_bits));
+  return static_cast<std::uint32_t>(vaddv_u8(vget_low_u8(masked))) |
+         (static_cast<std::uint32_t>(vaddv_u8(vget_high_u8(masked))) << 8);
+#endif
+}
+#endif
+
+inline char const *find_any_of(char const *first, char const *last,
+                               char const a, char const b,
+                               char const c) noexcept {
+#if defined(BINANCE_DECODER_SSE2) || defined(BINANCE_DECODER_NEON)
+  for (; last - first >= 16; first += 16) {
+    if (auto const mask = match_mask(first, a, b, c); mask != 0) {
+      return first + count_trailing_zeros(mask);
+    }
+  }
+#endif
+  for (; first != last; ++first) {
+    if (*first == a || *first == b || *first == c) {
+      return first;
+    }
+  }
+  return last;
+}
+
+} // namespace
+
+char const *find_quote_or_escape(char const *first,
+                                 char const *last) noexcept {
+  return find_any_of(first, last, '"', '\\', '"');
+}
+
+char const *find_value_end(char const *first, char const *last) noexcept {
+  return find_any_of(first, last, ',', '}', ']');
+}
+
+} // namespace detail
+
+namespace {
+
+class frame_cursor_t {
+  char const *current_;
+  char const *const end_;
+  symbol_registry_t &registry_;
+
+  [[noreturn]] void fail(char const *reason) const {
+    throw std::runtime_error(std::string("market data decoder: ") + reason);
+  }
+
+  void skip_whitespace() {
+    while (current_ != end_ && (*current_ == ' ' || *current_ == '\n' ||
+                                *current_ == '\r' || *current_ == '\t')) {
+      ++current_;
+    }
+  }
+
+  char peek() {
+    skip_whitespace();
+    if (current_ == end_) {
+      fail("unexpected end of frame");
+    }
+    return *current_;
+  }
+
+  void skip_nested_value() {
+    std::size_t depth{};
+    do {
+      char const ch = peek();
+      if (ch == '"') {
+        read_string();
+        continue;
+      }
+      if (ch == '{' || ch == '[') {
+        ++depth;
+      } else if (ch == '}' || ch == ']') {
+        --depth;
+      }
+      ++current_;
+    } while (depth != 0);
+  }
+
+public:
+  frame_cursor_t(std::string_view const frame, symbol_registry_t &registry)
+      : current_{frame.data()}, end_{frame.data() + frame.size()},
+        registry_{registry} {}
+
+  void expect(char const ch) {
+    if (peek() != ch) {
+      fail("unexpected character in frame");
+    }
+    ++current_;
+  }
+
+  bool consume_if(char const ch) {
+    if (peek() == ch) {
+      ++current_;
+      return true;
+    }
+    return false;
+  }
+
+  // the returned view is the raw content between the quotes; escape sequences
+  // are left as-is since none of the fields we use ever contain one.
+  std::string_view read_string() {
+    expect('"');
+    char const *const begin = current_;
+    while (true) {
+      auto const found = detail::find_quote_or_escape(current_, end_);
+      if (found == end_) {
+        fail("unterminated string");
+      }
+      if (*found == '"') {
+        current_ = found + 1;
+        return std::string_view(begin, found - begin);
+      }
+      // skip the backslash and the character it escapes
+      if (end_ - found < 2) {
+        fail("unterminated string");
+      }
+      current_ = found + 2;
+    }
+  }
+
+  std::uint64_t read_unsigned() {
+    skip_whitespace();
+    std::uint64_t value{};
+    auto const [ptr, ec] = std::from_chars(current_, end_, value);
+    if (ec != std::errc{}) {
+      fail("invalid integer");
+    }
+    current_ = ptr;
+    return value;
+  }
+
+  void skip_value() {
+    char const ch = peek();
+    if (ch == '"') {
+      read_string();
+    } else if (ch == '{' || ch == '[') {
+      skip_nested_value();
+    } else {
+      current_ = detail::find_value_end(current_, end_);
+    }
+  }
+
+  decimal_t to_decimal(std::string_view const str) const {
+    decimal_t value{};
+    auto const last = str.data() + str.size();
+    if (auto const [ptr, ec] = from_chars(str.data(), last, value);
+        ec != std::errc{} || ptr != last) {
+      fail("invalid price");
+    }
+    return value;
+  }
+
+  // calls `on_field(key)` for every key of an object; `on_field` must consume
+  // the value
+  template <typename Func> void read_object(Func &&on_field) {
+    expect('{');
+    if (consume_if('}')) {
+      return;
+    }
+    do {
+      auto const key = read_string();
+      expect(':');
+      on_field(key);
+    } while (consume_if(','));
+    expect('}');
+  }
+
+  symbol_id_t to_symbol_id(std::string_view const symbol) const {
+    if (symbol.empty()) {
+      fail("event is missing a required field");
+    }
+    auto const id = registry_.get_or_insert(symbol);
+    if (id == invalid_symbol_id) {
+      fail("symbol could not be registered");
+    }
+    return id;
+  }
+
+  // https://binance-docs.github.io/apidocs/spot/en/#individual-symbol-mini-ticker-stream
+  pushed_subscription_data_t read_mini_ticker() {
+    pushed_subscription_data_t data{};
+    std::string_view symbol{}, close_price{}, open_price{};
+
+    read_object([&](std::string_view const key) {
+      if (key.size() != 1) {
+        return skip_value();
+      }
+      switch (key[0]) {
+      case 's': // symbol => BTCDOGE, DOGEUSDT etc
+        symbol = read_string();
+        break;
+      case 'c':
+        close_price = read_string();
+        break;
+      case 'o':
+        open_price = read_string();
+        break;
+      case 'E':
+        data.event_time = read_unsigned();
+        break;
+      default:
+        skip_value();
+      }
+    });
+
+    if (close_price.empty() || open_price.empty()) {
+      fail("event is missing a required field");
+    }
+    data.symbol_id = to_symbol_id(symbol);
+    data.stream_type = stream_type_e::mini_ticker;
+    data.sequence = data.event_time;
+    data.current_price = to_decimal(close_price);
+    data.open_24h = to_decimal(open_price);
+    return data;
+  }
+
+  // https://binance-docs.github.io/apidocs/spot/en/#individual-symbol-book-ticker-streams
+  pushed_subscription_data_t read_book_ticker() {
+    pushed_subscription_data_t data{};
+    std::string_view symbol{}, bid_price{}, ask_price{};
+
+    read_object([&](std::string_view const key) {
+      if (key.size() != 1) {
+        return skip_value();
+      }
+      switch (key[0]) {
+      case 's':
+        symbol = read_string();
+        break;
+      case 'u': // order book update ID
+        data.sequence = read_unsigned();
+        break;
+      case 'b': // best bid price
+        bid_price = read_string();
+        break;
+      case 'a': // best ask price
+        ask_price = read_string();
+        break;
+      default:
+        skip_value();
+      }
+    });
+
+    if (bid_price.empty() || ask_price.empty()) {
+      fail("event is missing a required field");
+    }
+    data.symbol_id = to_symbol_id(symbol);
+    data.stream_type = stream_type_e::book_ticker;
+    auto const mid_units =
+        (to_decimal(bid_price).units() + to_decimal(ask_price).units()) / 2;
+    data.current_price = decimal_t::from_units(mid_units);
+    return data;
+  }
+
+  // https://binance-docs.github.io/apidocs/spot/en/#aggregate-trade-streams
+  pushed_subscription_data_t read_agg_trade() {
+    pushed_subscription_data_t data{};
+    std::string_view symbol{}, price{}, quantity{};
+
+    read_object([&](std::string_view const key) {
+      if (key.size() != 1) {
+        return skip_value();
+      }
+      switch (key[0]) {
+      case 's':
+        symbol = read_string();
+        break;
+      case 'p':
+        price = read_string();
+        break;
+      case 'q':
+        quantity = read_string();
+        break;
+      case 'a': // aggregate trade ID
+        data.sequence = read_unsigned();
+        break;
+      case 'E':
+        data.event_time = read_unsigned();
+        break;
+      default:
+        skip_value();
+      }
+    });
+
+    if (price.empty() || quantity.empty()) {
+      fail("event is missing a required field");
+    }
+    data.symbol_id = to_symbol_id(symbol);
+    data.stream_type = stream_type_e::agg_trade;
+    data.current_price = to_decimal(price);
+    data.quantity = to_decimal(quantity);
+    return data;
+  }
+
+  void read_mini_ticker_array(std::vector<pushed_subscription_data_t> &result) {
+    expect('[');
+    if (consume_if(']')) {
+      return;
+    }
+    do {
+      result.push_back(read_mini_ticker());
+    } while (consume_if(','));
+    expect(']');
+  }
+
+  void read_payload(std::string_view const stream_name,
+                    std::vector<pushed_subscription_data_t> &result) {
+    if (stream_name == "!miniTicker@arr") {
+      return read_mini_ticker_array(result);
+    }
+    auto const at = stream_name.find('@');
+    auto const type = at == std::string_view::npos
+                          ? std::nullopt
+                          : string_to_stream_type(stream_name.substr(at + 1));
+    if (!type) {
+      return skip_value();
+    }
+    switch (*type) {
+    case stream_type_e::mini_ticker:
+      return result.push_back(read_mini_ticker());
+    case stream_type_e::book_ticker:
+      return result.push_back(read_book_ticker());
+    case stream_type_e::agg_trade:
+      return result.push_back(read_agg_trade());
+    }
+  }
+
+  // {"stream":"<streamName>","data":<rawPayload>}
+  void read_combined_frame(std::vector<pushed_subscription_data_t> &result) {
+    std::optional<std::string_view> stream_name{};
+    read_object([&](std::string_view const key) {
+      if (key == "stream") {
+        stream_name = read_string();
+      } else if (key == "data") {
+        if (!stream_name) {
+          fail("payload came before the stream name");
+        }
+        read_payload(*stream_name, result);
+      } else {
+        skip_value();
+      }
+    });
+  }
+
+  // [["price","quantity"], ...]
+  void read_levels(std::vector<price_level_t> &levels) {
+    levels.clear();
+    expect('[');
+    if (consume_if(']')) {
+      return;
+    }
+    do {
+      price_level_t level{};
+      expect('[');
+      level.price = to_decimal(read_string());
+      expect(',');
+      level.quantity = to_decimal(read_string());
+      while (consume_if(',')) {
+        skip_value();
+      }
+      expect(']');
+      levels.push_back(level);
+    } while (consume_if(','));
+    expect(']');
+  }
+
+  // https://binance-docs.github.io/apidocs/spot/en/#diff-depth-stream
+  void read_depth_update(depth_update_t &update) {
+    std::string_view symbol{};
+    bool has_update_ids = false;
+    update.bids.clear();
+    update.asks.clear();
+
+    read_object([&](std::string_view const key) {
+      if (key.size() != 1) {
+        return skip_value();
+      }
+      switch (key[0]) {
+      case 's':
+        symbol = read_string();
+        break;
+      case 'E':
+        update.event_time = read_unsigned();
+        break;
+      case 'U':
+        update.first_update_id = read_unsigned();
+        break;
+      case 'u':
+        update.final_update_id = read_unsigned();
+        has_update_ids = true;
+        break;
+      case 'b':
+        read_levels(update.bids);
+        break;
+      case 'a':
+        read_levels(update.asks);
+        break;
+      default:
+        skip_value();
+      }
+    });
+
+    if (!has_update_ids) {
+      fail("event is missing a required field");
+    }
+    update.symbol_id = to_symbol_id(symbol);
+  }
+
+  // returns false if the frame came from another stream
+  bool read_combined_depth_frame(depth_update_t &update) {
+    std::optional<std::string_view> stream_name{};
+    bool found = false;
+    read_object([&](std::string_view const key) {
+      if (key == "stream") {
+        stream_name = read_string();
+      } else if (key == "data") {
+        if (!stream_name) {
+          fail("payload came before the stream name");
+        }
+        if (stream_name->find("@depth") == std::string_view::npos) {
+          return skip_value();
+        }
+        read_depth_update(update);
+        found = true;
+      } else {
+        skip_value();
+      }
+    });
+    return found;
+  }
+
+  // https://binance-docs.github.io/apidocs/spot/en/#order-book
+  void read_depth_snapshot(depth_snapshot_t &snapshot) {
+    bool has_update_id = false;
+    snapshot.bids.clear();
+    snapshot.asks.clear();
+
+    read_object([&](std::string_view const key) {
+      if (key == "lastUpdateId") {
+        snapshot.last_update_id = read_unsigned();
+        has_update_id = true;
+      } else if (key == "bids") {
+        read_levels(snapshot.bids);
+      } else if (key == "asks") {
+        read_levels(snapshot.asks);
+      } else {
+        skip_value();
+      }
+    });
+
+    if (!has_update_id) {
+      fail("snapshot is missing its lastUpdateId");
+    }
+  }
+};
+
+} // namespace
+
+void decode_mini_ticker_array(std::string_view const frame,
+                              symbol_registry_t &registry,
+                              std::vector<pushed_subscription_data_t> &result) {
+  frame_cursor_t cursor{frame, registry};
+  cursor.read_mini_ticker_array(result);
+}
+
+void decode_combined_stream_frame(
+    std::string_view const frame, symbol_registry_t &registry,
+    std::vector<pushed_subscription_data_t> &result) {
+  frame_cursor_t cursor{frame, registry};
+  cursor.read_combined_frame(result);
+}
+
+bool decode_depth_update(std::string_view const frame,
+                         symbol_registry_t &registry,
+                         depth_update_t &update) {
+  frame_cursor_t cursor{frame, registry};
+  return cursor.read_combined_depth_frame(update);
+}
+
+void decode_depth_snapshot(std::string_view const body,
+                           symbol_registry_t &registry,
+                           depth_snapshot_t &snapshot) {
+  frame_cursor_t cursor{body, registry};
+  cursor.read_depth_snapshot(snapshot);
+}
+
+std::string_view stream_type_to_string(stream_type_e const type) {
+  switch (type) {
+  case stream_type_e::mini_ticker:
+    return "miniTicker";
+  case stream_type_e::book_ticker:
+    return "bookTicker";
+  case stream_type_e::agg_trade:
+    return "aggTrade";
+  }
+  return {};
+}
+
+std::optional<stream_type_e> string_to_stream_type(std::string_view const str) {
+  if (str == "miniTicker") {
+    return stream_type_e::mini_ticker;
+  } else if (str == "bookTicker") {
+    return stream_type_e::book_ticker;
+  } else if (str == "aggTrade") {
+    return stream_type_e::agg_trade;
+  }
+  return std::nullopt;
+}
+
+std::string make_stream_name(std::string_view const symbol,
+                             std::string_view const stream) {
+  // stream names use lower-cased symbols
+  std::string name(symbol.size() + 1 + stream.size(), '@');
+  std::transform(symbol.cbegin(), symbol.cend(), name.begin(),
+                 [](char const ch) {
+                   return (ch >= 'A' && ch <= 'Z')
+                              ? static_cast<char>(ch - 'A' + 'a')
+                              : ch;
+                 });
+  std::copy(stream.cbegin(), stream.cend(), name.begin() + symbol.size() + 1);
+  return name;
+}
+
+} // namespace binance
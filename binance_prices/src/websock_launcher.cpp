@@ -1,29 +1,164 @@
 #include "websock_launcher.hpp"
 #include "market_data_stream.hpp"
 #include "request_handler.hpp"
-#include <boost/algorithm/string/case_conv.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 namespace binance {
 
-void launch_price_watcher(std::unique_ptr<market_data_stream_t> &websock,
-                          net::io_context &io_context,
-                          ssl::context &ssl_context) {
-  websock.reset(new market_data_stream_t(io_context, ssl_context));
-  websock->run();
+namespace {
+// the ticks background_price_saver applied, compared with the ticks its
+// container handed out by wait_for_price_saver
+std::atomic<std::uint64_t> applied_tick_count{};
+} // namespace
+
+void launch_price_watcher(
+    std::vector<std::unique_ptr<market_data_stream_t>> &websocks,
+    net::io_context &io_context, ssl::context &ssl_context,
+    std::size_t const redundancy) {
+  auto const feed_count = std::max<std::size_t>(redundancy, 1);
+  auto const restored = request_handler_t::get_state_snapshot().restored();
+  for (std::size_t feed_id = 0; feed_id != feed_count; ++feed_id) {
+    stream_options_t options{};
+    // the other copies register the symbols as their tickers come in
+    options.fetch_instruments = feed_id == 0 && !restored;
+    options.feed_id = feed_id;
+    options.arbitrate = redundancy > 1;
+    websocks.emplace_back(new market_data_stream_t(io_context, ssl_context,
+                                                   std::move(options)));
+    websocks.back()->run();
+  }
+  if (restored) {
+    // the listing is fetched and reconciled with the snapshot while the
+    // feeds connect
+    stream_options_t options{};
+    options.ws_path.clear();
+    options.fetch_instruments = true;
+    websocks.emplace_back(new market_data_stream_t(io_context, ssl_context,
+                                                   std::move(options)));
+    websocks.back()->run();
+  }
+}
+
+std::size_t replay_recorded_frames(frame_replayer_t const &replayer,
+                                   double const speed,
+                                   net::io_context &io_context,
+                                   ssl::context &ssl_context) {
+  std::vector<std::unique_ptr<market_data_stream_t>> streams{};
+
+  auto on_stream = [&](std::uint32_t const stream_id,
+                       std::string_view const ws_path) {
+    if (stream_id >= streams.size()) {
+      streams.resize(stream_id + 1);
+    }
+    stream_options_t options{};
+    options.ws_path = std::string(ws_path);
+    options.fetch_instruments = false;
+    options.shard_id = stream_id;
+    // the recording may hold several copies of the same feed
+    options.arbitrate = true;
+    streams[stream_id] = std::make_unique<market_data_stream_t>(
+        io_context, ssl_context, std::move(options));
+  };
+  auto on_frame = [&](std::uint32_t const stream_id,
+                      std::uint64_t const receive_time_ns,
+                      std::string_view const frame) {
+    if (stream_id < streams.size() && streams[stream_id]) {
+      streams[stream_id]->replay_frame(frame, receive_time_ns / 1'000'000);
+    }
+  };
+  return replayer.replay(speed, on_stream, on_frame);
 }
 
 void background_price_saver() {
   auto &token_container = request_handler_t::get_tokens_container();
-  auto &pushed_subs = request_handler_t::get_all_pushed_data();
+  auto &latest_ticks = request_handler_t::get_latest_ticks();
+  bool const conflating = request_handler_t::conflating_ticks();
+  auto &price_table = request_handler_t::get_price_table();
+  auto &symbols = request_handler_t::get_symbol_registry();
+  auto &kline_builder = request_handler_t::get_kline_builder();
+  auto &rolling_stats = request_handler_t::get_rolling_stats();
+  auto &cross_rates = request_handler_t::get_cross_rates();
+  auto &arbitrage_detector = request_handler_t::get_arbitrage_detector();
+  auto &price_history = request_handler_t::get_price_history();
+  auto &price_thresholds = request_handler_t::get_price_thresholds();
+  auto &pnl_engine = request_handler_t::get_pnl_engine();
+  auto &latency = request_handler_t::get_pipeline_latency();
+  auto &state_snapshot = request_handler_t::get_state_snapshot();
+  auto last_expiry_check = std::chrono::steady_clock::now();
+  // the highest exchange event time applied: the bars and the rolling
+  // windows expire on the market's clock, so a replayed recording ages them
+  // as they aged live and the local clock's skew never misfiles a tick
+  std::uint64_t market_time_ms{};
+
+  // a whole frame is drained at once
+  std::size_t const max_batch_size = 4'096;
+  std::vector<pushed_subscription_data_t> items{};
+  items.reserve(max_batch_size);
+
+  while (true) {
+    items.clear();
+    if (conflating) {
+      latest_ticks.drain_up_to(items, max_batch_size);
+    } else {
+      token_container.drain_up_to(items, max_batch_size);
+    }
+    for (auto const &item : items) {
+      price_table.update(item);
+      market_time_ms = std::max(market_time_ms, item.event_time);
+      if (item.enqueued_at_ns != 0) {
+        auto const applied_at_ns = steady_clock_ns();
+        latency.record(latency_stage_e::enqueued_to_applied,
+                       item.enqueued_at_ns, applied_at_ns);
+        latency.record(latency_stage_e::receive_to_applied,
+                       item.received_at_ns, applied_at_ns);
+      }
+      kline_builder.on_tick(item);
+      rolling_stats.on_tick(item);
+      cross_rates.on_tick(item);
+      arbitrage_detector.on_tick(item);
+      price_history.on_tick(item);
+      price_thresholds.on_tick(item);
+      pnl_engine.on_tick(item);
+      spdlog::info("{}: ${} (24h: ${})", symbols.name(item.symbol_id),
+                   item.current_price, item.open_24h);
+    }
+    // after the batch, so a live tick of the batch wins over the REST price
+    state_snapshot.apply_reconciled_prices();
+
+    // quiet symbols get their bars closed, and their rolling windows
+    // emptied, at most once a second. The arbitrage cycles are enumerated
+    // again then if symbols were listed since
+    auto const now = std::chrono::steady_clock::now();
+    if (now - last_expiry_check >= std::chrono::seconds(1)) {
+      last_expiry_check = now;
+      kline_builder.close_expired_bars(market_time_ms);
+      rolling_stats.expire(market_time_ms);
+      arbitrage_detector.load_symbols();
+    }
+    applied_tick_count.fetch_add(items.size(), std::memory_order_release);
+  }
+}
 
+void wait_for_price_saver() {
+  auto const &token_container = request_handler_t::get_tokens_container();
+  auto const &latest_ticks = request_handler_t::get_latest_ticks();
+  bool const conflating = request_handler_t::conflating_ticks();
   while (true) {
-    auto item = token_container.get();
-    boost::to_upper(item.instrument_id);
-    auto &data = pushed_subs[item.instrument_id];
-    data.current_price = item.current_price;
-    data.open_24h = item.open_24h;
-    spdlog::info("{}: ${} (24h: ${})", item.instrument_id, item.current_price,
-                 item.open_24h);
+    auto const waiting =
+        conflating ? latest_ticks.size() : token_container.size();
+    // the drained count is bumped before the size drops
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint64_t const drained = conflating ? latest_ticks.drained_count()
+                                             : token_container.drained_count();
+    if (waiting == 0 &&
+        applied_tick_count.load(std::memory_order_acquire) == drained) {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
   }
 }
 
@@ -0,0 +1,54 @@
+#include "containers.hpp"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#elif defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#endif
+
+namespace binance {
+namespace detail {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "futexes need a plain 32-bit word");
+
+void wait_on_address(std::atomic<std::uint32_t> &address,
+                     std::uint32_t const expected) noexcept {
+#if defined(_WIN32)
+  auto compare = expected;
+  WaitOnAddress(&address, &compare, sizeof(compare), INFINITE);
+#elif defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&address),
+          FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+  if (address.load(std::memory_order_relaxed) == expected) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+#endif
+}
+
+void wake_all_on_address(std::atomic<std::uint32_t> &address) noexcept {
+#if defined(_WIN32)
+  WakeByAddressAll(&address);
+#elif defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&address),
+          FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+  (void)address;
+#endif
+}
+
+} // namespace detail
+} // namespace binance
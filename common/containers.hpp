@@ -1,11 +1,23 @@
 #pragma once
 
+#include "seqlock.hpp"
+
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
+#include <iterator>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace binance {
 
 template <typename T> struct locked_set_t {
@@ -74,6 +86,11 @@ public:
     return value;
   }
 
+  std::size_t size() {
+    std::lock_guard<std::mutex> lock_{mutex_};
+    return container_.size();
+  }
+
   template <typename U> void append(U &&data) {
     std::lock_guard<std::mutex> lock_{mutex_};
     container_.push_back(std::forward<U>(data));
@@ -96,4 +113,508 @@ public:
   }
 };
 
+namespace detail {
+
+// keeps the producer and consumer indices of a ring on separate cache lines
+constexpr std::size_t cache_line_size = 64;
+
+// blocks while `address` still holds `expected`; may return spuriously
+void wait_on_address(std::atomic<std::uint32_t> &address,
+                     std::uint32_t const expected) noexcept;
+void wake_all_on_address(std::atomic<std::uint32_t> &address) noexcept;
+
+inline unsigned count_trailing_zeros(std::uint64_t const value) {
+#if defined(_MSC_VER)
+  unsigned long index{};
+  _BitScanForward64(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+inline unsigned count_leading_zeros(std::uint64_t const value) {
+#if defined(_MSC_VER)
+  unsigned long index{};
+  _BitScanReverse64(&index, value);
+  return 63 - static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+inline std::size_t round_up_to_power_of_two(std::size_t const value) {
+  std::size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+} // namespace detail
+
+/* Parks the consumer of a ring buffer: it first spins, then yields, and only
+ * then sleeps on a futex (WaitOnAddress on Windows). Producers only pay for
+ * a syscall when the consumer is actually asleep.
+ */
+class adaptive_waiter_t {
+  std::atomic<std::uint32_t> epoch_{};
+  std::atomic<std::uint32_t> sleepers_{};
+
+public:
+  static constexpr int spin_count = 1'024;
+  static constexpr int yield_count = 64;
+
+  template <typename Predicate> void wait(Predicate &&ready) {
+    // spinning on a single core only delays the thread we're waiting for
+    static int const spin_limit =
+        std::thread::hardware_concurrency() > 1 ? spin_count : 0;
+    for (int i = 0; i != spin_limit; ++i) {
+      if (ready()) {
+        return;
+      }
+      cpu_relax();
+    }
+    for (int i = 0; i != yield_count; ++i) {
+      if (ready()) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+    while (true) {
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      // pairs with the fence in notify(): either we see the new items or the
+      // producer sees us asleep
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto const epoch = epoch_.load(std::memory_order_relaxed);
+      if (!ready()) {
+        detail::wait_on_address(epoch_, epoch);
+      }
+      sleepers_.fetch_sub(1, std::memory_order_relaxed);
+      if (ready()) {
+        return;
+      }
+    }
+  }
+
+  // called by producers after they published new items
+  void notify() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) != 0) {
+      epoch_.fetch_add(1, std::memory_order_relaxed);
+      detail::wake_all_on_address(epoch_);
+    }
+  }
+};
+
+/* A bounded single-producer/single-consumer ring buffer. Items are pushed and
+ * drained in batches so that a whole miniTicker frame costs one release
+ * store on each side instead of a mutex round-trip per ticker. When the ring
+ * is full, the producer yields until the consumer catches up.
+ */
+template <typename T> class spsc_ring_t {
+  std::size_t const capacity_;
+  std::size_t const mask_;
+  std::unique_ptr<T[]> slots_;
+
+  alignas(detail::cache_line_size) std::atomic<std::size_t> head_{};
+  std::size_t cached_tail_{}; // consumer's last view of tail_
+  alignas(detail::cache_line_size) std::atomic<std::size_t> tail_{};
+  std::size_t cached_head_{}; // producer's last view of head_
+  alignas(detail::cache_line_size) adaptive_waiter_t waiter_{};
+
+  template <typename InputIt>
+  std::size_t push_some(InputIt &first, std::size_t const count) {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    if (capacity_ - (tail - cached_head_) < count) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    auto const n = std::min(capacity_ - (tail - cached_head_), count);
+    for (std::size_t i = 0; i != n; ++i, ++first) {
+      slots_[(tail + i) & mask_] = *first;
+    }
+    if (n != 0) {
+      tail_.store(tail + n, std::memory_order_release);
+      waiter_.notify();
+    }
+    return n;
+  }
+
+  bool has_items() {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (cached_tail_ == head) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    return cached_tail_ != head;
+  }
+
+public:
+  explicit spsc_ring_t(std::size_t const capacity)
+      : capacity_{detail::round_up_to_power_of_two(capacity)},
+        mask_{capacity_ - 1}, slots_{std::make_unique<T[]>(capacity_)} {}
+  spsc_ring_t(spsc_ring_t const &) = delete;
+  spsc_ring_t &operator=(spsc_ring_t const &) = delete;
+
+  std::size_t capacity() const { return capacity_; }
+  // the number of items waiting, for monitoring: it may be stale as soon as
+  // it is returned
+  std::size_t size() const {
+    auto const head = head_.load(std::memory_order_relaxed);
+    return tail_.load(std::memory_order_relaxed) - head;
+  }
+
+  // producer side, returns how many of the `count` items were pushed
+  template <typename InputIt>
+  std::size_t try_push_n(InputIt first, std::size_t const count) {
+    return push_some(first, count);
+  }
+
+  template <typename InputIt> void push_n(InputIt first, std::size_t count) {
+    while (true) {
+      count -= push_some(first, count);
+      if (count == 0) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  template <typename U> void append(U &&item) {
+    push_n(std::make_move_iterator(&item), 1);
+  }
+
+  template <typename NewContainer> void append_list(NewContainer &&new_list) {
+    push_n(std::make_move_iterator(std::begin(new_list)),
+           static_cast<std::size_t>(std::size(new_list)));
+  }
+
+  // consumer side, appends at most `max_items` to `out` without blocking
+  std::size_t try_drain_up_to(std::vector<T> &out,
+                              std::size_t const max_items) {
+    if (!has_items()) {
+      return 0;
+    }
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const n = std::min(cached_tail_ - head, max_items);
+    for (std::size_t i = 0; i != n; ++i) {
+      out.push_back(std::move(slots_[(head + i) & mask_]));
+    }
+    head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // blocks until there is at least one item
+  std::size_t drain_up_to(std::vector<T> &out, std::size_t const max_items) {
+    waiter_.wait([this] { return has_items(); });
+    return try_drain_up_to(out, max_items);
+  }
+
+  T get() {
+    waiter_.wait([this] { return has_items(); });
+    auto const head = head_.load(std::memory_order_relaxed);
+    T value{std::move(slots_[head & mask_])};
+    head_.store(head + 1, std::memory_order_release);
+    return value;
+  }
+};
+
+/* A bounded multi-producer/single-consumer ring buffer. Producers claim a
+ * contiguous range of slots with a single CAS and mark each slot as ready
+ * through its sequence number, so the consumer drains items in the order
+ * they were claimed without any lock.
+ */
+template <typename T> class mpsc_ring_t {
+  struct slot_t {
+    // holds `position + 1` once the item claimed at `position` is readable
+    std::atomic<std::size_t> sequence{};
+    T value{};
+  };
+
+  std::size_t const capacity_;
+  std::size_t const mask_;
+  std::unique_ptr<slot_t[]> slots_;
+
+  alignas(detail::cache_line_size) std::atomic<std::size_t> head_{};
+  alignas(detail::cache_line_size) std::atomic<std::size_t> tail_{};
+  alignas(detail::cache_line_size) adaptive_waiter_t waiter_{};
+
+  template <typename InputIt>
+  std::size_t push_some(InputIt &first, std::size_t const count) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    std::size_t n{};
+    do {
+      auto const head = head_.load(std::memory_order_acquire);
+      n = std::min(capacity_ - (tail - head), count);
+      if (n == 0) {
+        return 0;
+      }
+    } while (!tail_.compare_exchange_weak(tail, tail + n,
+                                          std::memory_order_relaxed));
+
+    for (std::size_t i = 0; i != n; ++i, ++first) {
+      auto &slot = slots_[(tail + i) & mask_];
+      slot.value = *first;
+      slot.sequence.store(tail + i + 1, std::memory_order_release);
+    }
+    waiter_.notify();
+    return n;
+  }
+
+  bool has_items() const {
+    auto const head = head_.load(std::memory_order_relaxed);
+    return slots_[head & mask_].sequence.load(std::memory_order_acquire) ==
+           head + 1;
+  }
+
+public:
+  explicit mpsc_ring_t(std::size_t const capacity)
+      : capacity_{detail::round_up_to_power_of_two(capacity)},
+        mask_{capacity_ - 1}, slots_{std::make_unique<slot_t[]>(capacity_)} {}
+  mpsc_ring_t(mpsc_ring_t const &) = delete;
+  mpsc_ring_t &operator=(mpsc_ring_t const &) = delete;
+
+  std::size_t capacity() const { return capacity_; }
+  // the items the consumer took so far
+  std::size_t drained_count() const {
+    return head_.load(std::memory_order_acquire);
+  }
+  // the number of items waiting, for monitoring: it may be stale as soon as
+  // it is returned
+  std::size_t size() const {
+    auto const head = head_.load(std::memory_order_relaxed);
+    return tail_.load(std::memory_order_relaxed) - head;
+  }
+
+  // producer side, returns how many of the `count` items were pushed
+  template <typename InputIt>
+  std::size_t try_push_n(InputIt first, std::size_t const count) {
+    return push_some(first, count);
+  }
+
+  template <typename InputIt> void push_n(InputIt first, std::size_t count) {
+    while (true) {
+      count -= push_some(first, count);
+      if (count == 0) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  template <typename U> void append(U &&item) {
+    push_n(std::make_move_iterator(&item), 1);
+  }
+
+  template <typename NewContainer> void append_list(NewContainer &&new_list) {
+    push_n(std::make_move_iterator(std::begin(new_list)),
+           static_cast<std::size_t>(std::size(new_list)));
+  }
+
+  // consumer side, appends at most `max_items` to `out` without blocking
+  std::size_t try_drain_up_to(std::vector<T> &out,
+                              std::size_t const max_items) {
+    auto const head = head_.load(std::memory_order_relaxed);
+    std::size_t n = 0;
+    for (; n != max_items; ++n) {
+      auto &slot = slots_[(head + n) & mask_];
+      if (slot.sequence.load(std::memory_order_acquire) != head + n + 1) {
+        break;
+      }
+      out.push_back(std::move(slot.value));
+    }
+    if (n != 0) {
+      head_.store(head + n, std::memory_order_release);
+    }
+    return n;
+  }
+
+  // blocks until there is at least one item
+  std::size_t drain_up_to(std::vector<T> &out, std::size_t const max_items) {
+    waiter_.wait([this] { return has_items(); });
+    return try_drain_up_to(out, max_items);
+  }
+
+  T get() {
+    waiter_.wait([this] { return has_items(); });
+    auto const head = head_.load(std::memory_order_relaxed);
+    T value{std::move(slots_[head & mask_].value)};
+    head_.store(head + 1, std::memory_order_release);
+    return value;
+  }
+};
+
+/* A bounded multi-producer/single-consumer container that only keeps the
+ * latest value per key. `Traits` maps an item to its slot with
+ * `static std::size_t key(T const &)`, every key below `capacity`, and
+ * folds a newer item into a still pending one with
+ * `static void merge(T &pending, T &&newer)`.
+ *
+ * Producers overwrite (merge into) the pending slot under a per-slot
+ * spinlock, which only two producers writing the same key at the same time
+ * contend on, and mark it in a dirty bitset. The consumer drains the slots
+ * whose bit is set, in key order. However far the consumer falls behind,
+ * it holds at most `capacity` items and what it drains is never older than
+ * the latest push of a key.
+ */
+template <typename T, typename Traits> class conflating_container_t {
+  struct slot_t {
+    std::atomic_flag locked = ATOMIC_FLAG_INIT;
+    bool pending{};
+    T value{};
+  };
+  static constexpr std::size_t bits_per_word = 64;
+
+  std::size_t const capacity_;
+  std::size_t const word_count_;
+  std::unique_ptr<slot_t[]> slots_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> dirty_;
+  std::size_t next_word_{}; // consumer only, where the last drain stopped
+
+  alignas(detail::cache_line_size) std::atomic<std::size_t> pending_count_{};
+  std::atomic<std::uint64_t> conflated_count_{};
+  std::atomic<std::uint64_t> dropped_count_{};
+  std::atomic<std::uint64_t> drained_count_{};
+  alignas(detail::cache_line_size) adaptive_waiter_t waiter_{};
+
+  void lock(slot_t &slot) {
+    while (slot.locked.test_and_set(std::memory_order_acquire)) {
+      cpu_relax();
+    }
+  }
+  void unlock(slot_t &slot) { slot.locked.clear(std::memory_order_release); }
+
+  // returns false if the item was merged into a pending one or dropped
+  template <typename U> bool put(U &&item) {
+    auto const key = Traits::key(item);
+    if (key >= capacity_) {
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    auto &slot = slots_[key];
+    lock(slot);
+    bool const was_pending = slot.pending;
+    if (was_pending) {
+      Traits::merge(slot.value, std::forward<U>(item));
+    } else {
+      slot.value = std::forward<U>(item);
+      slot.pending = true;
+      // both done while still holding the lock: the consumer clears a bit
+      // before it takes a slot, so a pending slot always has its bit set,
+      // and it is counted before the consumer can take it
+      pending_count_.fetch_add(1, std::memory_order_release);
+      dirty_[key / bits_per_word].fetch_or(
+          std::uint64_t(1) << (key % bits_per_word),
+          std::memory_order_release);
+    }
+    unlock(slot);
+    if (was_pending) {
+      conflated_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  bool has_items() const {
+    return pending_count_.load(std::memory_order_acquire) != 0;
+  }
+
+public:
+  explicit conflating_container_t(std::size_t const capacity)
+      : capacity_{capacity},
+        word_count_{(capacity + bits_per_word - 1) / bits_per_word},
+        slots_{std::make_unique<slot_t[]>(capacity_)},
+        dirty_{std::make_unique<std::atomic<std::uint64_t>[]>(word_count_)} {
+    for (std::size_t i = 0; i != word_count_; ++i) {
+      dirty_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+  conflating_container_t(conflating_container_t const &) = delete;
+  conflating_container_t &operator=(conflating_container_t const &) = delete;
+
+  std::size_t capacity() const { return capacity_; }
+  // the number of keys waiting, for monitoring: it may be stale as soon as
+  // it is returned
+  std::size_t size() const {
+    return pending_count_.load(std::memory_order_relaxed);
+  }
+  // items folded into a pending one instead of being queued
+  std::uint64_t conflated_count() const {
+    return conflated_count_.load(std::memory_order_relaxed);
+  }
+  // items whose key was out of range
+  std::uint64_t dropped_count() const {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
+  // the items the consumer took so far, counted before size() drops
+  std::uint64_t drained_count() const {
+    return drained_count_.load(std::memory_order_acquire);
+  }
+
+  // producer side, any thread. Never blocks on the consumer
+  template <typename U> void append(U &&item) {
+    if (put(std::forward<U>(item))) {
+      waiter_.notify();
+    }
+  }
+
+  template <typename NewContainer> void append_list(NewContainer &&new_list) {
+    bool added = false;
+    for (auto &item : new_list) {
+      added |= put(std::move(item));
+    }
+    if (added) {
+      waiter_.notify();
+    }
+  }
+
+  // consumer side, appends at most `max_items` to `out` without blocking
+  std::size_t try_drain_up_to(std::vector<T> &out,
+                              std::size_t const max_items) {
+    std::size_t n = 0;
+    for (std::size_t scanned = 0; scanned != word_count_ && n != max_items;
+         ++scanned) {
+      auto const word_index = next_word_;
+      auto &word = dirty_[word_index];
+      if (word.load(std::memory_order_relaxed) == 0) {
+        next_word_ = word_index + 1 == word_count_ ? 0 : word_index + 1;
+        continue;
+      }
+      auto bits = word.exchange(0, std::memory_order_acquire);
+      while (bits != 0 && n != max_items) {
+        auto const bit = detail::count_trailing_zeros(bits);
+        bits &= bits - 1;
+        auto &slot = slots_[word_index * bits_per_word + bit];
+        lock(slot);
+        if (slot.pending) {
+          out.push_back(std::move(slot.value));
+          slot.pending = false;
+          ++n;
+        }
+        unlock(slot);
+      }
+      if (bits != 0) {
+        // `max_items` was reached, the rest of the word goes next time
+        word.fetch_or(bits, std::memory_order_relaxed);
+      } else {
+        next_word_ = word_index + 1 == word_count_ ? 0 : word_index + 1;
+      }
+    }
+    if (n != 0) {
+      drained_count_.fetch_add(n, std::memory_order_relaxed);
+      pending_count_.fetch_sub(n, std::memory_order_release);
+    }
+    return n;
+  }
+
+  // blocks until there is at least one item
+  std::size_t drain_up_to(std::vector<T> &out, std::size_t const max_items) {
+    while (true) {
+      waiter_.wait([this] { return has_items(); });
+      if (auto const n = try_drain_up_to(out, max_items); n != 0) {
+        return n;
+      }
+    }
+  }
+};
+
 } // namespace binance
@@ -1,4 +1,5 @@
 #include "crypto.hpp"
+#include <cstring>
 #include <limits>
 #include <openssl/hmac.h>
 
@@ -97,5 +98,59 @@ std::basic_string<unsigned char> hmac256_encode(std::string const &data,
   return std::basic_string<unsigned char>(out, len);
 }
 
+std::string decode_url(boost::string_view const &encoded_string) {
+  auto hex_value = [](char const ch) -> int {
+    if ('0' <= ch && ch <= '9') {
+      return ch - '0';
+    } else if ('A' <= ch && ch <= 'F') {
+      return ch - 'A' + 10;
+    } else if ('a' <= ch && ch <= 'f') {
+      return ch - 'a' + 10;
+    }
+    return -1;
+  };
+
+  std::string src{};
+  src.reserve(encoded_string.size());
+  for (size_t i = 0; i < encoded_string.size();) {
+    char const ch = encoded_string[i];
+    // a '%' that isn't followed by two hex digits, e.g. at the end of the
+    // target, is kept as it is
+    if (ch == '%' && i + 2 < encoded_string.size()) {
+      auto const high = hex_value(encoded_string[i + 1]);
+      auto const low = hex_value(encoded_string[i + 2]);
+      if (high != -1 && low != -1) {
+        src.push_back(static_cast<char>(high * 16 + low));
+        i += 3;
+        continue;
+      }
+    }
+    src.push_back(ch);
+    ++i;
+  }
+
+  return src;
+}
+
+std::vector<boost::string_view> split_string_view(boost::string_view const &str,
+                                                  char const *delim) {
+  std::size_t const delim_length = std::strlen(delim);
+  std::size_t from_pos{};
+  std::size_t index{str.find(delim, from_pos)};
+  if (index == std::string::npos) {
+    return {str};
+  }
+  std::vector<boost::string_view> result{};
+  while (index != std::string::npos) {
+    result.emplace_back(str.data() + from_pos, index - from_pos);
+    from_pos = index + delim_length;
+    index = str.find(delim, from_pos);
+  }
+  if (from_pos < str.length()) {
+    result.emplace_back(str.data() + from_pos, str.size() - from_pos);
+  }
+  return result;
+}
+
 } // namespace utilities
 } // namespace binance
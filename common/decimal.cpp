@@ -0,0 +1,248 @@
+#include "decimal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace binance {
+
+namespace {
+
+constexpr std::uint64_t max_integral_part =
+    static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) /
+    decimal_t::units_per_one;
+
+inline bool is_digit(char const ch) {
+  return static_cast<unsigned char>(ch - '0') < 10;
+}
+
+#if defined(_MSC_VER) ||                                                      \
+    (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+// converts 8 ASCII digits to their value without a per-digit loop, see
+// https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+inline std::uint32_t parse_eight_digits(char const *digits) {
+  std::uint64_t value{};
+  std::memcpy(&value, digits, sizeof(value));
+  value -= 0x3030303030303030;
+  value = (value * 10) + (value >> 8);
+  value = (((value & 0x000000FF000000FF) * (100 + (1'000'000ULL << 32))) +
+           (((value >> 16) & 0x000000FF000000FF) * (1 + (10'000ULL << 32)))) >>
+          32;
+  return static_cast<std::uint32_t>(value);
+}
+#else
+inline std::uint32_t parse_eight_digits(char const *digits) {
+  std::uint32_t value{};
+  for (int i = 0; i != 8; ++i) {
+    value = value * 10 + static_cast<std::uint32_t>(digits[i] - '0');
+  }
+  return value;
+}
+#endif
+
+// `count` must not be more than 8
+inline std::uint32_t parse_short_digits(char const *digits,
+                                        std::size_t const count,
+                                        bool const pad_right) {
+  char padded[8] = {'0', '0', '0', '0', '0', '0', '0', '0'};
+  std::memcpy(pad_right ? padded : padded + (8 - count), digits, count);
+  return parse_eight_digits(padded);
+}
+
+char const two_digits_table[] = "00010203040506070809"
+                                "10111213141516171819"
+                                "20212223242526272829"
+                                "30313233343536373839"
+                                "40414243444546474849"
+                                "50515253545556575859"
+                                "60616263646566676869"
+                                "70717273747576777879"
+                                "80818283848586878889"
+                                "90919293949596979899";
+
+// writes exactly 8 digits, zero padded on the left
+inline void write_eight_digits(char *out, std::uint32_t value) {
+  for (int i = 6; i >= 0; i -= 2) {
+    std::memcpy(out + i, two_digits_table + (value % 100) * 2, 2);
+    value /= 100;
+  }
+}
+
+// writes `integral.fraction` with the fraction's trailing zeros trimmed
+std::to_chars_result write_decimal(char *first, char *last,
+                                   bool const is_negative,
+                                   std::uint64_t const integral,
+                                   std::uint32_t const fraction) noexcept {
+  if (is_negative) {
+    if (first == last) {
+      return {last, std::errc::value_too_large};
+    }
+    *first++ = '-';
+  }
+  auto result = std::to_chars(first, last, integral);
+  if (result.ec != std::errc{} || fraction == 0) {
+    return result;
+  }
+
+  char digits[decimal_t::scale];
+  write_eight_digits(digits, fraction);
+  std::size_t digit_count = decimal_t::scale;
+  while (digits[digit_count - 1] == '0') {
+    --digit_count;
+  }
+  if (static_cast<std::size_t>(last - result.ptr) < digit_count + 1) {
+    return {last, std::errc::value_too_large};
+  }
+  *result.ptr++ = '.';
+  std::memcpy(result.ptr, digits, digit_count);
+  return {result.ptr + digit_count, std::errc{}};
+}
+
+} // namespace
+
+decimal_t decimal_t::from_double(double const value) {
+  return decimal_t{static_cast<std::int64_t>(
+      std::llround(value * static_cast<double>(units_per_one)))};
+}
+
+decimal_t operator*(decimal_t const a, decimal_t const b) {
+#if defined(__SIZEOF_INT128__)
+  __int128 const product = static_cast<__int128>(a.units_) * b.units_;
+  __int128 const half = decimal_t::units_per_one / 2;
+  __int128 const rounded = product >= 0 ? product + half : product - half;
+  return decimal_t{
+      static_cast<std::int64_t>(rounded / decimal_t::units_per_one)};
+#else
+  long double const product = static_cast<long double>(a.units_) *
+                              static_cast<long double>(b.units_) /
+                              decimal_t::units_per_one;
+  return decimal_t{static_cast<std::int64_t>(std::llround(product))};
+#endif
+}
+
+std::from_chars_result from_chars(char const *first, char const *last,
+                                  decimal_t &value) noexcept {
+  char const *current = first;
+  bool const is_negative = current != last && *current == '-';
+  current += is_negative;
+
+  // leading zeros don't count towards the integral digit limit
+  char const *const integral_begin = current;
+  while (current != last && *current == '0') {
+    ++current;
+  }
+  char const *const significant_begin = current;
+  while (current != last && is_digit(*current)) {
+    ++current;
+  }
+  std::size_t const significant_count = current - significant_begin;
+  bool const has_integral = current != integral_begin;
+
+  char const *fraction_begin = current;
+  std::size_t fraction_count{};
+  if (current != last && *current == '.') {
+    fraction_begin = ++current;
+    while (current != last && is_digit(*current)) {
+      ++current;
+    }
+    fraction_count = current - fraction_begin;
+  }
+
+  if (!has_integral && fraction_count == 0) {
+    return {first, std::errc::invalid_argument};
+  }
+  // 11 digits is the most the integral part of an int64 of 1e-8 units holds
+  if (significant_count > 11) {
+    return {current, std::errc::result_out_of_range};
+  }
+  for (std::size_t i = decimal_t::scale; i < fraction_count; ++i) {
+    if (fraction_begin[i] != '0') {
+      return {current, std::errc::result_out_of_range};
+    }
+  }
+
+  std::uint64_t integral{};
+  if (significant_count > 8) {
+    std::size_t const high_count = significant_count - 8;
+    integral = parse_short_digits(significant_begin, high_count, false) *
+                   std::uint64_t(100'000'000) +
+               parse_eight_digits(significant_begin + high_count);
+  } else if (significant_count != 0) {
+    integral = parse_short_digits(significant_begin, significant_count, false);
+  }
+  std::uint32_t const fraction =
+      fraction_count == 0
+          ? 0
+          : parse_short_digits(
+                fraction_begin,
+                std::min<std::size_t>(fraction_count, decimal_t::scale), true);
+
+  if (integral > max_integral_part) {
+    return {current, std::errc::result_out_of_range};
+  }
+  std::uint64_t const units =
+      integral * decimal_t::units_per_one + std::uint64_t(fraction);
+  if (units > static_cast<std::uint64_t>(
+                  std::numeric_limits<std::int64_t>::max())) {
+    return {current, std::errc::result_out_of_range};
+  }
+  auto const signed_units = static_cast<std::int64_t>(units);
+  value = decimal_t::from_units(is_negative ? -signed_units : signed_units);
+  return {current, std::errc{}};
+}
+
+std::to_chars_result to_chars(char *first, char *last,
+                              decimal_t const value) noexcept {
+  std::int64_t const units = value.units();
+  // avoids overflowing on negation of the minimum value
+  std::uint64_t const magnitude =
+      units < 0 ? std::uint64_t(0) - static_cast<std::uint64_t>(units)
+                : static_cast<std::uint64_t>(units);
+  return write_decimal(
+      first, last, units < 0, magnitude / decimal_t::units_per_one,
+      static_cast<std::uint32_t>(magnitude % decimal_t::units_per_one));
+}
+
+std::string to_string(decimal_t const value) {
+  char buffer[decimal_t::max_chars];
+  auto const result = to_chars(buffer, buffer + sizeof(buffer), value);
+  return std::string(buffer, result.ptr);
+}
+
+std::to_chars_result to_chars(char *first, char *last,
+                              decimal_sum_t const value) noexcept {
+  auto const integral = value.integral();
+  auto const units = static_cast<std::uint32_t>(value.units());
+  if (integral >= 0) {
+    return write_decimal(first, last, false,
+                         static_cast<std::uint64_t>(integral), units);
+  }
+  // -(i + u) is -(i + 1) + (1 - u), written without negating the minimum
+  std::uint64_t const magnitude =
+      std::uint64_t(0) - static_cast<std::uint64_t>(integral + 1);
+  if (units == 0) {
+    return write_decimal(first, last, true, magnitude + 1, 0);
+  }
+  return write_decimal(
+      first, last, true, magnitude,
+      static_cast<std::uint32_t>(decimal_t::units_per_one - units));
+}
+
+namespace utilities {
+
+decimal_t to_decimal(std::string_view const str) {
+  decimal_t value{};
+  auto const last = str.data() + str.size();
+  auto const [ptr, ec] = from_chars(str.data(), last, value);
+  if (ec != std::errc{} || ptr != last) {
+    throw std::invalid_argument("'" + std::string(str) +
+                                "' is not a valid decimal");
+  }
+  return value;
+}
+
+} // namespace utilities
+
+} // namespace binance
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <spdlog/fmt/fmt.h>
+#include <string>
+#include <string_view>
+
+namespace binance {
+
+/* An exact fixed-point decimal with 8 fractional digits, which is the most
+ * precision Binance uses for prices, quantities and balances. Values are
+ * stored as a signed count of 1e-8 units, so the representable range is
+ * roughly +/-92 billion.
+ */
+class decimal_t {
+  std::int64_t units_{};
+
+  constexpr explicit decimal_t(std::int64_t const units) : units_{units} {}
+
+public:
+  static constexpr int scale = 8;
+  static constexpr std::int64_t units_per_one = 100'000'000;
+  // enough for "-92233720368.54775808"
+  static constexpr std::size_t max_chars = 24;
+
+  constexpr decimal_t() = default;
+
+  static constexpr decimal_t from_units(std::int64_t const units) {
+    return decimal_t{units};
+  }
+  static decimal_t from_double(double const value);
+
+  constexpr std::int64_t units() const { return units_; }
+  constexpr bool is_zero() const { return units_ == 0; }
+  double to_double() const {
+    return static_cast<double>(units_) / static_cast<double>(units_per_one);
+  }
+
+  constexpr decimal_t operator-() const { return decimal_t{-units_}; }
+  constexpr decimal_t &operator+=(decimal_t const other) {
+    units_ += other.units_;
+    return *this;
+  }
+  constexpr decimal_t &operator-=(decimal_t const other) {
+    units_ -= other.units_;
+    return *this;
+  }
+
+  friend constexpr decimal_t operator+(decimal_t a, decimal_t const b) {
+    return a += b;
+  }
+  friend constexpr decimal_t operator-(decimal_t a, decimal_t const b) {
+    return a -= b;
+  }
+  // rounds half away from zero to the nearest 1e-8
+  friend decimal_t operator*(decimal_t const a, decimal_t const b);
+
+  friend constexpr bool operator==(decimal_t const a, decimal_t const b) {
+    return a.units_ == b.units_;
+  }
+  friend constexpr bool operator!=(decimal_t const a, decimal_t const b) {
+    return a.units_ != b.units_;
+  }
+  friend constexpr bool operator<(decimal_t const a, decimal_t const b) {
+    return a.units_ < b.units_;
+  }
+  friend constexpr bool operator<=(decimal_t const a, decimal_t const b) {
+    return a.units_ <= b.units_;
+  }
+  friend constexpr bool operator>(decimal_t const a, decimal_t const b) {
+    return a.units_ > b.units_;
+  }
+  friend constexpr bool operator>=(decimal_t const a, decimal_t const b) {
+    return a.units_ >= b.units_;
+  }
+};
+
+/* A running sum of decimals that may leave decimal_t's range, e.g. the
+ * traded volume of a candle: an hour of a high-supply pair such as
+ * PEPEUSDT trades far more than 92 billion units. The integral part and the
+ * 1e-8 units are kept apart, so the sum stays exact up to roughly +/-9.2e18.
+ */
+class decimal_sum_t {
+  std::int64_t integral_{};
+  std::int64_t units_{}; // always in [0, decimal_t::units_per_one)
+
+  // `units_` is at most one unit of one away from its range
+  constexpr void normalize() {
+    if (units_ >= decimal_t::units_per_one) {
+      units_ -= decimal_t::units_per_one;
+      ++integral_;
+    } else if (units_ < 0) {
+      units_ += decimal_t::units_per_one;
+      --integral_;
+    }
+  }
+
+public:
+  // enough for "-9223372036854775808.99999999"
+  static constexpr std::size_t max_chars = 32;
+
+  constexpr decimal_sum_t() = default;
+
+  constexpr std::int64_t integral() const { return integral_; }
+  constexpr std::int64_t units() const { return units_; }
+  constexpr bool is_zero() const { return integral_ == 0 && units_ == 0; }
+  double to_double() const {
+    return static_cast<double>(integral_) +
+           static_cast<double>(units_) /
+               static_cast<double>(decimal_t::units_per_one);
+  }
+
+  constexpr decimal_sum_t &operator+=(decimal_t const value) {
+    integral_ += value.units() / decimal_t::units_per_one;
+    units_ += value.units() % decimal_t::units_per_one;
+    normalize();
+    return *this;
+  }
+  constexpr decimal_sum_t &operator+=(decimal_sum_t const other) {
+    integral_ += other.integral_;
+    units_ += other.units_;
+    normalize();
+    return *this;
+  }
+  constexpr decimal_sum_t &operator-=(decimal_sum_t const other) {
+    integral_ -= other.integral_;
+    units_ -= other.units_;
+    normalize();
+    return *this;
+  }
+
+  friend constexpr bool operator==(decimal_sum_t const a,
+                                   decimal_sum_t const b) {
+    return a.integral_ == b.integral_ && a.units_ == b.units_;
+  }
+  friend constexpr bool operator!=(decimal_sum_t const a,
+                                   decimal_sum_t const b) {
+    return !(a == b);
+  }
+};
+
+/* Parses `[-]digits[.digits]` without going through the C locale. Digits past
+ * the 8th fractional one must be zeros, anything else cannot be represented
+ * exactly and is reported as std::errc::result_out_of_range. On error `value`
+ * is left untouched, just like std::from_chars.
+ */
+std::from_chars_result from_chars(char const *first, char const *last,
+                                  decimal_t &value) noexcept;
+
+// writes the shortest exact representation, e.g. "0.001" or "65000"
+std::to_chars_result to_chars(char *first, char *last,
+                              decimal_t const value) noexcept;
+
+std::string to_string(decimal_t const value);
+
+std::to_chars_result to_chars(char *first, char *last,
+                              decimal_sum_t const value) noexcept;
+
+namespace utilities {
+// throws std::invalid_argument if `str` is not entirely a valid decimal
+decimal_t to_decimal(std::string_view const str);
+} // namespace utilities
+
+} // namespace binance
+
+template <> struct fmt::formatter<binance::decimal_t> : formatter<string_view> {
+  template <typename FormatContext>
+  auto format(binance::decimal_t const value, FormatContext &ctx) {
+    char buffer[binance::decimal_t::max_chars];
+    auto const result =
+        binance::to_chars(buffer, buffer + sizeof(buffer), value);
+    return formatter<string_view>::format(
+        string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)),
+        ctx);
+  }
+};
+
+template <>
+struct fmt::formatter<binance::decimal_sum_t> : formatter<string_view> {
+  template <typename FormatContext>
+  auto format(binance::decimal_sum_t const value, FormatContext &ctx) {
+    char buffer[binance::decimal_sum_t::max_chars];
+    auto const result =
+        binance::to_chars(buffer, buffer + sizeof(buffer), value);
+    return formatter<string_view>::format(
+        string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)),
+        ctx);
+  }
+};
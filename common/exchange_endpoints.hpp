@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+namespace binance {
+
+/* Where the services reach Binance. The defaults are the production hosts;
+ * the command line can point them somewhere else, e.g. at the local mock
+ * exchange for load tests.
+ */
+struct exchange_endpoints_t {
+  std::string rest_api_host{"api.binance.com"};
+  std::string rest_api_port{"443"};
+  std::string ws_host{"stream.binance.com"};
+  std::string ws_port{"9443"};
+};
+
+// process-wide. Only main() may modify it, before any stream is created;
+// every stream copies it when it is constructed.
+inline exchange_endpoints_t &exchange_endpoints() {
+  static exchange_endpoints_t endpoints{};
+  return endpoints;
+}
+
+} // namespace binance
@@ -0,0 +1,265 @@
+#include "frame_log.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+namespace binance {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char const *segment_extension = ".frames";
+
+std::size_t padded_size(std::size_t const length) {
+  return (length + 7) & ~std::size_t(7);
+}
+
+std::uint64_t nanoseconds_since_epoch() {
+  using namespace std::chrono;
+  return static_cast<std::uint64_t>(
+      duration_cast<nanoseconds>(system_clock::now().time_since_epoch())
+          .count());
+}
+
+// the index of `<prefix>-NNNNNN.frames`, or -1 for any other file
+long long segment_index(fs::path const &path, std::string const &prefix) {
+  auto const filename = path.filename().string();
+  if (path.extension() != segment_extension ||
+      filename.size() <= prefix.size() + 1 ||
+      filename.compare(0, prefix.size(), prefix) != 0 ||
+      filename[prefix.size()] != '-') {
+    return -1;
+  }
+  auto const digits = filename.substr(
+      prefix.size() + 1,
+      filename.size() - prefix.size() - 1 - std::strlen(segment_extension));
+  if (digits.empty() ||
+      !std::all_of(digits.cbegin(), digits.cend(),
+                   [](char const c) { return c >= '0' && c <= '9'; })) {
+    return -1;
+  }
+  return std::stoll(digits);
+}
+
+std::vector<std::pair<long long, std::string>>
+list_segments(std::string const &directory, std::string const &prefix) {
+  std::vector<std::pair<long long, std::string>> segments{};
+  std::error_code ec{};
+  for (auto const &entry : fs::directory_iterator(directory, ec)) {
+    if (auto const index = segment_index(entry.path(), prefix); index >= 0) {
+      segments.emplace_back(index, entry.path().string());
+    }
+  }
+  std::sort(segments.begin(), segments.end());
+  return segments;
+}
+
+} // namespace
+
+frame_recorder_t::frame_recorder_t(std::string directory, std::string prefix,
+                                   std::size_t const max_segment_size)
+    : directory_{std::move(directory)}, prefix_{std::move(prefix)},
+      max_segment_size_{max_segment_size} {}
+
+frame_recorder_t::~frame_recorder_t() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+
+bool frame_recorder_t::open() {
+  std::lock_guard<std::mutex> lock_g{mutex_};
+  std::error_code ec{};
+  fs::create_directories(directory_, ec);
+  if (auto const segments = list_segments(directory_, prefix_);
+      !segments.empty()) {
+    segment_index_ = static_cast<std::size_t>(segments.back().first) + 1;
+  }
+  return open_next_segment();
+}
+
+bool frame_recorder_t::open_next_segment() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+    ++segment_index_;
+  }
+  auto const filename = fmt::format("{}/{}-{:06}{}", directory_, prefix_,
+                                    segment_index_, segment_extension);
+  file_ = std::fopen(filename.c_str(), "wb");
+  if (file_ == nullptr) {
+    spdlog::error("unable to create the frame log segment '{}'", filename);
+    return false;
+  }
+  // frames are small, so most records only cost a copy into this buffer
+  std::setvbuf(file_, nullptr, _IOFBF, 1'024 * 1'024);
+
+  frame_segment_header_t header{};
+  std::memcpy(header.magic, frame_log_magic, sizeof(header.magic));
+  header.version = frame_log_version;
+  header.header_size = sizeof(frame_segment_header_t);
+  std::fwrite(&header, sizeof(header), 1, file_);
+  segment_size_ = sizeof(header);
+
+  auto const now = nanoseconds_since_epoch();
+  for (std::size_t id = 0; id != stream_names_.size(); ++id) {
+    write_record(frame_record_type_e::stream_name,
+                 static_cast<std::uint32_t>(id), now, stream_names_[id]);
+  }
+  return true;
+}
+
+void frame_recorder_t::write_record(frame_record_type_e const type,
+                                    std::uint32_t const stream_id,
+                                    std::uint64_t const receive_time_ns,
+                                    std::string_view const payload) {
+  static constexpr char padding[8]{};
+
+  frame_record_header_t header{};
+  header.length = static_cast<std::uint32_t>(payload.size());
+  header.stream_id = stream_id;
+  header.receive_time_ns = receive_time_ns;
+  header.type = type;
+
+  auto const padded_length = padded_size(payload.size());
+  std::fwrite(&header, sizeof(header), 1, file_);
+  std::fwrite(payload.data(), 1, payload.size(), file_);
+  std::fwrite(padding, 1, padded_length - payload.size(), file_);
+  segment_size_ += sizeof(header) + padded_length;
+}
+
+std::uint32_t frame_recorder_t::add_stream(std::string_view const name) {
+  std::lock_guard<std::mutex> lock_g{mutex_};
+  auto const id = static_cast<std::uint32_t>(stream_names_.size());
+  stream_names_.emplace_back(name);
+  if (file_ != nullptr) {
+    write_record(frame_record_type_e::stream_name, id,
+                 nanoseconds_since_epoch(), name);
+  }
+  return id;
+}
+
+void frame_recorder_t::record(std::uint32_t const stream_id,
+                              std::string_view const frame) {
+  auto const receive_time_ns = nanoseconds_since_epoch();
+  std::lock_guard<std::mutex> lock_g{mutex_};
+  if (file_ == nullptr) {
+    return;
+  }
+  auto const record_size =
+      sizeof(frame_record_header_t) + padded_size(frame.size());
+  if (segment_size_ + record_size > max_segment_size_ &&
+      segment_size_ > sizeof(frame_segment_header_t)) {
+    if (!open_next_segment()) {
+      return;
+    }
+  }
+  write_record(frame_record_type_e::frame, stream_id, receive_time_ns, frame);
+  if (receive_time_ns - last_flush_time_ns_ >= 1'000'000'000) {
+    last_flush_time_ns_ = receive_time_ns;
+    std::fflush(file_);
+  }
+}
+
+void frame_recorder_t::flush() {
+  std::lock_guard<std::mutex> lock_g{mutex_};
+  if (file_ != nullptr) {
+    std::fflush(file_);
+  }
+}
+
+frame_replayer_t::frame_replayer_t(std::string directory, std::string prefix)
+    : directory_{std::move(directory)}, prefix_{std::move(prefix)} {}
+
+std::vector<std::string> frame_replayer_t::segment_filenames() const {
+  std::vector<std::string> filenames{};
+  for (auto &segment : list_segments(directory_, prefix_)) {
+    filenames.push_back(std::move(segment.second));
+  }
+  return filenames;
+}
+
+std::size_t frame_replayer_t::replay(double const speed,
+                                     stream_callback_t const &on_stream,
+                                     frame_callback_t const &on_frame) const {
+  using clock = std::chrono::steady_clock;
+
+  std::size_t frame_count{};
+  std::vector<std::string> stream_names{};
+  std::uint64_t first_receive_time{};
+  auto const started_at = clock::now();
+  // the records are read in place, the frames are views into the mapping
+  mapped_file_t mapped_segment{};
+
+  for (auto const &filename : segment_filenames()) {
+    if (!mapped_segment.open(filename)) {
+      continue;
+    }
+    std::string_view const segment(
+        reinterpret_cast<char const *>(mapped_segment.data()),
+        mapped_segment.size());
+
+    frame_segment_header_t segment_header{};
+    if (segment.size() < sizeof(segment_header)) {
+      spdlog::error("'{}' is not a frame log segment", filename);
+      continue;
+    }
+    std::memcpy(&segment_header, segment.data(), sizeof(segment_header));
+    if (std::memcmp(segment_header.magic, frame_log_magic,
+                    sizeof(frame_log_magic)) != 0 ||
+        segment_header.version != frame_log_version) {
+      spdlog::error("'{}' is not a frame log segment", filename);
+      continue;
+    }
+
+    std::size_t offset = segment_header.header_size;
+    while (offset + sizeof(frame_record_header_t) <= segment.size()) {
+      frame_record_header_t header{};
+      std::memcpy(&header, segment.data() + offset, sizeof(header));
+      offset += sizeof(header);
+      if (offset + header.length > segment.size()) {
+        // the recorder was stopped in the middle of this record
+        spdlog::error("'{}' ends with a truncated record", filename);
+        break;
+      }
+      std::string_view const payload(segment.data() + offset, header.length);
+      offset += padded_size(header.length);
+
+      if (header.type == frame_record_type_e::stream_name) {
+        // every segment repeats the names, but a later recording session
+        // numbers its streams from 0 again
+        if (header.stream_id >= stream_names.size()) {
+          stream_names.resize(header.stream_id + 1);
+        }
+        if (stream_names[header.stream_id] != payload) {
+          stream_names[header.stream_id] = std::string(payload);
+          on_stream(header.stream_id, payload);
+        }
+        continue;
+      } else if (header.type != frame_record_type_e::frame) {
+        continue;
+      }
+
+      if (frame_count == 0) {
+        first_receive_time = header.receive_time_ns;
+      } else if (speed > 0.0 && header.receive_time_ns > first_receive_time) {
+        auto const due = started_at + std::chrono::nanoseconds(
+                                          static_cast<std::int64_t>(
+                                              (header.receive_time_ns -
+                                               first_receive_time) /
+                                              speed));
+        std::this_thread::sleep_until(due);
+      }
+      on_frame(header.stream_id, header.receive_time_ns, payload);
+      ++frame_count;
+    }
+  }
+  return frame_count;
+}
+
+} // namespace binance
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace binance {
+
+/* Raw websocket frames are captured into segment files named
+ * `<directory>/<prefix>-000000.frames`, `-000001.frames`, ... Each segment
+ * starts with a frame_segment_header_t and is followed by records, each one
+ * a frame_record_header_t and `length` payload bytes padded to a multiple of
+ * 8, so every header in a mapped segment is naturally aligned.
+ *
+ * Integers are stored in the host's byte order. Every segment begins with
+ * the names of the streams recorded so far, so a segment can be replayed on
+ * its own.
+ */
+constexpr char frame_log_magic[8] = {'B', 'N', 'F', 'R', 'A', 'M', 'E', 'S'};
+constexpr std::uint32_t frame_log_version = 1;
+
+struct frame_segment_header_t {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t header_size; // sizeof(frame_segment_header_t)
+};
+
+enum class frame_record_type_e : std::uint16_t {
+  frame,      // a websocket frame received on `stream_id`
+  stream_name // the payload names `stream_id`, e.g. its URL path
+};
+
+struct frame_record_header_t {
+  std::uint32_t length; // of the payload, without the padding
+  std::uint32_t stream_id;
+  std::uint64_t receive_time_ns; // since the Unix epoch
+  frame_record_type_e type;
+  std::uint16_t reserved16;
+  std::uint32_t reserved32;
+};
+
+static_assert(sizeof(frame_segment_header_t) == 16);
+static_assert(sizeof(frame_record_header_t) == 24);
+
+/* Appends frames to the segment files, starting a new segment once the
+ * current one would grow past `max_segment_size`. Any thread may record;
+ * each record is one buffered write under a mutex, so the receiving thread
+ * pays for a copy, not for a system call.
+ */
+class frame_recorder_t {
+  std::string const directory_;
+  std::string const prefix_;
+  std::size_t const max_segment_size_;
+
+  std::mutex mutex_{};
+  std::FILE *file_{nullptr};
+  std::size_t segment_index_{};
+  std::size_t segment_size_{};
+  std::uint64_t last_flush_time_ns_{};
+  std::vector<std::string> stream_names_{};
+
+  bool open_next_segment();
+  void write_record(frame_record_type_e const type,
+                    std::uint32_t const stream_id,
+                    std::uint64_t const receive_time_ns,
+                    std::string_view const payload);
+
+public:
+  static constexpr std::size_t default_segment_size = 256 * 1'024 * 1'024;
+
+  frame_recorder_t(std::string directory, std::string prefix,
+                   std::size_t const max_segment_size = default_segment_size);
+  ~frame_recorder_t();
+  frame_recorder_t(frame_recorder_t const &) = delete;
+  frame_recorder_t &operator=(frame_recorder_t const &) = delete;
+
+  // creates the first segment after the ones already in the directory
+  bool open();
+  // returns the ID to record the frames of the stream `name` under
+  std::uint32_t add_stream(std::string_view const name);
+  // the frames reach the disk at least once a second
+  void record(std::uint32_t const stream_id, std::string_view const frame);
+  void flush();
+};
+
+/* Reads the segments written by frame_recorder_t back in order and hands
+ * each frame to a callback, either paced like they were received (scaled by
+ * `speed`) or as fast as possible.
+ */
+class frame_replayer_t {
+  std::string const directory_;
+  std::string const prefix_;
+
+public:
+  // called before the first frame of every stream, and again if a later
+  // recording session reuses the ID for another stream
+  using stream_callback_t =
+      std::function<void(std::uint32_t const stream_id,
+                         std::string_view const name)>;
+  using frame_callback_t =
+      std::function<void(std::uint32_t const stream_id,
+                         std::uint64_t const receive_time_ns,
+                         std::string_view const frame)>;
+
+  frame_replayer_t(std::string directory, std::string prefix);
+
+  // the segment files, oldest first
+  std::vector<std::string> segment_filenames() const;
+  // `speed` 1 replays at the recorded pace, 10 ten times faster and 0 as
+  // fast as possible. Returns the number of frames replayed.
+  std::size_t replay(double const speed, stream_callback_t const &on_stream,
+                     frame_callback_t const &on_frame) const;
+};
+
+} // namespace binance
@@ -0,0 +1,60 @@
+#include "http_router.hpp"
+#include "crypto.hpp"
+
+#include <stdexcept>
+
+namespace binance {
+
+rule_t::rule_t(std::initializer_list<http::verb> &&verbs, callback_t callback)
+    : num_verbs_{verbs.size()}, route_callback_{std::move(callback)} {
+  if (verbs.size() > 3) {
+    throw std::runtime_error{"maximum number of verbs is 5"};
+  }
+  for (int i = 0; i != verbs.size(); ++i) {
+    verbs_[i] = *(verbs.begin() + i);
+  }
+}
+
+void endpoint_t::add_endpoint(std::string const &route,
+                              std::initializer_list<http::verb> verbs,
+                              callback_t &&callback) {
+  if (route.empty() || route[0] != '/') {
+    throw std::runtime_error{"A valid route starts with a /"};
+  }
+  endpoints.emplace(route, rule_t{std::move(verbs), std::move(callback)});
+}
+
+std::optional<endpoint_t::rule_iterator>
+endpoint_t::get_rules(std::string const &target) {
+  auto iter = endpoints.find(target);
+  if (iter == endpoints.end()) {
+    return std::nullopt;
+  }
+  return iter;
+}
+
+std::optional<endpoint_t::rule_iterator>
+endpoint_t::get_rules(boost::string_view const &target) {
+  return get_rules(target.to_string());
+}
+
+namespace utilities {
+
+url_query_t split_url_query(boost::string_view const &query) {
+  url_query_t result{};
+  if (!query.empty()) {
+    auto queries = utilities::split_string_view(query, "&");
+    for (auto const &q : queries) {
+      auto split = utilities::split_string_view(q, "=");
+      if (split.size() < 2) {
+        continue;
+      }
+      result.emplace(split[0], split[1]);
+    }
+  }
+  return result;
+}
+
+} // namespace utilities
+
+} // namespace binance
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <boost/utility/string_view.hpp>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace binance {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+using string_request_t = http::request<http::string_body>;
+using url_query_t = std::map<boost::string_view, boost::string_view>;
+
+using callback_t =
+    std::function<void(string_request_t const &, url_query_t const &)>;
+
+struct rule_t {
+  std::size_t num_verbs_{};
+  std::array<http::verb, 3> verbs_{};
+  callback_t route_callback_;
+
+  rule_t(std::initializer_list<http::verb> &&verbs, callback_t callback);
+};
+
+// the routes of the web servers' sessions
+class endpoint_t {
+  std::map<std::string, rule_t> endpoints;
+  using rule_iterator = std::map<std::string, rule_t>::iterator;
+
+public:
+  void add_endpoint(std::string const &, std::initializer_list<http::verb>,
+                    callback_t &&);
+  std::optional<rule_iterator> get_rules(std::string const &target);
+  std::optional<rule_iterator> get_rules(boost::string_view const &target);
+};
+
+namespace utilities {
+
+// "a=1&b=2" -> {a: 1, b: 2}; the views point into `query`
+url_query_t split_url_query(boost::string_view const &query);
+
+} // namespace utilities
+
+} // namespace binance
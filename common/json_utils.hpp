@@ -1,5 +1,7 @@
 #pragma once
 
+#include "decimal.hpp"
+
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <optional>
@@ -34,6 +36,9 @@ read_object_json_file(std::string const &filename);
 std::optional<json::array_t> read_array_json_file(std::string const &filename);
 
 namespace utilities {
+std::optional<std::string> timet_to_string(std::size_t const t);
+std::optional<std::string> timet_to_string(std::string const &);
+
 template <typename T>
 T get_value(json::object_t const &data, std::string const &key) {
   if constexpr (std::is_same_v<T, json::number_integer_t>) {
@@ -42,6 +47,9 @@ T get_value(json::object_t const &data, std::string const &key) {
     return data.at(key).get<json::string_t>();
   } else if constexpr (std::is_same_v<T, json::number_float_t>) {
     return data.at(key).get<json::number_float_t>();
+  } else if constexpr (std::is_same_v<T, decimal_t>) {
+    // Binance sends every price and quantity as a string
+    return to_decimal(data.at(key).get_ref<json::string_t const &>());
   }
   return {};
 }
@@ -0,0 +1,97 @@
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace binance {
+
+namespace {
+
+constexpr std::uint64_t half_sub_bucket_count =
+    (std::uint64_t(1) << detail::latency_sub_bucket_bits) / 2;
+
+// the highest value that falls into the bucket at `index`
+std::uint64_t bucket_upper_bound(std::size_t const index) {
+  if (index < 2 * half_sub_bucket_count) {
+    return index;
+  }
+  auto const shift = index / half_sub_bucket_count - 1;
+  auto const sub_bucket = index % half_sub_bucket_count + half_sub_bucket_count;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+} // namespace
+
+void latency_histogram_t::record(std::uint64_t value) {
+  value = std::min(value, max_value);
+  counts_[detail::latency_bucket_index(value)].fetch_add(
+      1, std::memory_order_relaxed);
+  total_count_.fetch_add(1, std::memory_order_relaxed);
+  total_sum_.fetch_add(value, std::memory_order_relaxed);
+
+  auto current_max = max_.load(std::memory_order_relaxed);
+  while (value > current_max &&
+         !max_.compare_exchange_weak(current_max, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+void latency_histogram_t::reset() {
+  for (auto &count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+  total_count_.store(0, std::memory_order_relaxed);
+  total_sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t
+latency_histogram_t::value_at_percentile(double const percentile) const {
+  std::uint64_t total = 0;
+  for (auto const &count : counts_) {
+    total += count.load(std::memory_order_relaxed);
+  }
+  if (total == 0) {
+    return 0;
+  }
+  auto const wanted = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(
+             std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * total)));
+
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i != bucket_count; ++i) {
+    seen += counts_[i].load(std::memory_order_relaxed);
+    if (seen >= wanted) {
+      return std::min(bucket_upper_bound(i),
+                      max_.load(std::memory_order_relaxed));
+    }
+  }
+  return max_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+latency_histogram_t::count_at_or_below(std::uint64_t const value) const {
+  auto const last = detail::latency_bucket_index(std::min(value, max_value));
+  std::uint64_t count = 0;
+  for (std::size_t i = 0; i <= last; ++i) {
+    count += counts_[i].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+latency_summary_t latency_histogram_t::summary() const {
+  latency_summary_t summary{};
+  summary.count = total_count_.load(std::memory_order_relaxed);
+  summary.p50 = value_at_percentile(50.0);
+  summary.p99 = value_at_percentile(99.0);
+  summary.p999 = value_at_percentile(99.9);
+  summary.max = max_.load(std::memory_order_relaxed);
+  if (summary.count != 0) {
+    summary.mean = static_cast<double>(
+                       total_sum_.load(std::memory_order_relaxed)) /
+                   static_cast<double>(summary.count);
+  }
+  return summary;
+}
+
+} // namespace binance
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace binance {
+
+struct latency_summary_t {
+  std::uint64_t count{};
+  std::uint64_t p50{};
+  std::uint64_t p99{};
+  std::uint64_t p999{};
+  std::uint64_t max{};
+  double mean{};
+};
+
+namespace detail {
+// the log-linear bucketing of latency_histogram_t, see below
+constexpr unsigned latency_sub_bucket_bits = 7;
+
+constexpr std::size_t latency_bucket_index(std::uint64_t const value) {
+  constexpr std::uint64_t sub_bucket_count = std::uint64_t(1)
+                                             << latency_sub_bucket_bits;
+  if (value < sub_bucket_count) {
+    return static_cast<std::size_t>(value);
+  }
+  unsigned msb = 0;
+  for (auto v = value; v >>= 1;) {
+    ++msb;
+  }
+  auto const shift = msb - (latency_sub_bucket_bits - 1);
+  return static_cast<std::size_t>(shift * (sub_bucket_count / 2) +
+                                  (value >> shift));
+}
+} // namespace detail
+
+/* A fixed-size histogram of durations in nanoseconds, bucketed the way HDR
+ * histograms are: every power of two is split into 64 linear sub-buckets,
+ * so any value is reported within 1.6% of what was recorded, from 1ns up to
+ * `max_value` (~18 minutes) in 2,240 buckets.
+ *
+ * Recording is lock-free and can be done from any thread. `reset` and
+ * `summary` may run concurrently with recording; the summary then mixes
+ * values recorded before and after the reset, which is fine for monitoring.
+ */
+class latency_histogram_t {
+public:
+  static constexpr std::uint64_t max_value = (std::uint64_t(1) << 40) - 1;
+  static constexpr std::size_t bucket_count =
+      detail::latency_bucket_index(max_value) + 1;
+
+  void record(std::uint64_t value);
+  void reset();
+  // the highest value equivalent to the `percentile`th one recorded
+  std::uint64_t value_at_percentile(double const percentile) const;
+  latency_summary_t summary() const;
+  std::uint64_t count() const {
+    return total_count_.load(std::memory_order_relaxed);
+  }
+  std::uint64_t sum() const {
+    return total_sum_.load(std::memory_order_relaxed);
+  }
+  // the number of values recorded in the buckets up to the one holding
+  // `value`, i.e. also the values up to 1.6% above it
+  std::uint64_t count_at_or_below(std::uint64_t const value) const;
+
+private:
+  std::array<std::atomic<std::uint64_t>, bucket_count> counts_{};
+  std::atomic<std::uint64_t> total_count_{};
+  std::atomic<std::uint64_t> total_sum_{};
+  std::atomic<std::uint64_t> max_{};
+};
+
+// records the time elapsed since `started_at`
+inline void record_elapsed(latency_histogram_t &histogram,
+                           std::chrono::steady_clock::time_point const
+                               started_at) {
+  auto const elapsed = std::chrono::steady_clock::now() - started_at;
+  histogram.record(static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+} // namespace binance
@@ -0,0 +1,121 @@
+#include "mapped_file.hpp"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+namespace binance {
+
+mapped_file_t::~mapped_file_t() { close(); }
+
+#if defined(_WIN32)
+
+bool mapped_file_t::open(std::string const &filename) {
+  close();
+  auto const file =
+      ::CreateFileA(filename.c_str(), GENERIC_READ,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    spdlog::error("unable to open '{}': error {}", filename, ::GetLastError());
+    return false;
+  }
+  LARGE_INTEGER size{};
+  if (!::GetFileSizeEx(file, &size)) {
+    spdlog::error("unable to get the size of '{}': error {}", filename,
+                  ::GetLastError());
+    ::CloseHandle(file);
+    return false;
+  }
+  if (size.QuadPart == 0) {
+    ::CloseHandle(file);
+    return true;
+  }
+  mapping_ = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  ::CloseHandle(file);
+  if (mapping_ == nullptr) {
+    spdlog::error("unable to map '{}': error {}", filename, ::GetLastError());
+    return false;
+  }
+  auto const view = ::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    spdlog::error("unable to map '{}': error {}", filename, ::GetLastError());
+    ::CloseHandle(mapping_);
+    mapping_ = nullptr;
+    return false;
+  }
+  data_ = static_cast<std::uint8_t const *>(view);
+  size_ = static_cast<std::size_t>(size.QuadPart);
+  return true;
+}
+
+void mapped_file_t::close() {
+  if (data_ != nullptr) {
+    ::UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    ::CloseHandle(mapping_);
+  }
+  data_ = nullptr;
+  mapping_ = nullptr;
+  size_ = 0;
+}
+
+#else
+
+bool mapped_file_t::open(std::string const &filename) {
+  close();
+  auto const fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    spdlog::error("unable to open '{}': {}", filename, std::strerror(errno));
+    return false;
+  }
+  struct stat status {};
+  if (::fstat(fd, &status) != 0) {
+    spdlog::error("unable to get the size of '{}': {}", filename,
+                  std::strerror(errno));
+    ::close(fd);
+    return false;
+  }
+  if (status.st_size == 0) {
+    ::close(fd);
+    return true;
+  }
+  auto const size = static_cast<std::size_t>(status.st_size);
+  auto const address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    spdlog::error("unable to map '{}': {}", filename, std::strerror(errno));
+    return false;
+  }
+  data_ = static_cast<std::uint8_t const *>(address);
+  size_ = size;
+  return true;
+}
+
+void mapped_file_t::close() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<std::uint8_t *>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif
+
+} // namespace binance
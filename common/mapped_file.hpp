@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace binance {
+
+/* A read-only memory mapping of a whole file, so that readers only touch
+ * the pages they look at. The mapping is a snapshot of the file's size at
+ * open(): what is appended later needs a new mapping.
+ */
+class mapped_file_t {
+  std::uint8_t const *data_{nullptr};
+  std::size_t size_{};
+#if defined(_WIN32)
+  void *mapping_{nullptr};
+#endif
+
+public:
+  mapped_file_t() = default;
+  ~mapped_file_t();
+  mapped_file_t(mapped_file_t const &) = delete;
+  mapped_file_t &operator=(mapped_file_t const &) = delete;
+
+  // returns false, after logging why, if the file can't be mapped. An empty
+  // file is mapped to nothing
+  bool open(std::string const &filename);
+  void close();
+
+  std::uint8_t const *data() const { return data_; }
+  std::size_t size() const { return size_; }
+};
+
+} // namespace binance
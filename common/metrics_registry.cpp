@@ -0,0 +1,180 @@
+#include "metrics_registry.hpp"
+
+#include <iterator>
+#include <spdlog/fmt/fmt.h>
+#include <stdexcept>
+
+namespace binance {
+
+namespace {
+
+char const *type_to_string(metrics_registry_t::metric_type_e const type) {
+  switch (type) {
+  case metrics_registry_t::metric_type_e::counter:
+    return "counter";
+  case metrics_registry_t::metric_type_e::gauge:
+    return "gauge";
+  case metrics_registry_t::metric_type_e::histogram:
+    return "histogram";
+  }
+  return "untyped";
+}
+
+// backslashes, double quotes and newlines must be escaped in label values
+std::string render_labels(metric_labels_t const &labels) {
+  std::string result{};
+  for (auto const &[name, value] : labels) {
+    if (!result.empty()) {
+      result += ',';
+    }
+    result += name;
+    result += "=\"";
+    for (auto const ch : value) {
+      if (ch == '\\' || ch == '"') {
+        result += '\\';
+        result += ch;
+      } else if (ch == '\n') {
+        result += "\\n";
+      } else {
+        result += ch;
+      }
+    }
+    result += '"';
+  }
+  return result;
+}
+
+// name{labels} value, or name value without labels
+template <typename Value>
+void append_sample(fmt::memory_buffer &out, std::string const &name,
+                   std::string const &labels, Value const value) {
+  if (labels.empty()) {
+    fmt::format_to(std::back_inserter(out), "{} {}\n", name, value);
+  } else {
+    fmt::format_to(std::back_inserter(out), "{}{{{}}} {}\n", name, labels,
+                   value);
+  }
+}
+
+void append_histogram(fmt::memory_buffer &out, std::string const &name,
+                      std::string const &labels,
+                      std::vector<double> const &bounds,
+                      latency_histogram_t const &histogram) {
+  auto const bucket_name = name + "_bucket";
+  auto const separator = labels.empty() ? "" : ",";
+  for (auto const bound : bounds) {
+    auto const count = histogram.count_at_or_below(
+        static_cast<std::uint64_t>(bound * 1'000'000'000.0));
+    append_sample(out, bucket_name,
+                  fmt::format("{}{}le=\"{}\"", labels, separator, bound),
+                  count);
+  }
+  auto const count = histogram.count();
+  append_sample(out, bucket_name,
+                fmt::format("{}{}le=\"+Inf\"", labels, separator), count);
+  append_sample(out, name + "_sum", labels,
+                static_cast<double>(histogram.sum()) / 1'000'000'000.0);
+  append_sample(out, name + "_count", labels, count);
+}
+
+} // namespace
+
+std::vector<double> metrics_registry_t::default_latency_bounds() {
+  return {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+          0.1,    0.25,  0.5,    1.0,   2.5,  5.0,   10.0};
+}
+
+metrics_registry_t::series_t &
+metrics_registry_t::get_series(std::string const &name,
+                               std::string const &help,
+                               metric_type_e const type,
+                               metric_labels_t const &labels) {
+  auto &family = families_[name];
+  if (family.series.empty()) {
+    family.help = help;
+    family.type = type;
+  } else if (family.type != type) {
+    throw std::runtime_error{"metric '" + name +
+                             "' was registered with another type"};
+  }
+  auto rendered_labels = render_labels(labels);
+  for (auto &series : family.series) {
+    if (series.labels == rendered_labels) {
+      return series;
+    }
+  }
+  auto &series = family.series.emplace_back();
+  series.labels = std::move(rendered_labels);
+  return series;
+}
+
+metric_counter_t &metrics_registry_t::counter(std::string const &name,
+                                              std::string const &help,
+                                              metric_labels_t const &labels) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto &series = get_series(name, help, metric_type_e::counter, labels);
+  if (!series.counter) {
+    series.counter = std::make_unique<metric_counter_t>();
+  }
+  return *series.counter;
+}
+
+metric_gauge_t &metrics_registry_t::gauge(std::string const &name,
+                                          std::string const &help,
+                                          metric_labels_t const &labels) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto &series = get_series(name, help, metric_type_e::gauge, labels);
+  if (!series.gauge) {
+    series.gauge = std::make_unique<metric_gauge_t>();
+  }
+  return *series.gauge;
+}
+
+void metrics_registry_t::gauge(std::string const &name,
+                               std::string const &help,
+                               std::function<double()> value,
+                               metric_labels_t const &labels) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto &series = get_series(name, help, metric_type_e::gauge, labels);
+  series.callback = std::move(value);
+}
+
+latency_histogram_t &
+metrics_registry_t::histogram(std::string const &name, std::string const &help,
+                              metric_labels_t const &labels,
+                              std::vector<double> bucket_bounds) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto &series = get_series(name, help, metric_type_e::histogram, labels);
+  if (!series.histogram) {
+    series.histogram = std::make_unique<latency_histogram_t>();
+  }
+  auto &family = families_[name];
+  if (family.bucket_bounds.empty()) {
+    family.bucket_bounds = std::move(bucket_bounds);
+  }
+  return *series.histogram;
+}
+
+std::string metrics_registry_t::serialize() const {
+  fmt::memory_buffer out{};
+  std::lock_guard<std::mutex> lock{mutex_};
+  for (auto const &[name, family] : families_) {
+    fmt::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n",
+                   name, family.help, name, type_to_string(family.type));
+    for (auto const &series : family.series) {
+      if (series.counter) {
+        append_sample(out, name, series.labels, series.counter->value());
+      } else if (series.gauge) {
+        append_sample(out, name, series.labels, series.gauge->value());
+      } else if (series.callback) {
+        append_sample(out, name, series.labels, series.callback());
+      } else if (series.histogram) {
+        append_histogram(out, name, series.labels, family.bucket_bounds,
+                         *series.histogram);
+      }
+    }
+  }
+  return fmt::to_string(out);
+}
+
+} // namespace binance
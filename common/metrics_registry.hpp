@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "latency_histogram.hpp"
+
+namespace binance {
+
+using metric_labels_t = std::vector<std::pair<std::string, std::string>>;
+
+class metric_counter_t {
+  std::atomic<std::uint64_t> value_{};
+
+public:
+  void increment(std::uint64_t const n = 1) {
+    value_.fetch_add(n, std::memory_order_relaxed);
+  }
+  std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+};
+
+class metric_gauge_t {
+  std::atomic<std::int64_t> value_{};
+
+public:
+  void set(std::int64_t const value) {
+    value_.store(value, std::memory_order_relaxed);
+  }
+  void add(std::int64_t const n) {
+    value_.fetch_add(n, std::memory_order_relaxed);
+  }
+  std::int64_t value() const { return value_.load(std::memory_order_relaxed); }
+};
+
+/* Named metrics, rendered in the Prometheus text format for scraping.
+ *
+ * Registering a metric takes a lock and returns a reference that stays
+ * valid for the life of the registry, so hot paths look their metrics up
+ * once and only do relaxed atomic operations afterwards. Registering the
+ * same name and labels again returns the same metric.
+ *
+ * Histograms record durations in nanoseconds into a latency_histogram_t and
+ * are exposed in seconds, with the `le` bounds given when the name is first
+ * registered.
+ */
+class metrics_registry_t {
+public:
+  enum class metric_type_e : std::uint8_t { counter, gauge, histogram };
+
+private:
+  struct series_t {
+    std::string labels{}; // rendered, e.g. account="main"
+    std::unique_ptr<metric_counter_t> counter{};
+    std::unique_ptr<metric_gauge_t> gauge{};
+    std::unique_ptr<latency_histogram_t> histogram{};
+    // gauges whose value is only computed when scraped
+    std::function<double()> callback{};
+  };
+  struct family_t {
+    std::string help{};
+    metric_type_e type{metric_type_e::counter};
+    std::vector<double> bucket_bounds{}; // histograms only, in seconds
+    std::vector<series_t> series{};
+  };
+
+  mutable std::mutex mutex_{};
+  std::map<std::string, family_t> families_{};
+
+  series_t &get_series(std::string const &name, std::string const &help,
+                       metric_type_e const type, metric_labels_t const &labels);
+
+public:
+  static std::vector<double> default_latency_bounds();
+
+  metric_counter_t &counter(std::string const &name, std::string const &help,
+                            metric_labels_t const &labels = {});
+  metric_gauge_t &gauge(std::string const &name, std::string const &help,
+                        metric_labels_t const &labels = {});
+  // `value` is called on every scrape, under the registry's lock
+  void gauge(std::string const &name, std::string const &help,
+             std::function<double()> value,
+             metric_labels_t const &labels = {});
+  latency_histogram_t &
+  histogram(std::string const &name, std::string const &help,
+            metric_labels_t const &labels = {},
+            std::vector<double> bucket_bounds = default_latency_bounds());
+
+  // the text exposition format, version 0.0.4
+  std::string serialize() const;
+};
+
+} // namespace binance
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace binance {
+
+// tells the CPU we're in a spin loop, so the sibling hyper-thread gets to run
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+/* Helpers for a single-writer sequence lock over data that lives somewhere
+ * else (e.g. in parallel arrays). The version is even when the data is
+ * stable and odd while the writer is modifying it; a reader retries if the
+ * version was odd or changed while it was copying the data.
+ *
+ * The protected data itself must be read and written through relaxed
+ * atomics, otherwise the reader's racy copy is undefined behaviour.
+ */
+namespace seqlock {
+
+inline void write_begin(std::atomic<std::uint64_t> &version) noexcept {
+  auto const current = version.load(std::memory_order_relaxed);
+  version.store(current + 1, std::memory_order_relaxed);
+  // keeps the data stores below from being reordered before the odd version
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void write_end(std::atomic<std::uint64_t> &version) noexcept {
+  auto const current = version.load(std::memory_order_relaxed);
+  version.store(current + 1, std::memory_order_release);
+}
+
+// spins until no write is in progress and returns the (even) version
+inline std::uint64_t
+read_begin(std::atomic<std::uint64_t> const &version) noexcept {
+  auto current = version.load(std::memory_order_acquire);
+  while (current & 1) {
+    cpu_relax();
+    current = version.load(std::memory_order_acquire);
+  }
+  return current;
+}
+
+// true if the data copied since read_begin() may be torn
+inline bool read_retry(std::atomic<std::uint64_t> const &version,
+                       std::uint64_t const started_at) noexcept {
+  // keeps the data loads above from being reordered after the version check
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return version.load(std::memory_order_relaxed) != started_at;
+}
+
+} // namespace seqlock
+
+/* A trivially copyable value guarded by its own sequence lock. The value is
+ * stored as an array of atomic words so concurrent copies are well-defined.
+ * Only one thread may call store(); any number of threads may call load()
+ * and will never block the writer.
+ */
+template <typename T> class seqlocked_t {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "seqlocked_t requires a trivially copyable type");
+
+  static constexpr std::size_t word_count =
+      (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+  std::atomic<std::uint64_t> version_{};
+  std::array<std::atomic<std::uint64_t>, word_count> words_{};
+
+public:
+  seqlocked_t() = default;
+  explicit seqlocked_t(T const &value) { store(value); }
+  seqlocked_t(seqlocked_t const &) = delete;
+  seqlocked_t &operator=(seqlocked_t const &) = delete;
+
+  void store(T const &value) noexcept {
+    std::uint64_t buffer[word_count]{};
+    std::memcpy(buffer, &value, sizeof(T));
+
+    seqlock::write_begin(version_);
+    for (std::size_t i = 0; i != word_count; ++i) {
+      words_[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    seqlock::write_end(version_);
+  }
+
+  T load() const noexcept {
+    std::uint64_t buffer[word_count]{};
+    std::uint64_t version{};
+    do {
+      version = seqlock::read_begin(version_);
+      for (std::size_t i = 0; i != word_count; ++i) {
+        buffer[i] = words_[i].load(std::memory_order_relaxed);
+      }
+    } while (seqlock::read_retry(version_, version));
+
+    T value;
+    std::memcpy(&value, buffer, sizeof(T));
+    return value;
+  }
+
+  // the number of completed store() calls
+  std::uint64_t generation() const noexcept {
+    return version_.load(std::memory_order_acquire) / 2;
+  }
+};
+
+} // namespace binance
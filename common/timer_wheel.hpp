@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace binance {
+
+// refers to a timer of a timer_wheel_t, stale once it expired or was
+// cancelled
+struct timer_id_t {
+  std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+  std::uint32_t generation{};
+};
+
+/* A hierarchical timing wheel, as in Varghese & Lauck and the Linux kernel,
+ * counting time in ticks whose length is up to the caller.
+ *
+ * Level 0 has a slot for each of the next 256 ticks, level 1 for each of
+ * the next 256 blocks of 256 ticks, and so on over 4 levels (2^32 ticks);
+ * later timers wait in an overflow list. A timer is put in the lowest level
+ * whose slot holds nothing but the future, and moved down a level each
+ * time the wheel below it wraps around, so it is touched at most once per
+ * level before it expires. Scheduling and cancelling are O(1): timers are
+ * nodes of intrusive doubly-linked lists in a recycled pool.
+ *
+ * Not thread-safe.
+ */
+template <typename T> class timer_wheel_t {
+  static constexpr unsigned slot_bits = 8;
+  static constexpr std::size_t slots_per_level = std::size_t(1) << slot_bits;
+  static constexpr std::size_t level_count = 4;
+  static constexpr std::uint32_t npos =
+      std::numeric_limits<std::uint32_t>::max();
+  // the list of the timers beyond the last level
+  static constexpr std::size_t overflow_list = level_count * slots_per_level;
+
+  struct node_t {
+    T payload{};
+    std::uint64_t expires_at{};
+    std::uint32_t prev{npos};
+    std::uint32_t next{npos};
+    std::uint32_t list{npos}; // npos when free
+    std::uint32_t generation{};
+  };
+
+  std::vector<node_t> nodes_{};
+  std::uint32_t free_head_{npos};
+  std::array<std::uint32_t, overflow_list + 1> heads_{};
+  std::uint64_t now_{};
+  std::size_t size_{};
+
+  void link(std::uint32_t const index) {
+    auto &node = nodes_[index];
+    auto list = overflow_list;
+    for (std::size_t level = 0; level != level_count; ++level) {
+      auto const shift = slot_bits * (level + 1);
+      if ((node.expires_at >> shift) == (now_ >> shift)) {
+        list = level * slots_per_level +
+               ((node.expires_at >> (slot_bits * level)) &
+                (slots_per_level - 1));
+        break;
+      }
+    }
+    node.list = static_cast<std::uint32_t>(list);
+    node.prev = npos;
+    node.next = heads_[list];
+    if (node.next != npos) {
+      nodes_[node.next].prev = index;
+    }
+    heads_[list] = index;
+  }
+
+  void unlink(std::uint32_t const index) {
+    auto &node = nodes_[index];
+    if (node.prev != npos) {
+      nodes_[node.prev].next = node.next;
+    } else {
+      heads_[node.list] = node.next;
+    }
+    if (node.next != npos) {
+      nodes_[node.next].prev = node.prev;
+    }
+  }
+
+  void free(std::uint32_t const index) {
+    auto &node = nodes_[index];
+    node.payload = T{};
+    node.list = npos;
+    ++node.generation;
+    node.next = free_head_;
+    free_head_ = index;
+    --size_;
+  }
+
+  // moves the timers of a list to the levels below, now that they're closer
+  void relink_all(std::size_t const list) {
+    auto index = std::exchange(heads_[list], npos);
+    while (index != npos) {
+      auto const next = nodes_[index].next;
+      link(index);
+      index = next;
+    }
+  }
+
+  void cascade(std::size_t const level) {
+    if (level == level_count) {
+      relink_all(overflow_list);
+      return;
+    }
+    auto const slot = (now_ >> (slot_bits * level)) & (slots_per_level - 1);
+    if (slot == 0) {
+      cascade(level + 1);
+    }
+    relink_all(level * slots_per_level + slot);
+  }
+
+public:
+  timer_wheel_t() { heads_.fill(npos); }
+
+  std::uint64_t now() const { return now_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // expires `delay` ticks from now, at least 1
+  timer_id_t schedule(std::uint64_t const delay, T payload) {
+    std::uint32_t index{};
+    if (free_head_ != npos) {
+      index = free_head_;
+      free_head_ = nodes_[index].next;
+    } else {
+      index = static_cast<std::uint32_t>(nodes_.size());
+      nodes_.emplace_back();
+    }
+    auto &node = nodes_[index];
+    node.payload = std::move(payload);
+    node.expires_at = now_ + (delay == 0 ? 1 : delay);
+    link(index);
+    ++size_;
+    return {index, node.generation};
+  }
+
+  // false if the timer already expired or was cancelled
+  bool cancel(timer_id_t const id) {
+    if (id.index >= nodes_.size()) {
+      return false;
+    }
+    auto const &node = nodes_[id.index];
+    if (node.generation != id.generation || node.list == npos) {
+      return false;
+    }
+    unlink(id.index);
+    free(id.index);
+    return true;
+  }
+
+  // moves the wheel forward to `now`, calling `on_expiry(T &&)` for every
+  // timer that expired, in the order of their expiry ticks. `on_expiry` may
+  // schedule new timers. An empty wheel jumps there directly
+  template <typename OnExpiry>
+  void advance(std::uint64_t const now, OnExpiry &&on_expiry) {
+    while (now_ < now && size_ != 0) {
+      ++now_;
+      auto const slot = now_ & (slots_per_level - 1);
+      if (slot == 0) {
+        cascade(1);
+      }
+      auto index = std::exchange(heads_[slot], npos);
+      while (index != npos) {
+        auto const next = nodes_[index].next;
+        auto payload = std::move(nodes_[index].payload);
+        free(index);
+        on_expiry(std::move(payload));
+        index = next;
+      }
+    }
+    if (now_ < now) {
+      now_ = now;
+    }
+  }
+};
+
+} // namespace binance